@@ -0,0 +1,132 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include "xUnit++/RunOptions.h"
+#include "xUnit++/StringPool.h"
+#include "xUnit++/TestManifest.h"
+#include "xUnit++/TestTable.h"
+#include "xUnit++/xUnitTest.h"
+
+// Selects and sorts a large synthetic registry twice: once as the runner used to, through every test's
+// details, and once through a TestTable's columns. Both have to choose the same tests in the same order.
+//
+// usage: Benchmarks [tests]
+
+namespace
+{
+    const size_t SuiteCount = 1000;
+
+    template<typename TFn>
+    double Milliseconds(TFn &&fn)
+    {
+        auto start = std::chrono::steady_clock::now();
+        fn();
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    void Report(const std::string &what, double details, double table)
+    {
+        std::cout << what << ": " << details << " ms through details, " << table << " ms through the table ("
+            << (table > 0 ? details / table : 0) << "x)\n";
+    }
+}
+
+int main(int argc, char **argv)
+{
+    size_t count = argc > 1 ? (size_t)std::strtoul(argv[1], nullptr, 10) : 1000000;
+
+    std::vector<std::shared_ptr<xUnitpp::xUnitTest>> tests;
+    xUnitpp::TestTable table;
+
+    {
+        std::vector<std::shared_ptr<xUnitpp::TestEventRecorder>> recorders;
+
+        xUnitpp::AttributeCollection skip;
+        skip.insert(std::make_pair("Skip", "Benchmark"));
+        skip.sort();
+        skip = xUnitpp::AttributeCollection::Shared(std::move(skip));
+
+        tests.reserve(count);
+
+        auto built = Milliseconds([&]()
+            {
+                for (size_t i = 0; i != count; ++i)
+                {
+                    const auto &suite = xUnitpp::StringPool::Intern("Suite " + std::to_string((i * 7919) % SuiteCount));
+
+                    tests.push_back(std::make_shared<xUnitpp::xUnitTest>([]() {}, "Test " + std::to_string(i), 0, "", suite,
+                        i % 50 == 0 ? xUnitpp::AttributeCollection(skip) : xUnitpp::AttributeCollection(), xUnitpp::Time::Duration(-1),
+                        "Benchmark.cpp", (int)i, recorders));
+                }
+            });
+
+        auto indexed = Milliseconds([&]()
+            {
+                for (const auto &test : tests)
+                {
+                    const auto &details = test->TestDetails();
+                    table.Add(details.Id, details.StableId, details.Suite, -1, details.Attributes.Skipped().first);
+                }
+            });
+
+        std::cout << count << " tests in " << SuiteCount << " suites: built in " << built << " ms, tabled in " << indexed << " ms\n";
+    }
+
+    xUnitpp::RunOptions options;
+    options.shardIndex = 3;
+    options.shardCount = 8;
+
+    // filter: one shard of the tests that aren't skipped
+    std::vector<std::shared_ptr<xUnitpp::xUnitTest>> filtered;
+    auto filterDetails = Milliseconds([&]()
+        {
+            for (const auto &test : tests)
+            {
+                const auto &details = test->TestDetails();
+                if (details.GetStableId() % options.shardCount == options.shardIndex && !details.Attributes.Skipped().first)
+                {
+                    filtered.push_back(test);
+                }
+            }
+        });
+
+    std::vector<uint32_t> rows;
+    auto filterTable = Milliseconds([&]()
+        {
+            rows = table.Select(options);
+            rows.erase(std::remove_if(rows.begin(), rows.end(), [&](uint32_t row) { return table.skipped[row] != 0; }), rows.end());
+        });
+
+    Report("filter", filterDetails, filterTable);
+
+    // sort: by suite, then stable id
+    auto sortDetails = Milliseconds([&]()
+        {
+            std::sort(filtered.begin(), filtered.end(),
+                [](const std::shared_ptr<xUnitpp::xUnitTest> &lhs, const std::shared_ptr<xUnitpp::xUnitTest> &rhs)
+                {
+                    const auto &l = lhs->TestDetails();
+                    const auto &r = rhs->TestDetails();
+                    return l.Suite != r.Suite ? l.Suite < r.Suite : l.StableId < r.StableId;
+                });
+        });
+
+    auto sortTable = Milliseconds([&]() { table.SortBySuite(rows); });
+
+    Report("sort", sortDetails, sortTable);
+
+    if (rows.size() != filtered.size() ||
+        !std::equal(rows.begin(), rows.end(), filtered.begin(),
+            [&](uint32_t row, const std::shared_ptr<xUnitpp::xUnitTest> &test) { return table.ids[row] == test->TestDetails().Id; }))
+    {
+        std::cerr << "The table chose different tests than the details did.\n";
+        return 1;
+    }
+
+    std::cout << rows.size() << " tests selected\n";
+    return 0;
+}
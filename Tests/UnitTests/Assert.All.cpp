@@ -0,0 +1,93 @@
+#include <atomic>
+#include <list>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "xUnit++/xUnit++.h"
+
+using xUnitpp::xUnitAssert;
+
+SUITE("AssertAll")
+{
+
+FACT("AllSuccess")
+{
+    std::vector<int> v(100, 1);
+
+    Assert.All(v, [](int value) { return value == 1; });
+}
+
+FACT("AllForEmptySequence")
+{
+    std::list<int> l;
+
+    Assert.All(l, [](int) { return false; });
+}
+
+FACT("AllReportsCountAndFirstFailures")
+{
+    std::vector<int> v;
+
+    for (int i = 0; i != 100; ++i)
+    {
+        v.push_back(i);
+    }
+
+    auto assert = Assert.Throws<xUnitAssert>([&]() { Assert.All(v, [](int value) { return value % 10 != 3; }); });
+
+    Assert.Equal("10 of 100 elements do not match. First at: [3] 3, [13] 13, [23] 23, [33] 33, [43] 43, [53] 53, [63] 63, [73] 73, ...", assert.CustomMessage());
+}
+
+FACT("AllEvaluatesEveryElement")
+{
+    std::list<int> l(50, 0);
+    int calls = 0;
+
+    Assert.Throws<xUnitAssert>([&]() { Assert.All(l, [&](int) { ++calls; return false; }); });
+
+    Assert.Equal(50, calls);
+}
+
+FACT("AllInParallelSuccess")
+{
+    std::vector<int> v(100000, 1);
+    std::atomic<int> calls(0);
+
+    Assert.All(xUnitpp::Parallel(v, 4), [&](int value) { ++calls; return value == 1; });
+
+    Assert.Equal(100000, calls.load());
+}
+
+FACT("AllInParallelReportsFailuresInOrder")
+{
+    std::vector<int> v(100000, 0);
+
+    for (size_t i = 0; i < v.size(); i += 9999)
+    {
+        v[i] = 1;
+    }
+
+    auto assert = Assert.Throws<xUnitAssert>([&]() { Assert.All(xUnitpp::Parallel(v, 4), [](int value) { return value == 0; }); });
+
+    Assert.Equal("11 of 100000 elements do not match. First at: [0] 1, [9999] 1, [19998] 1, [29997] 1, [39996] 1, [49995] 1, [59994] 1, [69993] 1, ...", assert.CustomMessage());
+}
+
+FACT("AllInParallelPropagatesExceptions")
+{
+    std::vector<int> v(100000, 0);
+
+    Assert.Throws<std::runtime_error>([&]() { Assert.All(xUnitpp::Parallel(v, 4), [](int) -> bool { throw std::runtime_error("predicate"); }); });
+}
+
+FACT("AllAppendsUserMessage")
+{
+    static const std::string msg = "custom message";
+
+    std::vector<int> v(1, 0);
+
+    auto assert = Assert.Throws<xUnitAssert>([&]() { Assert.All(v, [](int) { return false; }) << msg; });
+
+    Assert.Contains(assert.UserMessage(), msg.c_str());
+}
+
+}
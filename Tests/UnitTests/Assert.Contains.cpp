@@ -1,4 +1,9 @@
+#include <algorithm>
+#include <functional>
+#include <map>
+#include <set>
 #include <string>
+#include <unordered_set>
 #include <vector>
 #include "xUnit++/xUnit++.h"
 
@@ -57,4 +62,100 @@ FACT("ContainsForStringAppendsUserMessage")
     Assert.NotEqual(std::string::npos, what.find(msg));
 }
 
+FACT("ContainsForAssociativeContainers")
+{
+    std::set<int> s;
+    std::map<int, std::string> m;
+    std::unordered_set<std::string> u;
+
+    for (int i = 0; i != 1000; ++i)
+    {
+        s.insert(i);
+        m[i] = std::to_string(i);
+        u.insert(std::to_string(i));
+    }
+
+    Assert.Contains(s, 500);
+    Assert.Contains(m, 500);
+    Assert.Contains(u, "500");
+
+    Assert.Throws<xUnitAssert>([&]() { Assert.Contains(s, 1000); });
+    Assert.Throws<xUnitAssert>([&]() { Assert.Contains(m, -1); });
+    Assert.Throws<xUnitAssert>([&]() { Assert.Contains(u, "abc"); });
+}
+
+struct LookupOnly
+{
+    LookupOnly()
+        : lookups(0)
+    {
+    }
+
+    std::vector<int>::const_iterator begin() const
+    {
+        return values.begin();
+    }
+
+    std::vector<int>::const_iterator end() const
+    {
+        return values.end();
+    }
+
+    std::vector<int>::const_iterator find(int value) const
+    {
+        ++lookups;
+        return std::find(values.begin(), values.end(), value);
+    }
+
+    std::vector<int> values;
+    mutable int lookups;
+};
+
+FACT("ContainsUsesMemberFind")
+{
+    LookupOnly container;
+    container.values.push_back(1);
+
+    Assert.Contains(container, 1);
+
+    Assert.Equal(1, container.lookups);
+}
+
+FACT("ContainsForSortedRange")
+{
+    std::vector<int> v;
+
+    for (int i = 0; i != 1000; i += 2)
+    {
+        v.push_back(i);
+    }
+
+    Assert.Contains(xUnitpp::Sorted(v), 500);
+    Assert.Throws<xUnitAssert>([&]() { Assert.Contains(xUnitpp::Sorted(v), 501); });
+}
+
+FACT("ContainsForSortedRangeWithComparer")
+{
+    std::vector<int> v;
+
+    for (int i = 1000; i != 0; i -= 2)
+    {
+        v.push_back(i);
+    }
+
+    Assert.Contains(xUnitpp::Sorted(v, std::greater<int>()), 500);
+    Assert.Throws<xUnitAssert>([&]() { Assert.Contains(xUnitpp::Sorted(v, std::greater<int>()), 501); });
+}
+
+FACT("ContainsForLargeString")
+{
+    std::string actual(100000, 'a');
+    actual.replace(90000, 5, "aaaab");
+
+    Assert.Contains(actual, "aaaab");
+    Assert.Contains(actual, std::string(50000, 'a'));
+    Assert.Throws<xUnitAssert>([&]() { Assert.Contains(actual, "aaaac"); });
+    Assert.Throws<xUnitAssert>([&]() { Assert.Contains(actual, "abab"); });
+}
+
 }
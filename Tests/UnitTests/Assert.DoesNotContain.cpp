@@ -1,3 +1,4 @@
+#include <set>
 #include <string>
 #include <vector>
 #include "xUnit++/xUnit++.h"
@@ -55,4 +56,36 @@ FACT("DoesNotContainForStringAppendsUserMessage")
     Assert.Contains(assert.UserMessage(), msg.c_str());
 }
 
+FACT("DoesNotContainForAssociativeContainers")
+{
+    std::multiset<int> s;
+    s.insert(1);
+    s.insert(1);
+    s.insert(3);
+
+    Assert.DoesNotContain(s, 2);
+    Assert.Throws<xUnitAssert>([&]() { Assert.DoesNotContain(s, 1); });
+}
+
+FACT("DoesNotContainForSortedRange")
+{
+    std::vector<int> v;
+    v.push_back(1);
+    v.push_back(3);
+    v.push_back(5);
+
+    Assert.DoesNotContain(xUnitpp::Sorted(v), 4);
+    Assert.Throws<xUnitAssert>([&]() { Assert.DoesNotContain(xUnitpp::Sorted(v), 5); });
+}
+
+FACT("DoesNotContainForLargeStringReportsPosition")
+{
+    std::string actual(10000, 'a');
+    actual.replace(7000, 4, "abcd");
+
+    auto assert = Assert.Throws<xUnitAssert>([&]() { Assert.DoesNotContain(actual, "abcd"); });
+
+    Assert.Equal("Found: \"abcd\" at position 7000.", assert.CustomMessage());
+}
+
 }
\ No newline at end of file
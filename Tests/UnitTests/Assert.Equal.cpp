@@ -1,3 +1,5 @@
+#include <string>
+#include <vector>
 #include "xUnit++/xUnit++.h"
 
 using xUnitpp::xUnitAssert;
@@ -169,4 +171,78 @@ FACT("const char * should be equal to char *")
     Check.Equal("hi", actual);
 }
 
+FACT("SequenceEqual failure shows a diff of the sequences")
+{
+    std::vector<int> v0;
+    std::vector<int> v1;
+
+    for (int i = 0; i != 100; ++i)
+    {
+        v0.push_back(i);
+
+        if (i != 50)
+        {
+            v1.push_back(i);
+        }
+    }
+
+    v1.push_back(100);
+
+    auto assert = Assert.Throws<xUnitAssert>([&]() { Assert.Equal(v0.begin(), v0.end(), v1.begin(), v1.end()); });
+
+    Assert.Contains(assert.CustomMessage(), "at location 50");
+    Assert.Contains(assert.CustomMessage(), "\n     - 50");
+    Assert.Contains(assert.CustomMessage(), "\n     + 100");
+    Assert.DoesNotContain(assert.CustomMessage(), "- 51");
+}
+
+FACT("SequenceEqual failure only prints values around the first mismatch")
+{
+    std::vector<int> v0(100000, 0);
+    std::vector<int> v1(100000, 0);
+    v1[50000] = 1;
+
+    auto assert = Assert.Throws<xUnitAssert>([&]() { Assert.Equal(v0.begin(), v0.end(), v1.begin(), v1.end()); });
+
+    Assert.Contains(assert.Expected(), "[ ..., ");
+    Assert.Contains(assert.Expected(), ", ... ]");
+    Assert.InRange(assert.Actual().size(), (size_t)1, (size_t)200);
+}
+
+FACT("EqualForStrings reports the position of the first difference")
+{
+    auto assert = Assert.Throws<xUnitAssert>([]() { Assert.Equal("abcdef", "abcxef"); });
+
+    Assert.Contains(assert.CustomMessage(), "position 3");
+    Assert.Equal("abcdef", assert.Expected());
+    Assert.Equal("abcxef", assert.Actual());
+}
+
+FACT("EqualForStrings shows a line diff of multiline strings")
+{
+    auto assert = Assert.Throws<xUnitAssert>([]() { Assert.Equal("one\ntwo\nthree\n", "one\n2\nthree\n"); });
+
+    Assert.Contains(assert.CustomMessage(), "(line 2, column 1)");
+    Assert.Contains(assert.CustomMessage(), "\n     - two");
+    Assert.Contains(assert.CustomMessage(), "\n     + 2");
+    Assert.Contains(assert.CustomMessage(), "\n       three");
+}
+
+FACT("EqualForStrings failure on huge strings is bounded")
+{
+    std::string expected(4 * 1024 * 1024, 'x');
+    std::string actual = expected;
+    actual[2 * 1024 * 1024] = 'y';
+    actual += "tail";
+
+    auto assert = Assert.Throws<xUnitAssert>([&]() { Assert.Equal(expected, actual); });
+
+    Assert.Contains(assert.CustomMessage(), "position 2097152");
+    Assert.Contains(assert.CustomMessage(), "@@ position 2097152 @@ ...xxxx");
+    Assert.Contains(assert.CustomMessage(), "{+y+}");
+    Assert.InRange(assert.Expected().size(), (size_t)1, (size_t)100);
+    Assert.InRange(assert.Actual().size(), (size_t)1, (size_t)100);
+    Assert.InRange(assert.CustomMessage().size(), (size_t)1, xUnitpp::Diff::MaxReportLength + 256);
+}
+
 }
@@ -0,0 +1,98 @@
+#include <list>
+#include <string>
+#include <utility>
+#include <vector>
+#include "xUnit++/xUnit++.h"
+
+using xUnitpp::xUnitAssert;
+
+SUITE("AssertEquivalent")
+{
+
+FACT("EquivalentIgnoresOrder")
+{
+    std::vector<int> expected;
+    std::list<int> actual;
+
+    for (int i = 0; i != 100; ++i)
+    {
+        expected.push_back(i);
+        actual.push_front(i);
+    }
+
+    Assert.Equivalent(expected, actual);
+}
+
+FACT("EquivalentCountsDuplicates")
+{
+    std::vector<std::string> expected;
+    expected.push_back("a");
+    expected.push_back("a");
+    expected.push_back("b");
+
+    std::vector<std::string> actual;
+    actual.push_back("b");
+    actual.push_back("a");
+    actual.push_back("b");
+
+    auto assert = Assert.Throws<xUnitAssert>([&]() { Assert.Equivalent(expected, actual); });
+
+    Assert.Equal("Sequences are not equivalent. 1 missing: [ a ]. 1 unexpected: [ b ].", assert.CustomMessage());
+}
+
+FACT("EquivalentWithoutHashSortsElements")
+{
+    std::vector<std::pair<int, int>> expected;
+    expected.push_back(std::make_pair(1, 2));
+    expected.push_back(std::make_pair(3, 4));
+
+    std::vector<std::pair<int, int>> actual;
+    actual.push_back(std::make_pair(3, 4));
+    actual.push_back(std::make_pair(1, 2));
+
+    Assert.Equivalent(expected, actual);
+
+    actual.push_back(std::make_pair(5, 6));
+
+    auto assert = Assert.Throws<xUnitAssert>([&]() { Assert.Equivalent(expected, actual); });
+
+    Assert.Contains(assert.CustomMessage(), "Sequences are not equivalent. 1 unexpected: [ ");
+}
+
+FACT("EquivalentReportsBoundedLists")
+{
+    std::vector<int> expected(1000000);
+    std::vector<int> actual(1000000);
+
+    for (int i = 0; i != (int)expected.size(); ++i)
+    {
+        expected[i] = i;
+        actual[i] = (int)actual.size() - i - 1;
+    }
+
+    Assert.Equivalent(expected, actual);
+
+    for (int i = 0; i != 100; ++i)
+    {
+        actual[i] = -1;
+    }
+
+    auto assert = Assert.Throws<xUnitAssert>([&]() { Assert.Equivalent(expected, actual); });
+
+    Assert.Contains(assert.CustomMessage(), "100 missing: [ 999900, 999901, 999902, 999903, 999904, 999905, 999906, 999907, ... ].");
+    Assert.Contains(assert.CustomMessage(), "100 unexpected: [ -1, -1, -1, -1, -1, -1, -1, -1, ... ].");
+}
+
+FACT("EquivalentAppendsUserMessage")
+{
+    static const std::string msg = "custom message";
+
+    std::vector<int> expected(1, 0);
+    std::vector<int> actual;
+
+    auto assert = Assert.Throws<xUnitAssert>([&]() { Assert.Equivalent(expected, actual) << msg; });
+
+    Assert.Contains(assert.UserMessage(), msg.c_str());
+}
+
+}
@@ -0,0 +1,175 @@
+#include <array>
+#include <cmath>
+#include <limits>
+#include <list>
+#include <string>
+#include <vector>
+#include "xUnit++/xUnit++.h"
+
+using xUnitpp::xUnitAssert;
+
+SUITE("AssertNear")
+{
+
+FACT("NearForScalarsWithinTolerance")
+{
+    Assert.Near(1.0, 1.05, 0.1);
+    Assert.Near(100.0f, 101.0f, 0.0, 0.02);
+}
+
+FACT("NearForScalarsAssertsOnFailure")
+{
+    Assert.Throws<xUnitAssert>([]() { Assert.Near(1.0, 1.2, 0.1); });
+    Assert.Throws<xUnitAssert>([]() { Assert.Near(100.0, 103.0, 0.0, 0.02); });
+}
+
+FACT("NearNeedsValidTolerance")
+{
+    Assert.Throws<std::invalid_argument>([]() { Assert.Near(1.0, 1.0, -0.1); });
+    Assert.Throws<std::invalid_argument>([]() { Assert.Near(1.0, 1.0, 0.1, -0.1); });
+}
+
+FACT("NearTreatsNaNAsOutOfTolerance")
+{
+    auto nan = std::numeric_limits<double>::quiet_NaN();
+
+    Assert.Throws<xUnitAssert>([=]() { Assert.Near(nan, 1.0, 0.1); });
+    Assert.Throws<xUnitAssert>([=]() { Assert.Near(1.0, nan, 0.1); });
+}
+
+FACT("NearAcceptsEqualInfinities")
+{
+    auto inf = std::numeric_limits<double>::infinity();
+
+    Assert.Near(inf, inf, 0.0);
+    Assert.Throws<xUnitAssert>([=]() { Assert.Near(inf, -inf, 0.0); });
+}
+
+FACT("NearOnlyAcceptsInfinitiesWhichAreEqual")
+{
+    auto inf = std::numeric_limits<double>::infinity();
+    auto nan = std::numeric_limits<double>::quiet_NaN();
+
+    Assert.Near(inf, inf, 0.1, 0.1);
+    Assert.Throws<xUnitAssert>([=]() { Assert.Near(inf, -inf, 0.1, 0.1); });
+    Assert.Throws<xUnitAssert>([=]() { Assert.Near(inf, 1.0, 0.1, 0.1); });
+    Assert.Throws<xUnitAssert>([=]() { Assert.Near(1.0, inf, 0.1, 0.1); });
+    Assert.Throws<xUnitAssert>([=]() { Assert.Near(inf, nan, 0.1, 0.1); });
+    Assert.Throws<xUnitAssert>([=]() { Assert.Near(nan, nan, 0.1, 0.1); });
+
+    std::vector<double> expected(3000, inf);
+    std::vector<double> actual(3000, inf);
+    actual[2000] = -inf;
+
+    auto assert = Assert.Throws<xUnitAssert>([&]() { Assert.Near(expected, actual, 0.1, 0.1); });
+    Assert.Contains(assert.CustomMessage(), "1 of 3000 elements out of tolerance");
+}
+
+FACT("NearForRangesWithinTolerance")
+{
+    std::vector<float> expected(5000);
+    std::vector<float> actual(5000);
+
+    for (size_t i = 0; i != expected.size(); ++i)
+    {
+        expected[i] = (float)i;
+        actual[i] = (float)i + 0.0005f;
+    }
+
+    Assert.Near(expected, actual, 0.001);
+}
+
+FACT("NearReportsCountAndWorstElement")
+{
+    std::vector<double> expected(3000, 1.0);
+    std::vector<double> actual(3000, 1.0);
+
+    actual[10] = 1.5;
+    actual[1500] = 3.0;
+    actual[2999] = 1.25;
+
+    auto assert = Assert.Throws<xUnitAssert>([&]() { Assert.Near(expected, actual, 0.1); });
+
+    Assert.Contains(assert.CustomMessage(), "3 of 3000 elements out of tolerance");
+    Assert.Contains(assert.CustomMessage(), "index 1500: 2 ");
+    Assert.Equal("1", assert.Expected());
+    Assert.Equal("3", assert.Actual());
+}
+
+FACT("NearComparesMixedAndNonContiguousRanges")
+{
+    std::list<double> expected;
+    std::vector<float> actual;
+
+    for (int i = 0; i != 2500; ++i)
+    {
+        expected.push_back(i * 0.5);
+        actual.push_back(i * 0.5f);
+    }
+
+    Assert.Near(expected, actual, 1e-6);
+
+    actual[2100] += 1.0f;
+
+    auto assert = Assert.Throws<xUnitAssert>([&]() { Assert.Near(expected, actual, 1e-6); });
+
+    Assert.Contains(assert.CustomMessage(), "index 2100");
+}
+
+FACT("NearComparesArrays")
+{
+    float expected[] = { 1.0f, 2.0f, 3.0f };
+    std::array<float, 3> actual = { { 1.0f, 2.0f, 3.5f } };
+
+    Assert.Near(expected, actual, 0.6);
+    Assert.Throws<xUnitAssert>([&]() { Assert.Near(expected, actual, 0.1); });
+}
+
+FACT("NearAssertsOnLengthMismatch")
+{
+    std::vector<double> expected(3, 1.0);
+    std::vector<double> actual(4, 1.0);
+
+    auto assert = Assert.Throws<xUnitAssert>([&]() { Assert.Near(expected, actual, 0.1); });
+
+    Assert.Equal("length 3", assert.Expected());
+    Assert.Equal("length 4", assert.Actual());
+}
+
+FACT("NearUlpsForScalars")
+{
+    auto one = 1.0f;
+    auto next = std::nextafter(one, 2.0f);
+
+    Assert.NearUlps(one, next, 1);
+    Assert.Throws<xUnitAssert>([=]() { Assert.NearUlps(one, next, 0); });
+
+    Assert.NearUlps(0.0, -0.0, 0);
+    Assert.NearUlps(-std::numeric_limits<double>::denorm_min(), std::numeric_limits<double>::denorm_min(), 2);
+}
+
+FACT("NearUlpsForRanges")
+{
+    std::vector<double> expected(2000, 0.1);
+    std::vector<double> actual(2000, 0.1);
+
+    actual[7] = std::nextafter(std::nextafter(0.1, 1.0), 1.0);
+    actual[1999] = std::nextafter(0.1, 0.0);
+
+    Assert.NearUlps(expected, actual, 2);
+
+    auto assert = Assert.Throws<xUnitAssert>([&]() { Assert.NearUlps(expected, actual, 1); });
+
+    Assert.Contains(assert.CustomMessage(), "1 of 2000 elements out of tolerance. Largest error at index 7: 2 (tolerance: 1 ulps).");
+}
+
+FACT("NearAppendsUserMessage")
+{
+    static const std::string msg = "custom message";
+
+    auto assert = Assert.Throws<xUnitAssert>([]() { Assert.Near(0.0, 1.0, 0.5) << msg; });
+
+    Assert.Contains(assert.UserMessage(), msg.c_str());
+}
+
+}
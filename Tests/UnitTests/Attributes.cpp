@@ -26,6 +26,40 @@ FACT("TestWithAttributes")
 }
 }
 
+ATTRIBUTES(("Cats", "Meow"))
+{
+FACT("TestsWithEqualAttributesShareThem")
+{
+    const xUnitpp::TestDetails *self = nullptr;
+    const xUnitpp::TestDetails *sibling = nullptr;
+
+    for (const auto &test : xUnitpp::TestCollection::Instance().Tests())
+    {
+        if (test->TestDetails().Name == "TestWithAttributes")
+        {
+            sibling = &test->TestDetails();
+        }
+        else if (test->TestDetails().Name == "TestsWithEqualAttributesShareThem")
+        {
+            self = &test->TestDetails();
+        }
+    }
+
+    Assert.NotNull(self);
+    Assert.NotNull(sibling);
+
+    Assert.True(sibling->Attributes.Identity() == self->Attributes.Identity());
+    Assert.Same(sibling->Suite, self->Suite);
+    Assert.Same(sibling->LineInfo.file, self->LineInfo.file);
+
+    // a change is made to a copy, not to every test that shares it
+    auto copy = self->Attributes;
+    copy.insert(std::make_pair("Dogs", "Woof"));
+    Assert.True(copy.Identity() != self->Attributes.Identity());
+    Assert.Equal(1U, (size_t)std::distance(self->Attributes.begin(), self->Attributes.end()));
+}
+}
+
 FACT("SkippedTestsShouldNotBeInstantiated")
 {
     // have to set this internal test up manually since the macros don't work embedded within each other
@@ -0,0 +1,148 @@
+#include <string>
+#include <vector>
+#include "xUnit++/xUnitDiff.h"
+#include "xUnit++/xUnit++.h"
+
+namespace Diff = xUnitpp::Diff;
+
+SUITE("Diff")
+{
+
+std::vector<Diff::Edit> DiffStrings(const std::string &expected, const std::string &actual, long long maxCost = Diff::MaxCost)
+{
+    return Diff::Compute(expected.size(), actual.size(), [&](size_t e, size_t a) { return expected[e] == actual[a]; }, maxCost);
+}
+
+size_t EditDistance(const std::vector<Diff::Edit> &edits)
+{
+    size_t distance = 0;
+
+    for (const auto &edit : edits)
+    {
+        if (edit.kind != Diff::Edit::Equal)
+        {
+            distance += edit.length;
+        }
+    }
+
+    return distance;
+}
+
+// applying the edit script to expected has to reproduce actual
+std::string Apply(const std::string &expected, const std::string &actual, const std::vector<Diff::Edit> &edits)
+{
+    std::string result;
+
+    for (const auto &edit : edits)
+    {
+        if (edit.kind == Diff::Edit::Equal)
+        {
+            result += expected.substr(edit.expected, edit.length);
+        }
+        else if (edit.kind == Diff::Edit::Insert)
+        {
+            result += actual.substr(edit.actual, edit.length);
+        }
+    }
+
+    return result;
+}
+
+FACT("Equal sequences produce a single unchanged run")
+{
+    auto edits = DiffStrings("abcdef", "abcdef");
+
+    Assert.Equal(1U, edits.size());
+    Assert.Equal(Diff::Edit::Equal, edits[0].kind);
+    Assert.Equal(6U, edits[0].length);
+}
+
+FACT("Empty sequences produce no edits")
+{
+    Assert.Empty(DiffStrings("", ""));
+}
+
+DATA_THEORY("Diff finds the shortest edit script", (const std::string &expected, const std::string &actual, size_t distance),
+    ([]() -> std::vector<std::tuple<std::string, std::string, size_t>>
+    {
+        std::vector<std::tuple<std::string, std::string, size_t>> data;
+
+        data.emplace_back("abcabba", "cbabac", 5);
+        data.emplace_back("abc", "", 3);
+        data.emplace_back("", "abc", 3);
+        data.emplace_back("abcdef", "abXdef", 2);
+        data.emplace_back("abcdef", "abcdefgh", 2);
+        data.emplace_back("the quick brown fox", "the quack brown box", 4);
+
+        return data;
+    }))
+{
+    auto edits = DiffStrings(expected, actual);
+
+    Assert.Equal(distance, EditDistance(edits));
+    Assert.Equal(actual, Apply(expected, actual, edits));
+}
+
+FACT("Exhausted budget still produces a valid edit script")
+{
+    std::string expected(2000, 'a');
+    std::string actual(2000, 'b');
+
+    for (size_t i = 0; i < expected.size(); i += 7)
+    {
+        expected[i] = 'b';
+        actual[i] = 'a';
+    }
+
+    auto edits = DiffStrings(expected, actual, 100);
+
+    Assert.Equal(actual, Apply(expected, actual, edits));
+}
+
+FACT("Hunks merge changes separated by little context")
+{
+    auto edits = DiffStrings("a1bcd2efghijklmnop3", "aXbcdYefghijklmnopZ");
+    auto hunks = Diff::Hunks(edits, 2);
+
+    Assert.Equal(2U, hunks.size());
+    Assert.Equal(2U, hunks[0].trailing);
+    Assert.Equal(0U, hunks[1].trailing);
+}
+
+FACT("Rendered diff marks deleted and inserted elements")
+{
+    std::vector<int> expected;
+    expected.push_back(1);
+    expected.push_back(2);
+    expected.push_back(3);
+
+    std::vector<int> actual;
+    actual.push_back(1);
+    actual.push_back(4);
+    actual.push_back(3);
+
+    auto edits = Diff::Compute(expected.size(), actual.size(), [&](size_t e, size_t a) { return expected[e] == actual[a]; });
+    auto rendered = Diff::Render(edits,
+        [&](size_t e) { return std::to_string(expected[e]); },
+        [&](size_t a) { return std::to_string(actual[a]); }, "");
+
+    Assert.Contains(rendered, "@@ expected[0..3) actual[0..3) @@");
+    Assert.Contains(rendered, "\n- 2");
+    Assert.Contains(rendered, "\n+ 4");
+    Assert.Contains(rendered, "\n  1");
+}
+
+FACT("Rendered diff stays within its budget")
+{
+    std::string expected(100000, 'a');
+    std::string actual(100000, 'b');
+
+    auto edits = DiffStrings(expected, actual);
+    auto rendered = Diff::Render(edits,
+        [&](size_t e) { return std::string(1, expected[e]); },
+        [&](size_t a) { return std::string(1, actual[a]); });
+
+    Assert.InRange(rendered.size(), (size_t)1, Diff::MaxReportLength + Diff::MaxElementLength + 64);
+}
+
+}
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <vector>
 #include <memory>
 #include "xUnit++/xUnit++.h"
@@ -107,10 +108,38 @@ FACT_FIXTURE("TestEventSources should be usable within Theories", Fixture)
 
     Run();
 
-    for (const auto &test : collection.Tests())
+    // each row is its own test, and records only its own event
+    std::vector<int> instances;
+    for (const auto &event : outputRecord.events)
     {
-        Check.Equal(1U, test->TestEvents().size()) << "current: " << test->TestDetails().Id;
+        instances.push_back(std::get<0>(event).TestInstance);
     }
+
+    std::sort(instances.begin(), instances.end());
+
+    Assert.Equal(10U, instances.size());
+    for (int i = 0; i != 10; ++i)
+    {
+        Check.Equal(i, instances[i]);
+    }
+}
+
+FACT_FIXTURE("Check.All should record a single event for any number of failures", Fixture)
+{
+    auto factWithChecks = [&]()
+    {
+        std::vector<int> values(1000, 0);
+        LocalCheck().All(values, [](int value) { return value != 0; });
+    };
+
+    xUnitpp::TestCollection::Register reg(collection, factWithChecks, "Name", "Suite", xUnitpp::AttributeCollection(), -1, "file", 0, std::forward<decltype(localEventRecorders)>(localEventRecorders));
+    (void)reg;
+
+    Run();
+
+    Assert.Equal(1U, outputRecord.events.size());
+    Assert.Equal(xUnitpp::EventLevel::Check, std::get<1>(outputRecord.events[0]).GetLevel());
+    Assert.Contains(to_string(std::get<1>(outputRecord.events[0])), "1000 of 1000 elements do not match.");
 }
 
 }
@@ -0,0 +1,214 @@
+#include <atomic>
+#include <iterator>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include "xUnit++/RunOptions.h"
+#include "xUnit++/TestCollection.h"
+#include "xUnit++/TestDetails.h"
+#include "xUnit++/TestManifest.h"
+#include "xUnit++/TestRecord.h"
+#include "xUnit++/xUnitTestRunner.h"
+#include "xUnit++/xUnitTime.h"
+#include "xUnit++/xUnit++.h"
+#include "Helpers/OutputRecord.h"
+
+SUITE("TestRecords")
+{
+
+std::atomic<int> factRuns(0);
+std::atomic<int> theoryRows(0);
+std::atomic<int> attributeLookups(0);
+
+// the counters are shared, so the tests counting them can't run at the same time
+std::mutex counting;
+
+void RecordedFact()
+{
+    ++factRuns;
+}
+
+void RecordedTheory(int)
+{
+    ++theoryRows;
+}
+
+const std::string &RecordedSuite()
+{
+    static std::string suite = "Recorded";
+    return suite;
+}
+
+xUnitpp::AttributeCollection RecordedAttributes()
+{
+    ++attributeLookups;
+
+    xUnitpp::AttributeCollection attributes;
+    attributes.insert(std::make_pair("Speed", "Fast"));
+    attributes.insert(std::make_pair("Size", "Small"));
+    attributes.sort();
+    return attributes;
+}
+
+std::shared_ptr<const xUnitpp::TheorySource> RecordedSource(const xUnitpp::TestRecord &record)
+{
+    return xUnitpp::TestCollection::RecordedTheory(record, &RecordedTheory,
+        xUnitpp::TheoryGenerator(3, [](size_t i) { return std::make_tuple((int)i); }));
+}
+
+const xUnitpp::TestRecord factRecord = { "Fact", "", "Records.cpp", 10, -1, &RecordedSuite, &RecordedAttributes, &RecordedFact, nullptr };
+const xUnitpp::TestRecord theoryRecord = { "Theory", "(int x)", "Records.cpp", 20, -1, &RecordedSuite, &RecordedAttributes, nullptr, &RecordedSource };
+
+// null entries are padding, as a linker might leave between records
+const xUnitpp::TestRecord *const records[] = { &factRecord, nullptr, &theoryRecord };
+
+struct RecordsFixture
+{
+    RecordsFixture()
+        : lock(counting)
+        , collection(std::begin(records), std::end(records))
+    {
+        factRuns = 0;
+        theoryRows = 0;
+        attributeLookups = 0;
+    }
+
+    std::lock_guard<std::mutex> lock;
+    xUnitpp::TestCollection collection;
+    xUnitpp::Tests::OutputRecord record;
+};
+
+FACT_FIXTURE("Recorded tests can be listed without being built", RecordsFixture)
+{
+    auto &found = collection.Records();
+
+    Assert.Equal(2U, found.size());
+    Assert.Equal("Fact", std::string(found[0].GetName()));
+    Assert.Equal("Recorded", std::string(found[0].GetSuite()));
+    Assert.Equal("Records.cpp", std::string(found[1].GetFile()));
+    Assert.Equal(20, found[1].GetLine());
+    Assert.Equal(1, found[0].GetInstanceCount());
+    Assert.NotEqual(found[0].GetId(), found[1].GetId());
+
+    // nothing asked for attributes yet
+    Assert.Equal(0, attributeLookups.load());
+
+    size_t begin, end;
+    found[0].FindAttributeKey("Speed", begin, end);
+    Assert.Equal(1U, end - begin);
+    Assert.Equal("Fast", std::string(found[0].GetAttributeValue(begin)));
+    Assert.Equal(1, attributeLookups.load());
+
+    Assert.Equal(0, factRuns.load());
+}
+
+FACT_FIXTURE("Recorded tests keep the ids they were listed with", RecordsFixture)
+{
+    auto &found = collection.Records();
+    auto &tests = collection.Tests();
+
+    Assert.Equal(2U, tests.size());
+
+    for (size_t i = 0; i != tests.size(); ++i)
+    {
+        Assert.Equal(found[i].GetId(), tests[i]->TestDetails().GetId());
+        Assert.Equal(found[i].GetName(), tests[i]->TestDetails().Name);
+    }
+
+    Assert.Equal(3, found[1].GetInstanceCount());
+}
+
+FACT_FIXTURE("Recorded tests can be selected in bulk by id", RecordsFixture)
+{
+    auto &found = collection.Records();
+    const int ids[] = { found[1].GetId() };
+    const uint64_t bitmap[] = { 1 };
+
+    xUnitpp::RunOptions options;
+    Assert.Equal(2U, collection.Select(options).size());
+
+    options.selection = xUnitpp::RunOptions::SelectIds;
+    options.ids = ids;
+    options.idCount = 1;
+
+    auto tests = collection.Select(options);
+    Assert.Equal(1U, tests.size());
+    Assert.Equal("Theory", tests[0]->TestDetails().Name);
+
+    options.selection = xUnitpp::RunOptions::SelectBitmap;
+    options.bitmap = bitmap;
+    options.firstId = found[0].GetId();
+    options.bitCount = 2;
+
+    tests = collection.Select(options);
+    Assert.Equal(1U, tests.size());
+    Assert.Equal("Fact", tests[0]->TestDetails().Name);
+}
+
+FACT_FIXTURE("Every selected test is in exactly one shard", RecordsFixture)
+{
+    xUnitpp::RunOptions options;
+    options.shardCount = 3;
+
+    size_t selected = 0;
+    for (options.shardIndex = 0; options.shardIndex != options.shardCount; ++options.shardIndex)
+    {
+        selected += collection.Select(options).size();
+    }
+
+    Assert.Equal(2U, selected);
+}
+
+FACT_FIXTURE("Recorded tests keep their stable ids from one collection to the next", RecordsFixture)
+{
+    xUnitpp::TestCollection other(std::begin(records), std::end(records));
+
+    auto &found = collection.Records();
+
+    Assert.Equal(xUnitpp::Manifest::StableHash("Recorded", "Fact"), found[0].GetStableId());
+    Assert.NotEqual(found[0].GetId(), other.Records()[0].GetId());
+    Assert.Equal(found[0].GetStableId(), other.Records()[0].GetStableId());
+    Assert.Equal(found[1].GetStableId(), other.Records()[1].GetStableId());
+
+    // built tests keep them, too
+    Assert.Equal(found[1].GetStableId(), collection.Tests()[1]->TestDetails().GetStableId());
+}
+
+FACT("Tests sharing a suite and name get different stable ids")
+{
+    const xUnitpp::TestRecord sameName = { "Fact", "", "Other.cpp", 30, -1, &RecordedSuite, &RecordedAttributes, &RecordedFact, nullptr };
+    const xUnitpp::TestRecord *const colliding[] = { &factRecord, &theoryRecord, &sameName };
+
+    xUnitpp::TestCollection collection(std::begin(colliding), std::end(colliding));
+    auto &found = collection.Records();
+
+    Assert.NotEqual(found[0].GetStableId(), found[2].GetStableId());
+    Assert.NotEqual(xUnitpp::Manifest::StableHash("Recorded", "Fact"), found[0].GetStableId());
+    Assert.Equal(xUnitpp::Manifest::StableHash("Recorded", "Theory"), found[1].GetStableId());
+}
+
+FACT("Theory rows have stable ids of their own")
+{
+    xUnitpp::TestDetails theory(0, 42ULL, "Theory", "Recorded", xUnitpp::AttributeCollection(), xUnitpp::Time::Duration::zero(), "Records.cpp", 20);
+
+    xUnitpp::TestDetails first(theory, 0, []() { return std::string("(1)"); });
+    xUnitpp::TestDetails second(theory, 1, []() { return std::string("(2)"); });
+    xUnitpp::TestDetails again(theory, 1, []() { return std::string("(2)"); });
+
+    Assert.Equal(42ULL, theory.GetStableId());
+    Assert.NotEqual(theory.GetStableId(), first.GetStableId());
+    Assert.NotEqual(first.GetStableId(), second.GetStableId());
+    Assert.Equal(second.GetStableId(), again.GetStableId());
+    Assert.NotEqual(second.GetId(), again.GetId());
+}
+
+FACT_FIXTURE("Recorded tests run once they are built", RecordsFixture)
+{
+    xUnitpp::RunTests(record, [](const xUnitpp::ITestDetails &) { return true; }, collection.Tests(), xUnitpp::Time::Duration::zero(), 0);
+
+    Assert.Equal(1, factRuns.load());
+    Assert.Equal(3, theoryRows.load());
+    Assert.Equal(0U, record.summaryFailed);
+}
+
+}
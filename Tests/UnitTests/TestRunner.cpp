@@ -18,6 +18,7 @@ SUITE("TestRunner")
 struct TestRunnerFixture
 {
     TestRunnerFixture()
+        : duration(Time::Duration::zero())
     {
         testEventRecorders.push_back(std::make_shared<xUnitpp::TestEventRecorder>());
         testEventRecorders.push_back(std::make_shared<xUnitpp::TestEventRecorder>());
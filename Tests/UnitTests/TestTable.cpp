@@ -0,0 +1,79 @@
+#include <vector>
+#include "xUnit++/xUnit++.h"
+#include "xUnit++/RunOptions.h"
+#include "xUnit++/StringPool.h"
+#include "xUnit++/TestTable.h"
+
+SUITE("TestTable")
+{
+
+struct TableFixture
+{
+    TableFixture()
+    {
+        const auto &math = xUnitpp::StringPool::Intern("Math");
+        const auto &strings = xUnitpp::StringPool::Intern("Strings");
+
+        table.Add(10, 7, strings, -1, false);   // row 0
+        table.Add(11, 4, math, 0, false);       // row 1
+        table.Add(12, 9, strings, 100, true);   // row 2
+        table.Add(13, 2, math, -1, false);      // row 3
+    }
+
+    xUnitpp::TestTable table;
+};
+
+FACT_FIXTURE("Equal suites share a row of their own", TableFixture)
+{
+    Assert.Equal(4U, table.size());
+    Assert.Equal(2U, table.suiteNames.size());
+    Assert.Equal(std::vector<uint32_t>({ 0, 1, 0, 1 }), table.suites);
+    Assert.Equal(std::vector<uint8_t>({ 0, 0, 1, 0 }), table.skipped);
+}
+
+FACT_FIXTURE("Rows are selected by id and shard", TableFixture)
+{
+    xUnitpp::RunOptions options;
+    Assert.Equal(std::vector<uint32_t>({ 0, 1, 2, 3 }), table.Select(options));
+
+    const int ids[] = { 9, 11, 13, 14 };
+    options.selection = xUnitpp::RunOptions::SelectIds;
+    options.ids = ids;
+    options.idCount = 4;
+    Assert.Equal(std::vector<uint32_t>({ 1, 3 }), table.Select(options));
+
+    const uint64_t bitmap[] = { 0x5 };
+    options.selection = xUnitpp::RunOptions::SelectBitmap;
+    options.bitmap = bitmap;
+    options.firstId = 10;
+    options.bitCount = 4;
+    Assert.Equal(std::vector<uint32_t>({ 0, 2 }), table.Select(options));
+
+    options.selection = xUnitpp::RunOptions::SelectAll;
+    options.shardIndex = 1;
+    options.shardCount = 2;
+    Assert.Equal(std::vector<uint32_t>({ 0, 2 }), table.Select(options));
+}
+
+FACT_FIXTURE("Ids added out of order are still found", TableFixture)
+{
+    table.Add(5, 1, xUnitpp::StringPool::Intern("Math"), -1, false);
+
+    const int ids[] = { 5, 12 };
+    xUnitpp::RunOptions options;
+    options.selection = xUnitpp::RunOptions::SelectIds;
+    options.ids = ids;
+    options.idCount = 2;
+
+    Assert.Equal(std::vector<uint32_t>({ 2, 4 }), table.Select(options));
+}
+
+FACT_FIXTURE("Rows sort by suite name, then stable id", TableFixture)
+{
+    std::vector<uint32_t> rows({ 0, 1, 2, 3 });
+    table.SortBySuite(rows);
+
+    Assert.Equal(std::vector<uint32_t>({ 3, 1, 0, 2 }), rows);
+}
+
+}
@@ -1,6 +1,9 @@
 #include <algorithm>
 #include <array>
+#include <atomic>
+#include <memory>
 #include <mutex>
+#include <stdexcept>
 #include <string>
 #include <tuple>
 #include <vector>
@@ -312,6 +315,253 @@ FACT_FIXTURE("Every theory instance should know the file it is in", TheoryFixtur
     }
 }
 
+FACT_FIXTURE("Theory data is not generated until the theory runs", TheoryFixture)
+{
+    int calls = 0;
+
+    Register("Lazy", "(int x)", [&]() { ++calls; return RawFunctionProvider(); });
+
+    Assert.Equal(0, calls);
+
+    Run();
+
+    Assert.Equal(1, calls);
+    Assert.Equal(5U, record.finishedTests.size());
+}
+
+FACT_FIXTURE("Theories know their instance count without running", TheoryFixture)
+{
+    int calls = 0;
+
+    Register("Generated", "(int x)", xUnitpp::TheoryGenerator(1000, [](size_t i) { return std::make_tuple((int)i % 2); }));
+    Register("Built", "(int x)", [&]() { ++calls; return RawFunctionProvider(); });
+
+    Assert.Equal(1000, collection.Tests()[0]->TestDetails().GetInstanceCount());
+
+    // counting a container means building it
+    Assert.Equal(xUnitpp::TheorySource::UnknownCount, collection.Tests()[1]->TestDetails().GetInstanceCount());
+    Assert.Equal(0, calls);
+    Assert.Empty(record.orderedTestList);
+}
+
+FACT_FIXTURE("TheoryGenerator creates each row when it is run", TheoryFixture)
+{
+    RegisterAndRun("Generated", "(int x)", xUnitpp::TheoryGenerator(10000, [](size_t i) { return std::make_tuple((int)i % 2); }));
+
+    Assert.Equal(10000U, record.finishedTests.size());
+    Assert.Empty(record.events);
+
+    std::vector<int> instances;
+    for (const auto &test : record.finishedTests)
+    {
+        instances.push_back(test.first.TestInstance);
+        Assert.Equal("Generated", test.first.Name);
+    }
+
+    std::sort(instances.begin(), instances.end());
+    for (int i = 0; i != (int)instances.size(); ++i)
+    {
+        Assert.Equal(i, instances[i]);
+    }
+}
+
+FACT_FIXTURE("TheoryStream reads rows in order", TheoryFixture)
+{
+    auto streamed = std::make_shared<std::vector<int>>();
+
+    auto provider = [=]()
+        {
+            auto next = std::make_shared<int>(0);
+            return xUnitpp::TheoryStream<std::tuple<int>>([=](std::tuple<int> &row)
+                {
+                    if (*next == 500)
+                    {
+                        return false;
+                    }
+
+                    streamed->push_back(*next);
+                    row = std::make_tuple((*next)++ % 2);
+                    return true;
+                });
+        };
+
+    Register("Streamed", "(int x)", provider);
+
+    Assert.Equal(xUnitpp::TheorySource::UnknownCount, collection.Tests()[0]->TestDetails().GetInstanceCount());
+
+    Run();
+
+    Assert.Equal(500U, record.finishedTests.size());
+    Assert.Empty(record.events);
+
+    for (int i = 0; i != (int)streamed->size(); ++i)
+    {
+        Assert.Equal(i, (*streamed)[i]);
+    }
+}
+
+FACT_FIXTURE("Failing theory data providers are reported as failures", TheoryFixture)
+{
+    RegisterAndRun("Throws", "(int x)", []() -> std::vector<std::tuple<int>> { throw std::runtime_error("no data"); });
+
+    Assert.Equal(1U, record.summaryFailed);
+    Assert.Equal(1U, record.events.size());
+    Assert.Equal("Throws", record.events[0].first.Name);
+    Assert.Contains(to_string(record.events[0].second), "Unable to generate theory data: no data");
+}
+
+FACT_FIXTURE("Failing theory generators are reported as one failure, however many chunks fail", TheoryFixture)
+{
+    // enough rows for many chunks, every one of which fails
+    RegisterAndRun("Throws", "(int x)", xUnitpp::TheoryGenerator(20000, [](size_t) -> std::tuple<int> { throw std::runtime_error("no row"); }));
+
+    Assert.Equal(1U, record.summaryFailed);
+    Assert.Equal(1U, record.orderedTestList.size());
+    Assert.Equal(1U, record.events.size());
+    Assert.Equal(1U, record.finishedTests.size());
+    Assert.Contains(to_string(record.events[0].second), "Unable to generate theory data: no row");
+}
+
+FACT_FIXTURE("Theory rows share their theory's details", TheoryFixture)
+{
+    RegisterAndRun("Shared", "(int x)", xUnitpp::TheoryGenerator(100, [](size_t i) { return std::make_tuple((int)i % 2); }));
+
+    const auto &theory = collection.Tests()[0]->TestDetails();
+
+    Assert.Equal(100U, record.finishedTests.size());
+
+    for (const auto &test : record.finishedTests)
+    {
+        Assert.Same(theory.Name, test.first.Name);
+        Assert.Same(theory.Attributes, test.first.Attributes);
+        Assert.Same(theory.LineInfo, test.first.LineInfo);
+    }
+}
+
+struct Formatted
+{
+    static std::atomic<int> count;
+
+    friend std::string to_string(const Formatted &)
+    {
+        ++count;
+        return "formatted";
+    }
+};
+
+std::atomic<int> Formatted::count(0);
+
+FACT_FIXTURE("Theory row params are only formatted when asked for", TheoryFixture)
+{
+    Formatted::count = 0;
+
+    xUnitpp::TestCollection::Register reg(collection, [](const Formatted &) {},
+        xUnitpp::TheoryGenerator(10, [](size_t) { return std::make_tuple(Formatted()); }),
+        "Formatted", "Theory", "(const Formatted &f)", attributes, -1, GetFakeFileName(), __LINE__, localEventRecorders);
+    (void)reg;
+
+    Run();
+
+    Assert.Equal(10U, record.finishedTests.size());
+    Assert.Equal(0, Formatted::count.load());
+
+    auto &row = record.finishedTests[0].first;
+    Assert.Equal("Formatted[" + std::to_string(row.TestInstance) + "](f: formatted)", std::string(row.GetFullName()));
+    Assert.Equal("(f: formatted)", std::string(row.GetParams()));
+    Assert.Equal(1, Formatted::count.load());
+}
+
+THEORY("Inline theories can be wide and long", (int a, int b, int c, int d, int e, int f, const std::string &g, char h),
+    std::make_tuple(0, 1, 2, 3, 4, 5, "6", '7'),
+    std::make_tuple(1, 2, 3, 4, 5, 6, "7", '8'),
+    std::make_tuple(2, 3, 4, 5, 6, 7, "8", '9'),
+    std::make_tuple(0, 1, 2, 3, 4, 5, "6", '7'),
+    std::make_tuple(1, 2, 3, 4, 5, 6, "7", '8'),
+    std::make_tuple(2, 3, 4, 5, 6, 7, "8", '9'),
+    std::make_tuple(0, 1, 2, 3, 4, 5, "6", '7'),
+    std::make_tuple(1, 2, 3, 4, 5, 6, "7", '8'),
+    std::make_tuple(2, 3, 4, 5, 6, 7, "8", '9'),
+    std::make_tuple(0, 1, 2, 3, 4, 5, "6", '7'),
+    std::make_tuple(1, 2, 3, 4, 5, 6, "7", '8'),
+    std::make_tuple(2, 3, 4, 5, 6, 7, "8", '9'),
+    std::make_tuple(0, 1, 2, 3, 4, 5, "6", '7'),
+    std::make_tuple(1, 2, 3, 4, 5, 6, "7", '8'),
+    std::make_tuple(2, 3, 4, 5, 6, 7, "8", '9'),
+    std::make_tuple(0, 1, 2, 3, 4, 5, "6", '7'),
+    std::make_tuple(1, 2, 3, 4, 5, 6, "7", '8'),
+    std::make_tuple(2, 3, 4, 5, 6, 7, "8", '9'))
+{
+    Assert.Equal(a + 1, b);
+    Assert.Equal(a + 5, f);
+    Assert.Equal(std::to_string(a + 6), g);
+    Assert.Equal('7' + a, h);
+    (void)c; (void)d; (void)e;
+}
+
+FACT_FIXTURE("Theories pass every argument, however many there are", TheoryFixture)
+{
+    std::atomic<int> sum(0);
+
+    xUnitpp::TestCollection::Register reg(collection,
+        [&](int a, int b, int c, int d, int e, int f, int g) { sum += a + b + c + d + e + f + g; },
+        xUnitpp::TheoryGenerator(10, [](size_t i) { int x = (int)i; return std::make_tuple(x, x, x, x, x, x, x); }),
+        "Wide", "Theory", "(int a, int b, int c, int d, int e, int f, int g)", attributes, -1, GetFakeFileName(), __LINE__, localEventRecorders);
+    (void)reg;
+
+    Run();
+
+    Assert.Equal(10U, record.finishedTests.size());
+    Assert.Equal(7 * 45, sum.load());
+
+    auto &row = record.finishedTests[0].first;
+    auto x = std::to_string(row.TestInstance);
+    Assert.Equal("(a: " + x + ", b: " + x + ", c: " + x + ", d: " + x + ", e: " + x + ", f: " + x + ", g: " + x + ")", std::string(row.GetParams()));
+}
+
+struct MoveOnly
+{
+    MoveOnly(int value)
+        : value(new int(value))
+    {
+    }
+
+    MoveOnly(MoveOnly &&other)
+        : value(std::move(other.value))
+    {
+    }
+
+    friend std::string to_string(const MoveOnly &m)
+    {
+        return m.value ? std::to_string(*m.value) : "moved";
+    }
+
+    std::unique_ptr<int> value;
+
+private:
+    MoveOnly(const MoveOnly &) /* = delete */;
+};
+
+FACT_FIXTURE("Theories can take move-only arguments", TheoryFixture)
+{
+    std::atomic<int> sum(0);
+
+    xUnitpp::TestCollection::Register reg(collection,
+        [&](MoveOnly m, int x) { sum += *m.value + x; },
+        xUnitpp::TheoryGenerator(100, [](size_t i) { return std::make_tuple(MoveOnly((int)i), 1); }),
+        "MoveOnly", "Theory", "(MoveOnly m, int x)", attributes, -1, GetFakeFileName(), __LINE__, localEventRecorders);
+    (void)reg;
+
+    Run();
+
+    Assert.Equal(100U, record.finishedTests.size());
+    Assert.Equal(0U, record.summaryFailed);
+    Assert.Equal(4950 + 100, sum.load());
+
+    // formatted before the argument was moved into the theory
+    auto &row = record.finishedTests[0].first;
+    Assert.Equal("(m: " + std::to_string(row.TestInstance) + ", x: 1)", std::string(row.GetParams()));
+}
+
 ATTRIBUTES(("Cats", "Meow"))
 {
 DATA_THEORY("TheoriesCanHaveAttributes", (int), RawFunctionProvider)
@@ -0,0 +1,195 @@
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "xUnit++/IOutput.h"
+#include "xUnit++/xUnitTestRunner.h"
+#include "xUnit++/xUnitTheoryFile.h"
+#include "xUnit++/xUnitTime.h"
+#include "xUnit++/xUnit++.h"
+#include "Helpers/OutputRecord.h"
+
+SUITE("TheoryFile")
+{
+
+struct Record
+{
+    int id;
+    double value;
+};
+
+struct TheoryFileFixture
+{
+    TheoryFileFixture()
+        : fileName("TheoryFile." + std::to_string(reinterpret_cast<size_t>(this)) + ".data")
+    {
+    }
+
+    ~TheoryFileFixture()
+    {
+        std::remove(fileName.c_str());
+    }
+
+    void Write(const std::string &contents)
+    {
+        std::ofstream file(fileName, std::ios::binary);
+        file << contents;
+    }
+
+    template<typename TTheory, typename TTheoryData>
+    void Register(TTheory &&theory, TTheoryData &&theoryData)
+    {
+        xUnitpp::TestCollection::Register reg(
+            collection,
+            std::forward<TTheory>(theory),
+            std::forward<TTheoryData>(theoryData),
+            "TheoryFile",
+            "TheoryFile",
+            "(const TRecord &record)",
+            attributes,
+            -1,
+            "FakeFile.cpp", __LINE__,
+            localEventRecorders);
+        (void)reg;
+    }
+
+    void Run()
+    {
+        RunTests(record, [](const xUnitpp::ITestDetails &) { return true; },
+            collection.Tests(), xUnitpp::Time::Duration::zero(), 0);
+    }
+
+    std::string fileName;
+
+    std::mutex lock;
+    std::vector<std::string> rows;
+
+    xUnitpp::Tests::OutputRecord record;
+    xUnitpp::AttributeCollection attributes;
+    xUnitpp::TestCollection collection;
+    std::vector<std::shared_ptr<xUnitpp::TestEventRecorder>> localEventRecorders;
+};
+
+FACT("CsvRecord finds fields when asked")
+{
+    std::string line = "1,\"two, three\",,\"say \"\"hi\"\"\"";
+    xUnitpp::CsvRecord csv(xUnitpp::TextView(line.data(), line.size()), ',');
+
+    Assert.Equal(4U, csv.Count());
+    Assert.Equal("1", csv.Field(0).str());
+    Assert.Equal("two, three", csv.Field(1).str());
+    Assert.True(csv.Field(2).empty());
+    Assert.Equal("say \"hi\"", csv.Text(3));
+    Assert.Throws<std::out_of_range>([&]() { csv.Field(4); });
+}
+
+FACT_FIXTURE("JsonLinesFile passes each line to the theory", TheoryFileFixture)
+{
+    Write("{\"a\": 1}\n\n{\"a\": 2}\r\n{\"a\": 3}");
+
+    Register([&](const xUnitpp::TextView &line) { std::lock_guard<std::mutex> guard(lock); rows.push_back(line.str()); },
+        xUnitpp::JsonLinesFile(fileName));
+
+    Assert.Equal(xUnitpp::TheorySource::UnknownCount, collection.Tests()[0]->TestDetails().GetInstanceCount());
+
+    Run();
+
+    std::sort(rows.begin(), rows.end());
+
+    Assert.Equal(3U, rows.size());
+    Assert.Equal("{\"a\": 1}", rows[0]);
+    Assert.Equal("{\"a\": 2}", rows[1]);
+    Assert.Equal("{\"a\": 3}", rows[2]);
+    Assert.Equal(0U, record.summaryFailed);
+}
+
+FACT_FIXTURE("CsvFile skips the header and keeps quoted lines together", TheoryFileFixture)
+{
+    Write("id,name\n1,one\n2,\"two\nlines\"\n3,three\n");
+
+    Register([&](const xUnitpp::CsvRecord &csv) { std::lock_guard<std::mutex> guard(lock); rows.push_back(csv.Field(0).str() + "=" + csv.Text(1)); },
+        xUnitpp::CsvFile(fileName));
+
+    Run();
+
+    std::sort(rows.begin(), rows.end());
+
+    Assert.Equal(3U, rows.size());
+    Assert.Equal("1=one", rows[0]);
+    Assert.Equal("2=two\nlines", rows[1]);
+    Assert.Equal("3=three", rows[2]);
+}
+
+FACT_FIXTURE("BinaryRecordFile passes records in place", TheoryFileFixture)
+{
+    std::vector<Record> records(5000);
+    for (int i = 0; i != (int)records.size(); ++i)
+    {
+        records[i].id = i;
+        records[i].value = i * 0.5;
+    }
+
+    Write(std::string(reinterpret_cast<const char *>(records.data()), records.size() * sizeof(Record)));
+
+    std::vector<int> seen;
+    Register([&](const Record &r)
+        {
+            Assert.Equal(r.id * 0.5, r.value);
+
+            std::lock_guard<std::mutex> guard(lock);
+            seen.push_back(r.id);
+        },
+        xUnitpp::BinaryRecordFile<Record>(fileName));
+
+    Assert.Equal(5000, collection.Tests()[0]->TestDetails().GetInstanceCount());
+
+    Run();
+
+    std::sort(seen.begin(), seen.end());
+
+    Assert.Equal(5000U, seen.size());
+    for (int i = 0; i != (int)seen.size(); ++i)
+    {
+        Assert.Equal(i, seen[i]);
+    }
+
+    Assert.Equal(0U, record.summaryFailed);
+}
+
+FACT_FIXTURE("BinaryRecordFile rejects partial records", TheoryFileFixture)
+{
+    Write(std::string(sizeof(Record) + 1, '\0'));
+
+    Register([](const Record &) {}, xUnitpp::BinaryRecordFile<Record>(fileName));
+
+    Run();
+
+    Assert.Equal(1U, record.summaryFailed);
+    Assert.Contains(to_string(record.events[0].second), "is not a whole number of");
+}
+
+FACT_FIXTURE("Missing record files have an unknown instance count until they run", TheoryFileFixture)
+{
+    Register([](const Record &) {}, xUnitpp::BinaryRecordFile<Record>(fileName));
+
+    Assert.Equal(xUnitpp::TheorySource::UnknownCount, collection.Tests()[0]->TestDetails().GetInstanceCount());
+
+    Run();
+
+    Assert.Equal(1U, record.summaryFailed);
+    Assert.Contains(to_string(record.events[0].second), "Unable to open " + fileName);
+}
+
+FACT_FIXTURE("Missing theory files are reported as failures", TheoryFileFixture)
+{
+    Register([](const xUnitpp::TextView &) {}, xUnitpp::JsonLinesFile(fileName));
+
+    Run();
+
+    Assert.Equal(1U, record.summaryFailed);
+    Assert.Contains(to_string(record.events[0].second), "Unable to generate theory data: Unable to open " + fileName);
+}
+
+}
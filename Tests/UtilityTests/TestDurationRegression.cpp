@@ -0,0 +1,175 @@
+#include <sstream>
+#include <string>
+#include <vector>
+#include "xUnit++/xUnit++.h"
+#include "xUnit++/xUnitTestRunner.h"
+#include "DurationRegressionReporter.h"
+#include "TimingHistoryReader.h"
+#include "TimingHistoryReporter.h"
+#include "Helpers/TestFactory.h"
+
+using xUnitpp::Utilities::DurationRegressionReporter;
+using xUnitpp::Utilities::TimingHistoryReader;
+using xUnitpp::Tests::TestFactory;
+
+namespace
+{
+    namespace Filter
+    {
+        bool AllTests(const xUnitpp::ITestDetails &) { return true; }
+    }
+
+    const long long Millisecond = 1000000;
+
+    // keeps the events it is given, and the totals
+    class Recorder : public xUnitpp::IOutput
+    {
+    public:
+        Recorder()
+            : failed(0)
+        {
+        }
+
+        virtual void __stdcall ReportStart(const xUnitpp::ITestDetails &) override {}
+        virtual void __stdcall ReportEvent(const xUnitpp::ITestDetails &, const xUnitpp::ITestEvent &evt) override
+        {
+            events.push_back(std::make_pair(evt.GetIsFailure(), std::string(evt.GetToString())));
+        }
+        virtual void __stdcall ReportSkip(const xUnitpp::ITestDetails &, const char *) override {}
+        virtual void __stdcall ReportFinish(const xUnitpp::ITestDetails &, long long) override {}
+        virtual void __stdcall ReportAllTestsComplete(size_t, size_t, size_t failureCount, long long) override
+        {
+            failed = failureCount;
+        }
+
+        std::vector<std::pair<bool, std::string>> events;
+        size_t failed;
+    };
+
+    // a history of `runs` runs of `test`, taking 10ms give or take 0.1ms
+    std::string History(const std::shared_ptr<xUnitpp::xUnitTest> &test, int runs)
+    {
+        std::string history;
+
+        for (int run = 0; run != runs; ++run)
+        {
+            std::stringstream out;
+            xUnitpp::Utilities::TimingHistoryReporter reporter(out, nullptr, "builder", "", true);
+
+            reporter.ReportFinish(test->TestDetails(), 10 * Millisecond + (run % 3 - 1) * Millisecond / 10);
+            reporter.ReportAllTestsComplete(1, 0, 0, 0);
+
+            // only the first run writes the header
+            history += run == 0 ? out.str() : out.str().substr(xUnitpp::TimingHistory::HeaderSize);
+        }
+
+        return history;
+    }
+
+    Recorder Compare(const std::shared_ptr<xUnitpp::xUnitTest> &test, const std::string &history, const DurationRegressionReporter::Limits &limits, long long ns)
+    {
+        TimingHistoryReader baseline(history.data(), history.size());
+        Recorder recorder;
+
+        DurationRegressionReporter reporter(recorder, baseline, true, limits);
+        reporter.ReportStart(test->TestDetails());
+        reporter.ReportFinish(test->TestDetails(), ns);
+        reporter.ReportAllTestsComplete(1, 0, 0, ns);
+
+        return recorder;
+    }
+}
+
+SUITE("DurationRegression")
+{
+
+FACT("DurationRegression warns of a test taking more than the ratio times its mean")
+{
+    std::shared_ptr<xUnitpp::xUnitTest> test = TestFactory([]() {}).Name("Serializes").Suite("Timed");
+    auto history = History(test, 6);
+
+    DurationRegressionReporter::Limits limits;
+    limits.ratio = 2;
+
+    Assert.Empty(Compare(test, history, limits, 15 * Millisecond).events);
+
+    auto slow = Compare(test, history, limits, 25 * Millisecond);
+    Assert.Equal(1U, slow.events.size());
+    Assert.False(slow.events[0].first);
+    Assert.Contains(slow.events[0].second, "Took 25.000 ms");
+    Assert.Equal(0U, slow.failed);
+}
+
+FACT("DurationRegression flags a test far outside its usual spread by z-score")
+{
+    std::shared_ptr<xUnitpp::xUnitTest> test = TestFactory([]() {}).Name("Serializes").Suite("Timed");
+
+    DurationRegressionReporter::Limits limits;
+    limits.zScore = 3;
+
+    // 12ms is only 1.2 times the mean, but many deviations out
+    Assert.NotEmpty(Compare(test, History(test, 6), limits, 12 * Millisecond).events);
+
+    // too few runs to know the spread
+    Assert.Empty(Compare(test, History(test, 3), limits, 12 * Millisecond).events);
+}
+
+FACT("DurationRegression fails flagged tests in strict mode, and counts them")
+{
+    std::shared_ptr<xUnitpp::xUnitTest> test = TestFactory([]() {}).Name("Serializes").Suite("Timed");
+
+    DurationRegressionReporter::Limits limits;
+    limits.ratio = 2;
+    limits.strict = true;
+
+    auto slow = Compare(test, History(test, 6), limits, 25 * Millisecond);
+    Assert.Equal(1U, slow.events.size());
+    Assert.True(slow.events[0].first);
+    Assert.Equal(1U, slow.failed);
+}
+
+FACT("DurationRegression leaves unknown tests and small differences alone")
+{
+    std::shared_ptr<xUnitpp::xUnitTest> test = TestFactory([]() {}).Name("Serializes").Suite("Timed");
+    std::shared_ptr<xUnitpp::xUnitTest> other = TestFactory([]() {}).Name("New").Suite("Timed");
+    auto history = History(test, 6);
+
+    DurationRegressionReporter::Limits limits;
+    limits.ratio = 2;
+    limits.minimumNs = 20 * Millisecond;
+
+    Assert.Empty(Compare(test, history, limits, 25 * Millisecond).events);
+    Assert.Empty(Compare(other, history, limits, 100 * Millisecond).events);
+}
+
+FACT("DurationRegression leaves failing tests alone")
+{
+    std::vector<std::shared_ptr<xUnitpp::xUnitTest>> tests;
+    tests.push_back(TestFactory([]() { xUnitpp::Assert.Fail() << "broken"; }).Name("Fails").Suite("Timed"));
+
+    // any time at all is infinitely slower than this
+    std::stringstream out;
+
+    {
+        xUnitpp::Utilities::TimingHistoryReporter writer(out, nullptr, "builder", "", true);
+        writer.ReportFinish(tests[0]->TestDetails(), 0);
+        writer.ReportAllTestsComplete(1, 0, 0, 0);
+    }
+
+    auto history = out.str();
+    TimingHistoryReader baseline(history.data(), history.size());
+
+    DurationRegressionReporter::Limits limits;
+    limits.ratio = 2;
+    limits.minimumNs = 0;
+
+    Recorder recorder;
+    DurationRegressionReporter reporter(recorder, baseline, true, limits);
+    xUnitpp::RunTests(reporter, &Filter::AllTests, tests, xUnitpp::Time::Duration::zero(), 1);
+
+    Assert.Equal(1U, recorder.events.size());
+    Assert.Contains(recorder.events[0].second, "broken");
+    Assert.Equal(1U, recorder.failed);
+}
+
+}
@@ -0,0 +1,157 @@
+#include <algorithm>
+#include <future>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "xUnit++/xUnit++.h"
+#include "xUnit++/xUnitTestRunner.h"
+#include "FanOutReporter.h"
+#include "Helpers/TestFactory.h"
+
+using xUnitpp::Utilities::FanOutReporter;
+using xUnitpp::Tests::TestFactory;
+
+namespace
+{
+    namespace Filter
+    {
+        bool AllTests(const xUnitpp::ITestDetails &) { return true; }
+    }
+
+    // writes down everything it is told, as one line per report
+    class Recorder : public xUnitpp::IOutput
+    {
+    public:
+        virtual void __stdcall ReportStart(const xUnitpp::ITestDetails &testDetails) override
+        {
+            lines.push_back(std::string("start ") + testDetails.GetSuite() + "." + testDetails.GetFullName());
+        }
+
+        virtual void __stdcall ReportEvent(const xUnitpp::ITestDetails &testDetails, const xUnitpp::ITestEvent &evt) override
+        {
+            lines.push_back(std::string("event ") + testDetails.GetFullName() + " " + evt.GetToString());
+        }
+
+        virtual void __stdcall ReportSkip(const xUnitpp::ITestDetails &testDetails, const char *reason) override
+        {
+            lines.push_back(std::string("skip ") + testDetails.GetFullName() + " " + reason);
+        }
+
+        virtual void __stdcall ReportFinish(const xUnitpp::ITestDetails &testDetails, long long) override
+        {
+            lines.push_back(std::string("finish ") + testDetails.GetFullName());
+        }
+
+        virtual void __stdcall ReportAllTestsComplete(size_t testCount, size_t, size_t failed, long long) override
+        {
+            lines.push_back("complete " + std::to_string(testCount) + " " + std::to_string(failed));
+        }
+
+        std::vector<std::string> lines;
+    };
+
+    // throws on the first test to finish
+    class Thrower : public Recorder
+    {
+    public:
+        virtual void __stdcall ReportFinish(const xUnitpp::ITestDetails &, long long) override
+        {
+            throw std::runtime_error("disk full");
+        }
+    };
+
+    // won't take its first report until it is let go
+    class Blocker : public Recorder
+    {
+    public:
+        virtual void __stdcall ReportStart(const xUnitpp::ITestDetails &testDetails) override
+        {
+            release.get_future().wait();
+            Recorder::ReportStart(testDetails);
+        }
+
+        std::promise<void> release;
+    };
+
+    std::vector<std::shared_ptr<xUnitpp::xUnitTest>> Tests()
+    {
+        std::vector<std::shared_ptr<xUnitpp::xUnitTest>> tests;
+        tests.push_back(TestFactory([]() {}).Name("First").Suite("FanOut"));
+        tests.push_back(TestFactory([]() { xUnitpp::Assert.Fail() << "second"; }).Name("Second").Suite("FanOut"));
+        return tests;
+    }
+}
+
+SUITE("FanOutReporter")
+{
+
+FACT("FanOutReporter gives every reporter every report, in order")
+{
+    Recorder direct;
+    xUnitpp::RunTests(direct, &Filter::AllTests, Tests(), xUnitpp::Time::Duration::zero(), 1);
+
+    Recorder first;
+    Recorder second;
+
+    {
+        FanOutReporter fanOut(true);
+        fanOut.Add("first", first);
+        fanOut.Add("second", second);
+
+        // the tests, and so their details, are gone before the reporters see them
+        xUnitpp::RunTests(fanOut, &Filter::AllTests, Tests(), xUnitpp::Time::Duration::zero(), 1);
+
+        Assert.Empty(fanOut.Failures());
+    }
+
+    // both reporters saw the same order, though another run of the same tests can have its own
+    Assert.Equal(first.lines, second.lines);
+
+    std::sort(direct.lines.begin(), direct.lines.end());
+    std::sort(first.lines.begin(), first.lines.end());
+    Assert.Equal(direct.lines, first.lines);
+}
+
+FACT("FanOutReporter never waits on a reporter until the run is complete")
+{
+    Blocker slow;
+    Recorder fast;
+
+    FanOutReporter fanOut(true);
+    fanOut.Add("slow", slow);
+    fanOut.Add("fast", fast);
+
+    auto test = Tests()[0];
+
+    // returns while the slow reporter is still stuck on the first report
+    fanOut.ReportStart(test->TestDetails());
+    fanOut.ReportFinish(test->TestDetails(), 0);
+
+    slow.release.set_value();
+    fanOut.ReportAllTestsComplete(1, 0, 0, 0);
+
+    Assert.Equal(3U, slow.lines.size());
+    Assert.Equal(fast.lines, slow.lines);
+}
+
+FACT("FanOutReporter stops a reporter that throws, and no other")
+{
+    Thrower broken;
+    Recorder working;
+
+    FanOutReporter fanOut(true);
+    fanOut.Add("broken", broken);
+    fanOut.Add("working", working);
+
+    xUnitpp::RunTests(fanOut, &Filter::AllTests, Tests(), xUnitpp::Time::Duration::zero(), 1);
+
+    auto failures = fanOut.Failures();
+    Assert.Equal(1U, failures.size());
+    Assert.Equal("broken", failures[0].first);
+    Assert.Equal("disk full", failures[0].second);
+
+    Assert.Equal("complete 2 1", working.lines.back());
+    Assert.DoesNotContain(broken.lines, "complete 2 1");
+}
+
+}
@@ -0,0 +1,118 @@
+#include <sstream>
+#include <string>
+#include <vector>
+#include "xUnit++/xUnit++.h"
+#include "xUnit++/xUnitTestRunner.h"
+#include "JsonReporter.h"
+#include "Helpers/TestFactory.h"
+
+using xUnitpp::Utilities::JsonReporter;
+using xUnitpp::Tests::TestFactory;
+
+namespace
+{
+    namespace Filter
+    {
+        bool AllTests(const xUnitpp::ITestDetails &) { return true; }
+    }
+
+    std::vector<std::string> Lines(const std::string &text)
+    {
+        std::vector<std::string> lines;
+        std::istringstream in(text);
+
+        for (std::string line; std::getline(in, line); )
+        {
+            lines.push_back(line);
+        }
+
+        return lines;
+    }
+
+    std::string Type(const std::string &line)
+    {
+        auto begin = line.find("\"type\":\"") + 8;
+        return line.substr(begin, line.find('"', begin) - begin);
+    }
+}
+
+SUITE("JsonReporter")
+{
+
+FACT("JsonReporter writes one object per line, in the order things happen")
+{
+    std::vector<std::shared_ptr<xUnitpp::xUnitTest>> tests;
+    tests.push_back(TestFactory([]() { Assert.Fail() << "nope"; }).Name("Fails"));
+
+    std::stringstream out;
+
+    {
+        JsonReporter reporter(out, true);
+        xUnitpp::RunTests(reporter, &Filter::AllTests, tests, xUnitpp::Time::Duration::zero(), 0);
+    }
+
+    auto lines = Lines(out.str());
+
+    Assert.Equal(4U, lines.size());
+    Assert.Equal("start", Type(lines[0]));
+    Assert.Equal("event", Type(lines[1]));
+    Assert.Equal("finish", Type(lines[2]));
+    Assert.Equal("complete", Type(lines[3]));
+
+    for (auto &line : lines)
+    {
+        Assert.Equal('{', line.front());
+        Assert.Equal('}', line.back());
+    }
+
+    Assert.Contains(lines[1], "\"failure\":true");
+    Assert.Contains(lines[3], "\"tests\":1,\"failures\":1,\"skipped\":0");
+}
+
+FACT("JsonReporter escapes everything it writes")
+{
+    std::shared_ptr<xUnitpp::xUnitTest> test = TestFactory([]() {}).Name("say \"hi\"").Suite("back\\slash");
+
+    std::stringstream out;
+
+    {
+        JsonReporter reporter(out, true);
+        reporter.ReportSkip(test->TestDetails(), "first line\nsecond\tline\x01");
+    }
+
+    auto lines = Lines(out.str());
+
+    Assert.Equal(1U, lines.size());
+    Assert.Contains(lines[0], "\"suite\":\"back\\\\slash\"");
+    Assert.Contains(lines[0], "\"name\":\"say \\\"hi\\\"\"");
+    Assert.Contains(lines[0], "\"reason\":\"first line\\nsecond\\tline\\u0001\"");
+}
+
+FACT("JsonReporter writes stable ids as hex strings, only when the library has them")
+{
+    std::shared_ptr<xUnitpp::xUnitTest> test = TestFactory([]() {}).Name("Stable");
+    auto &details = test->TestDetails();
+
+    std::stringstream hex;
+    hex << std::hex;
+    hex.width(16);
+    hex.fill('0');
+    hex << details.GetStableId();
+
+    std::stringstream with;
+    std::stringstream without;
+
+    {
+        JsonReporter withReporter(with, true);
+        JsonReporter withoutReporter(without, false);
+
+        withReporter.ReportFinish(details, 5);
+        withoutReporter.ReportFinish(details, 5);
+    }
+
+    Assert.Contains(with.str(), "\"stableId\":\"" + hex.str() + "\"");
+    Assert.DoesNotContain(without.str(), "stableId");
+    Assert.Contains(without.str(), "\"ns\":5");
+}
+
+}
@@ -0,0 +1,150 @@
+#include <iterator>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <vector>
+#include "xUnit++/TestCollection.h"
+#include "xUnit++/TestRecord.h"
+#include "xUnit++/xUnit++.h"
+#include "ManifestReader.h"
+
+using xUnitpp::Utilities::ManifestReader;
+
+SUITE("ManifestReader")
+{
+
+void NothingToDo()
+{
+}
+
+const std::string &ManifestSuite()
+{
+    static std::string suite = "Manifested";
+    return suite;
+}
+
+xUnitpp::AttributeCollection ManifestAttributes()
+{
+    xUnitpp::AttributeCollection attributes;
+    attributes.insert(std::make_pair("Speed", "Fast"));
+    attributes.insert(std::make_pair("Size", "Small"));
+    attributes.insert(std::make_pair("Size", "Tiny"));
+    attributes.sort();
+    return attributes;
+}
+
+xUnitpp::AttributeCollection NoAttributes()
+{
+    return xUnitpp::AttributeCollection();
+}
+
+const xUnitpp::TestRecord firstRecord = { "First", "", "Manifest.cpp", 10, -1, &ManifestSuite, &ManifestAttributes, &NothingToDo, nullptr };
+const xUnitpp::TestRecord secondRecord = { "Second", "", "Manifest.cpp", 20, -1, &ManifestSuite, &NoAttributes, &NothingToDo, nullptr };
+
+const xUnitpp::TestRecord *const records[] = { &firstRecord, &secondRecord };
+
+void TakesRow(int)
+{
+}
+
+int builtRows = 0;
+
+std::vector<std::tuple<int>> BuildRows()
+{
+    ++builtRows;
+    return std::vector<std::tuple<int>>(4, std::make_tuple(0));
+}
+
+std::shared_ptr<const xUnitpp::TheorySource> InlineRows(const xUnitpp::TestRecord &record)
+{
+    static const std::tuple<int> rows[] = { std::make_tuple(1), std::make_tuple(2), std::make_tuple(3) };
+    return xUnitpp::TestCollection::RecordedTheory(record, &TakesRow, xUnitpp::TheoryData(rows));
+}
+
+std::shared_ptr<const xUnitpp::TheorySource> BuiltRows(const xUnitpp::TestRecord &record)
+{
+    return xUnitpp::TestCollection::RecordedTheory(record, &TakesRow, &BuildRows);
+}
+
+const xUnitpp::TestRecord inlineRecord = { "Inline", "(int x)", "Manifest.cpp", 30, -1, &ManifestSuite, &NoAttributes, nullptr, &InlineRows };
+const xUnitpp::TestRecord builtRecord = { "Built", "(int x)", "Manifest.cpp", 40, -1, &ManifestSuite, &NoAttributes, nullptr, &BuiltRows };
+
+const xUnitpp::TestRecord *const theoryRecords[] = { &firstRecord, &inlineRecord, &builtRecord };
+
+struct ManifestFixture
+{
+    ManifestFixture()
+        : collection(std::begin(records), std::end(records))
+        , manifest(collection.Manifest())
+    {
+    }
+
+    xUnitpp::TestCollection collection;
+    const std::vector<char> &manifest;
+};
+
+FACT_FIXTURE("A manifest reads back every recorded test", ManifestFixture)
+{
+    Assert.True(ManifestReader::Readable(manifest.data(), manifest.size()));
+
+    ManifestReader tests(manifest.data(), manifest.size());
+    auto &found = collection.Records();
+
+    Assert.Equal(found.size(), tests.size());
+
+    for (size_t i = 0; i != tests.size(); ++i)
+    {
+        auto test = tests[i];
+
+        Assert.Equal(found[i].GetId(), test.GetId());
+        Assert.Equal(std::string(found[i].GetName()), std::string(test.GetName()));
+        Assert.Equal(std::string(found[i].GetSuite()), std::string(test.GetSuite()));
+        Assert.Equal(std::string(found[i].GetFile()), std::string(test.GetFile()));
+        Assert.Equal(found[i].GetLine(), test.GetLine());
+        Assert.Equal(found[i].GetAttributeCount(), test.GetAttributeCount());
+        Assert.Equal(found[i].GetStableId(), test.GetStableId());
+    }
+
+    Assert.NotEqual(tests[0].GetStableId(), tests[1].GetStableId());
+}
+
+FACT_FIXTURE("A manifest finds every value of an attribute", ManifestFixture)
+{
+    ManifestReader tests(manifest.data(), manifest.size());
+    auto test = tests[0];
+
+    size_t begin, end;
+    test.FindAttributeKey("Size", begin, end);
+
+    Assert.Equal(2U, end - begin);
+    Assert.Equal("Small", std::string(test.GetAttributeValue(begin)));
+    Assert.Equal("Tiny", std::string(test.GetAttributeValue(begin + 1)));
+
+    test.FindAttributeKey("Colour", begin, end);
+    Assert.Equal(begin, end);
+}
+
+FACT("A manifest counts a theory's rows only when that needs no data to be built")
+{
+    xUnitpp::TestCollection collection(std::begin(theoryRecords), std::end(theoryRecords));
+    auto &manifest = collection.Manifest();
+
+    ManifestReader tests(manifest.data(), manifest.size());
+
+    Assert.Equal(1, tests[0].GetInstanceCount());
+    Assert.Equal(3, tests[1].GetInstanceCount());
+    Assert.Equal(xUnitpp::TheorySource::UnknownCount, tests[2].GetInstanceCount());
+    Assert.Equal(0, builtRows);
+}
+
+FACT_FIXTURE("A damaged manifest is not readable", ManifestFixture)
+{
+    Assert.False(ManifestReader::Readable(nullptr, 0));
+    Assert.False(ManifestReader::Readable(manifest.data(), manifest.size() - 1));
+
+    auto damaged = manifest;
+    damaged[0] = 'y';
+    Assert.False(ManifestReader::Readable(damaged.data(), damaged.size()));
+}
+
+}
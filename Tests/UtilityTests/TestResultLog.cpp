@@ -0,0 +1,161 @@
+#include <sstream>
+#include <string>
+#include <vector>
+#include "xUnit++/xUnit++.h"
+#include "xUnit++/xUnitTestRunner.h"
+#include "ResultLogReader.h"
+#include "ResultLogReporter.h"
+#include "XmlReporter.h"
+#include "tinyxml2.h"
+#include "Helpers/TestFactory.h"
+
+using xUnitpp::Utilities::ResultLogReader;
+using xUnitpp::Utilities::ResultLogReporter;
+using xUnitpp::Tests::TestFactory;
+using xUnitpp::Assert;
+
+namespace
+{
+    namespace Filter
+    {
+        bool AllTests(const xUnitpp::ITestDetails &) { return true; }
+    }
+
+    // a passing test, a failing one, and a skipped one
+    std::string LoggedRun()
+    {
+        std::vector<std::shared_ptr<xUnitpp::xUnitTest>> tests;
+        tests.push_back(TestFactory([]() {}).Name("Passes").Suite("Logged"));
+        tests.push_back(TestFactory([]() { Assert.Equal(1, 2) << "one <isn't> two"; }).Name("Fails").Suite("Logged"));
+
+        xUnitpp::AttributeCollection skip;
+        skip.insert(std::make_pair("Skip", "Not today."));
+        tests.push_back(TestFactory([]() {}).Name("Skipped").Suite("Logged").Attributes(skip));
+
+        std::stringstream out;
+
+        {
+            ResultLogReporter reporter(out, true);
+            xUnitpp::RunTests(reporter, &Filter::AllTests, tests, xUnitpp::Time::Duration::zero(), 0);
+        }
+
+        return out.str();
+    }
+
+    const ResultLogReader::Result *Find(const std::vector<ResultLogReader::Result> &results, const std::string &name)
+    {
+        for (auto &result : results)
+        {
+            if (name == result.name)
+            {
+                return &result;
+            }
+        }
+
+        return nullptr;
+    }
+}
+
+SUITE("ResultLog")
+{
+
+FACT("ResultLog reads back what was reported")
+{
+    auto log = LoggedRun();
+
+    Assert.True(ResultLogReader::Readable(log.data(), log.size()));
+
+    ResultLogReader reader(log.data(), log.size());
+    Assert.True(reader.IsComplete());
+    Assert.True(reader.HasStableIds());
+    Assert.Equal(log.size(), reader.size());
+
+    auto results = reader.Results();
+    Assert.Equal(3U, results.size());
+
+    auto passes = Find(results, "Passes");
+    auto fails = Find(results, "Fails");
+    auto skipped = Find(results, "Skipped");
+
+    Assert.NotNull(passes);
+    Assert.NotNull(fails);
+    Assert.NotNull(skipped);
+
+    Assert.Equal("Logged", std::string(passes->suite));
+    Assert.True(passes->finished && !passes->failed && !passes->skipped);
+    Assert.True(fails->finished && fails->failed);
+    Assert.True(skipped->skipped && !skipped->failed);
+    Assert.NotEqual(0ULL, passes->stableId);
+}
+
+FACT("ResultLog converts to the same xml the run would have written")
+{
+    auto log = LoggedRun();
+    ResultLogReader reader(log.data(), log.size());
+
+    std::stringstream out;
+
+    {
+        xUnitpp::Utilities::XmlReporter reporter(out, reader.HasStableIds());
+        reader.Replay(reporter);
+    }
+
+    tinyxml2::XMLDocument doc;
+    Assert.Equal(tinyxml2::XMLError::XML_SUCCESS, doc.Parse(out.str().c_str()));
+
+    auto suite = doc.FirstChildElement("testsuites")->FirstChildElement("testsuite");
+    Assert.Equal("Logged", suite->Attribute("name"));
+    Assert.Equal(3, suite->IntAttribute("tests"));
+    Assert.Equal(1, suite->IntAttribute("failures"));
+    Assert.Equal(1, suite->IntAttribute("skipped"));
+    Assert.Contains(out.str(), "Not today.");
+}
+
+FACT("ResultLog reads a log cut short up to its last whole record")
+{
+    auto log = LoggedRun();
+    auto whole = ResultLogReader(log.data(), log.size()).Results();
+
+    // cutting anywhere leaves a log that still reads, and never holds more than the whole one
+    for (size_t cut = xUnitpp::ResultLog::HeaderSize; cut < log.size(); cut += 7)
+    {
+        ResultLogReader reader(log.data(), cut);
+
+        Assert.False(reader.IsComplete());
+        Assert.True(reader.size() <= cut);
+        Assert.True(reader.Results().size() <= whole.size());
+
+        // replaying still closes the run
+        std::stringstream out;
+
+        {
+            xUnitpp::Utilities::XmlReporter reporter(out, reader.HasStableIds());
+            reader.Replay(reporter);
+        }
+
+        Assert.Equal(tinyxml2::XMLError::XML_SUCCESS, tinyxml2::XMLDocument().Parse(out.str().c_str()));
+    }
+}
+
+FACT("ResultLog stops at the first record that fails its CRC")
+{
+    auto log = LoggedRun();
+    auto whole = ResultLogReader(log.data(), log.size());
+
+    // the last byte is the Complete record's CRC
+    log.back() ^= 0x5a;
+
+    ResultLogReader reader(log.data(), log.size());
+    Assert.False(reader.IsComplete());
+    Assert.True(reader.size() < whole.size());
+    Assert.Equal(whole.Results().size(), reader.Results().size());
+}
+
+FACT("ResultLog is not readable without its header")
+{
+    std::string notLog = "<?xml version=\"1.0\"?>";
+    Assert.False(ResultLogReader::Readable(notLog.data(), notLog.size()));
+    Assert.False(ResultLogReader::Readable(nullptr, 0));
+}
+
+}
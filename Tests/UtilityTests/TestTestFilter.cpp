@@ -0,0 +1,124 @@
+#include <memory>
+#include <string>
+#include <vector>
+#include "xUnit++/xUnit++.h"
+#include "xUnit++/xUnitTest.h"
+#include "Helpers/TestFactory.h"
+#include "TestFilter.h"
+
+using xUnitpp::Utilities::TestFilter;
+using xUnitpp::Utilities::TestIndex;
+using xUnitpp::Tests::TestFactory;
+
+SUITE("TestFilter")
+{
+
+xUnitpp::AttributeCollection Attributes(const std::string &key, const std::string &value)
+{
+    xUnitpp::AttributeCollection attributes;
+    attributes.insert(std::make_pair(key, value));
+    attributes.sort();
+    return attributes;
+}
+
+struct FilterFixture
+{
+    FilterFixture()
+    {
+        auto add = [&](const std::string &suite, const std::string &name, const std::string &file, const xUnitpp::AttributeCollection &attributes)
+            {
+                tests.push_back(TestFactory([]() {}).Suite(suite).Name(name).TestFile(file).Attributes(attributes));
+                index.Add(tests.back()->TestDetails());
+            };
+
+        add("Math", "Adds", "Math.cpp", Attributes("Speed", "Fast"));                  // 0
+        add("Math", "Divides by zero", "Math.cpp", Attributes("Speed", "Slow"));       // 1
+        add("Strings", "Concatenates", "Strings.cpp", Attributes("Owner", "Ann"));     // 2
+        add("Strings", "Splits", "Strings.cpp", xUnitpp::AttributeCollection());       // 3
+    }
+
+    std::vector<size_t> Select(const std::string &expression)
+    {
+        // a filter that can't be parsed "selects" a test that doesn't exist, so it never passes
+        TestFilter filter;
+        return filter.Parse(expression).empty() ? filter.Select(index) : std::vector<size_t>(1, (size_t)-1);
+    }
+
+    std::vector<std::shared_ptr<xUnitpp::xUnitTest>> tests;
+    TestIndex index;
+};
+
+FACT_FIXTURE("An empty filter selects every test", FilterFixture)
+{
+    TestFilter filter;
+
+    Assert.Equal(std::vector<size_t>({ 0, 1, 2, 3 }), filter.Select(index));
+}
+
+FACT_FIXTURE("Filters match suites, names and files as case insensitive patterns", FilterFixture)
+{
+    Assert.Equal(std::vector<size_t>({ 0, 1 }), Select("suite:math"));
+    Assert.Equal(std::vector<size_t>({ 2, 3 }), Select("name:\"^(C|S)\""));
+    Assert.Equal(std::vector<size_t>({ 1 }), Select("name:\"by zero\""));
+    Assert.Equal(std::vector<size_t>({ 2, 3 }), Select("file:strings"));
+}
+
+FACT_FIXTURE("Filters match attributes by key, or by key and value", FilterFixture)
+{
+    Assert.Equal(std::vector<size_t>({ 0, 1 }), Select("attr:Speed"));
+    Assert.Equal(std::vector<size_t>({ 1 }), Select("attr:Speed=Slow"));
+    Assert.Equal(std::vector<size_t>(), Select("attr:Speed=slow"));
+    Assert.Equal(std::vector<size_t>(), Select("attr:Colour"));
+}
+
+FACT_FIXTURE("Filters combine matches with and, or and not", FilterFixture)
+{
+    Assert.Equal(std::vector<size_t>({ 0 }), Select("suite:Math and not attr:Speed=Slow"));
+    Assert.Equal(std::vector<size_t>({ 1, 2 }), Select("attr:Speed=Slow || attr:Owner"));
+    Assert.Equal(std::vector<size_t>({ 3 }), Select("!(attr:Speed or attr:Owner)"));
+
+    // and binds tighter than or
+    Assert.Equal(std::vector<size_t>({ 0, 3 }), Select("suite:Math && name:Adds || name:Splits"));
+    Assert.Equal(std::vector<size_t>({ 0 }), Select("suite:Math && (name:Adds || name:Splits)"));
+}
+
+FACT_FIXTURE("Every part of a filter must match", FilterFixture)
+{
+    TestFilter filter;
+
+    Assert.Equal("", filter.RequireAnySuite(std::vector<std::string>(1, "Strings")));
+    Assert.Equal("", filter.Parse("not name:Splits"));
+
+    Assert.Equal(std::vector<size_t>({ 2 }), filter.Select(index));
+}
+
+FACT_FIXTURE("Excluded attributes only exclude tests with all of them", FilterFixture)
+{
+    std::multimap<std::string, std::string> excluded;
+    excluded.insert(std::make_pair("Speed", "Slow"));
+
+    TestFilter filter;
+    filter.ExcludeAllAttributes(excluded);
+
+    Assert.Equal(std::vector<size_t>({ 0, 2, 3 }), filter.Select(index));
+
+    excluded.insert(std::make_pair("Owner", ""));
+
+    TestFilter both;
+    both.ExcludeAllAttributes(excluded);
+
+    Assert.Equal(std::vector<size_t>({ 0, 1, 2, 3 }), both.Select(index));
+}
+
+FACT("Filters explain what they could not understand")
+{
+    const char *broken[] = { "", "suite:", "colour:red", "name:Adds and", "(suite:Math", "name:\"Adds", "name:[", "suite:Math name:Adds" };
+
+    for (auto expression : broken)
+    {
+        TestFilter filter;
+        Assert.NotEqual("", filter.Parse(expression), LI) << expression;
+    }
+}
+
+}
@@ -0,0 +1,151 @@
+#include <sstream>
+#include <string>
+#include <vector>
+#include "xUnit++/xUnit++.h"
+#include "xUnit++/xUnitTestRunner.h"
+#include "TimingHistoryReader.h"
+#include "TimingHistoryReporter.h"
+#include "Helpers/TestFactory.h"
+
+using xUnitpp::Assert;
+using xUnitpp::Utilities::TimingHistoryReader;
+using xUnitpp::Utilities::TimingHistoryReporter;
+using xUnitpp::Tests::TestFactory;
+
+namespace
+{
+    namespace Filter
+    {
+        bool AllTests(const xUnitpp::ITestDetails &) { return true; }
+    }
+
+    std::vector<std::shared_ptr<xUnitpp::xUnitTest>> Tests()
+    {
+        std::vector<std::shared_ptr<xUnitpp::xUnitTest>> tests;
+        tests.push_back(TestFactory([]() {}).Name("Passes").Suite("Timed"));
+        tests.push_back(TestFactory([]() { Assert.Fail() << "too slow"; }).Name("Fails").Suite("Timed"));
+
+        xUnitpp::AttributeCollection skip;
+        skip.insert(std::make_pair("Skip", "Not today."));
+        tests.push_back(TestFactory([]() {}).Name("Skipped").Suite("Timed").Attributes(skip));
+
+        return tests;
+    }
+
+    // adds a run of Tests to `history`, which holds what `reader` has read of it, if anything
+    void AddRun(std::string &history, const TimingHistoryReader *reader, const std::string &commit)
+    {
+        std::stringstream out;
+
+        {
+            TimingHistoryReporter reporter(out, reader, "builder", commit, true);
+            xUnitpp::RunTests(reporter, &Filter::AllTests, Tests(), xUnitpp::Time::Duration::zero(), 0);
+        }
+
+        history += out.str();
+    }
+
+    const TimingHistoryReader::Test *FindTest(const TimingHistoryReader &reader, const std::string &name)
+    {
+        for (auto &test : reader.Tests())
+        {
+            if (name == test.second.name)
+            {
+                return &test.second;
+            }
+        }
+
+        return nullptr;
+    }
+}
+
+SUITE("TimingHistory")
+{
+
+FACT("TimingHistory keeps each test's outcome and time, keyed by its stable id")
+{
+    std::string history;
+    AddRun(history, nullptr, "abc123");
+
+    Assert.True(TimingHistoryReader::Readable(history.data(), history.size()));
+
+    TimingHistoryReader reader(history.data(), history.size());
+    Assert.Equal(history.size(), reader.size());
+    Assert.Equal(1U, reader.Runs().size());
+    Assert.Equal("builder", reader.Runs()[0].host);
+    Assert.Equal("abc123", reader.Runs()[0].commit);
+    Assert.Equal(3U, reader.Tests().size());
+
+    auto passes = FindTest(reader, "Passes");
+    Assert.NotNull(passes);
+    Assert.Equal("Timed", passes->suite);
+    Assert.Equal(1U, passes->samples.size());
+    Assert.Equal(xUnitpp::TimingHistory::Passed, passes->samples[0].outcome);
+
+    Assert.Equal(xUnitpp::TimingHistory::Failed, FindTest(reader, "Fails")->samples[0].outcome);
+    Assert.Equal(xUnitpp::TimingHistory::Skipped, FindTest(reader, "Skipped")->samples[0].outcome);
+}
+
+FACT("TimingHistory names a test only the first time it sees it")
+{
+    std::string history;
+    AddRun(history, nullptr, "first");
+
+    auto firstSize = history.size();
+
+    {
+        TimingHistoryReader reader(history.data(), history.size());
+        AddRun(history, &reader, "second");
+    }
+
+    // a run of tests the history already knows is just its samples
+    Assert.True(history.size() - firstSize < firstSize);
+
+    TimingHistoryReader reader(history.data(), history.size());
+    Assert.Equal(2U, reader.Runs().size());
+    Assert.Equal(3U, reader.Tests().size());
+
+    auto passes = FindTest(reader, "Passes");
+    Assert.Equal(2U, passes->samples.size());
+    Assert.Equal("second", reader.Runs()[passes->samples[1].run].commit);
+}
+
+FACT("TimingHistory reads a history cut short up to its last whole run")
+{
+    std::string history;
+    AddRun(history, nullptr, "first");
+
+    auto firstSize = history.size();
+
+    {
+        TimingHistoryReader reader(history.data(), history.size());
+        AddRun(history, &reader, "second");
+    }
+
+    history.resize(history.size() - 1);
+
+    TimingHistoryReader reader(history.data(), history.size());
+    Assert.Equal(firstSize, reader.size());
+    Assert.Equal(1U, reader.Runs().size());
+    Assert.Equal(1U, FindTest(reader, "Passes")->samples.size());
+}
+
+FACT("TimingHistory reads every run of shards which each found the history empty")
+{
+    std::string history;
+    AddRun(history, nullptr, "first");
+    AddRun(history, nullptr, "second");
+
+    {
+        TimingHistoryReader reader(history.data(), history.size());
+        AddRun(history, &reader, "third");
+    }
+
+    TimingHistoryReader reader(history.data(), history.size());
+    Assert.Equal(history.size(), reader.size());
+    Assert.Equal(3U, reader.Runs().size());
+    Assert.Equal("third", reader.Runs()[2].commit);
+    Assert.Equal(3U, FindTest(reader, "Passes")->samples.size());
+}
+
+}
@@ -0,0 +1,180 @@
+#include <sstream>
+#include <string>
+#include <vector>
+#include "xUnit++/xUnit++.h"
+#include "xUnit++/xUnitTestRunner.h"
+#include "XmlMerge.h"
+#include "XmlReporter.h"
+#include "tinyxml2.h"
+#include "Helpers/TestFactory.h"
+
+using xUnitpp::Utilities::XmlMerge;
+using xUnitpp::Tests::TestFactory;
+
+namespace
+{
+    namespace Filter
+    {
+        bool AllTests(const xUnitpp::ITestDetails &) { return true; }
+    }
+
+    // the xml of one shard's run
+    std::string Shard(const std::vector<std::shared_ptr<xUnitpp::xUnitTest>> &tests)
+    {
+        std::stringstream out;
+
+        {
+            xUnitpp::Utilities::XmlReporter reporter(out, true);
+            xUnitpp::RunTests(reporter, &Filter::AllTests, tests, xUnitpp::Time::Duration::zero(), 1);
+        }
+
+        return out.str();
+    }
+
+    std::string Merged(const XmlMerge &merge)
+    {
+        std::stringstream out;
+        merge.Write(out);
+        return out.str();
+    }
+
+    const tinyxml2::XMLElement *FindSuite(const tinyxml2::XMLDocument &doc, const char *name)
+    {
+        for (auto suite = doc.FirstChildElement("testsuites")->FirstChildElement("testsuite"); suite != nullptr; suite = suite->NextSiblingElement("testsuite"))
+        {
+            if (std::string(suite->Attribute("name")) == name)
+            {
+                return suite;
+            }
+        }
+
+        return nullptr;
+    }
+}
+
+SUITE("XmlMerge")
+{
+
+FACT("XmlMerge combines the suites of every shard and counts them again")
+{
+    std::vector<std::shared_ptr<xUnitpp::xUnitTest>> first;
+    first.push_back(TestFactory([]() {}).Name("Passes").Suite("Shared"));
+    first.push_back(TestFactory([]() {}).Name("Alone").Suite("First"));
+
+    std::vector<std::shared_ptr<xUnitpp::xUnitTest>> second;
+    second.push_back(TestFactory([]() { xUnitpp::Assert.Fail() << "broken"; }).Name("Fails").Suite("Shared"));
+
+    xUnitpp::AttributeCollection skip;
+    skip.insert(std::make_pair("Skip", "Not now."));
+    second.push_back(TestFactory([]() {}).Name("Skipped").Suite("Shared").Attributes(skip));
+
+    std::vector<std::string> shards;
+    shards.push_back(Shard(first));
+    shards.push_back(Shard(second));
+
+    XmlMerge merge;
+    Assert.Equal("", merge.ReadDocuments(shards, 2));
+    Assert.Equal(4U, merge.Tests());
+    Assert.Equal(0U, merge.Retried());
+
+    tinyxml2::XMLDocument doc;
+    Assert.Equal(tinyxml2::XMLError::XML_SUCCESS, doc.Parse(Merged(merge).c_str()));
+    Assert.Equal(4, doc.FirstChildElement("testsuites")->IntAttribute("tests"));
+    Assert.Equal(1, doc.FirstChildElement("testsuites")->IntAttribute("failures"));
+
+    auto shared = FindSuite(doc, "Shared");
+    Assert.NotNull(shared);
+    Assert.Equal(3, shared->IntAttribute("tests"));
+    Assert.Equal(1, shared->IntAttribute("failures"));
+    Assert.Equal(1, shared->IntAttribute("skipped"));
+    Assert.NotNull(FindSuite(doc, "First"));
+    Assert.Contains(Merged(merge), "Not now.");
+    Assert.Contains(Merged(merge), "broken");
+}
+
+FACT("XmlMerge keeps only the last results of a retried test")
+{
+    std::vector<std::shared_ptr<xUnitpp::xUnitTest>> failed;
+    failed.push_back(TestFactory([]() { xUnitpp::Assert.Fail() << "flaky"; }).Name("Flaky").Suite("Retried"));
+    failed.push_back(TestFactory([]() {}).Name("Steady").Suite("Retried"));
+
+    std::vector<std::shared_ptr<xUnitpp::xUnitTest>> retry;
+    retry.push_back(TestFactory([]() {}).Name("Flaky").Suite("Retried"));
+
+    std::vector<std::string> shards;
+    shards.push_back(Shard(failed));
+    shards.push_back(Shard(retry));
+
+    XmlMerge merge;
+    Assert.Equal("", merge.ReadDocuments(shards, 2));
+    Assert.Equal(2U, merge.Tests());
+    Assert.Equal(1U, merge.Retried());
+
+    tinyxml2::XMLDocument doc;
+    Assert.Equal(tinyxml2::XMLError::XML_SUCCESS, doc.Parse(Merged(merge).c_str()));
+    Assert.Equal(0, doc.FirstChildElement("testsuites")->IntAttribute("failures"));
+    Assert.Equal(2, FindSuite(doc, "Retried")->IntAttribute("tests"));
+    Assert.DoesNotContain(Merged(merge), "flaky");
+}
+
+FACT("XmlMerge keeps namesakes from different shards apart by their stable ids")
+{
+    std::vector<std::string> shards;
+    shards.push_back(
+        "<testsuites tests=\"1\" failures=\"0\" time=\"0\"><testsuite name=\"Common\">"
+        "<testcase name=\"Namesake\" time=\"0\"><property name=\"stableId\" value=\"0000000000000001\" /></testcase>"
+        "</testsuite></testsuites>");
+    shards.push_back(
+        "<testsuites tests=\"1\" failures=\"0\" time=\"0\"><testsuite name=\"Common\">"
+        "<testcase name=\"Namesake\" time=\"0\"><property name=\"stableId\" value=\"0000000000000002\" /></testcase>"
+        "</testsuite></testsuites>");
+    shards.push_back(
+        "<testsuites tests=\"1\" failures=\"0\" time=\"0\"><testsuite name=\"Common\">"
+        "<testcase name=\"Namesake\" time=\"0\"><property name=\"stableId\" value=\"0000000000000001\" /></testcase>"
+        "</testsuite></testsuites>");
+
+    XmlMerge merge;
+    Assert.Equal("", merge.ReadDocuments(shards, 3));
+    Assert.Equal(2U, merge.Tests());
+    Assert.Equal(1U, merge.Retried());
+    Assert.Contains(Merged(merge), "0000000000000002");
+}
+
+FACT("XmlMerge without stable ids only takes as many namesakes as it has already for a retry")
+{
+    std::vector<std::string> shards;
+    shards.push_back(
+        "<testsuites tests=\"2\" failures=\"0\" time=\"0\"><testsuite name=\"Common\">"
+        "<testcase name=\"Namesake\" time=\"0\" /><testcase name=\"Namesake\" time=\"0\" />"
+        "</testsuite></testsuites>");
+    shards.push_back(
+        "<testsuites tests=\"1\" failures=\"0\" time=\"0\"><testsuite name=\"Common\">"
+        "<testcase name=\"Namesake\" time=\"0\" />"
+        "</testsuite></testsuites>");
+
+    XmlMerge merge;
+    Assert.Equal("", merge.ReadDocuments(shards, 2));
+    Assert.Equal(3U, merge.Tests());
+    Assert.Equal(0U, merge.Retried());
+}
+
+FACT("XmlMerge reports an unreadable input and merges the rest")
+{
+    std::vector<std::shared_ptr<xUnitpp::xUnitTest>> tests;
+    tests.push_back(TestFactory([]() {}).Name("Fine").Suite("Readable"));
+
+    std::vector<std::string> shards;
+    shards.push_back("<testsuites><testsuite");
+    shards.push_back(Shard(tests));
+    shards.push_back("<results />");
+
+    XmlMerge merge;
+    auto errors = merge.ReadDocuments(shards, 3);
+
+    Assert.Contains(errors, "document 0");
+    Assert.DoesNotContain(errors, "document 1");
+    Assert.Contains(errors, "document 2");
+    Assert.Equal(1U, merge.Tests());
+}
+
+}
@@ -1,3 +1,7 @@
+#include <streambuf>
+#include <string>
+#include "xUnit++/EventLevel.h"
+#include "xUnit++/TestEvent.h"
 #include "xUnit++/xUnit++.h"
 #include "xUnit++/xUnitTestRunner.h"
 #include "XmlReporter.h"
@@ -31,6 +35,20 @@ namespace
     private:
         std::vector<std::shared_ptr<xUnitpp::xUnitTest>> tests;
     };
+
+    // output that can't be seeked, like a pipe
+    class PipeBuffer : public std::streambuf
+    {
+    public:
+        std::string text;
+
+    protected:
+        virtual int_type overflow(int_type c) override
+        {
+            text += traits_type::to_char_type(c);
+            return c;
+        }
+    };
 }
 
 SUITE("XmlReporter")
@@ -40,7 +58,7 @@ FACT("XmlReporter generates valid xml with no tests")
 {
     std::stringstream out;
 
-    XmlReporter reporter(out);
+    XmlReporter reporter(out, true);
     reporter.ReportAllTestsComplete(0, 0, 0, 0);
 
     Assert.Equal(tinyxml2::XMLError::XML_SUCCESS, tinyxml2::XMLDocument().Parse(out.str().c_str()));
@@ -68,7 +86,7 @@ DATA_THEORY("XmlReporter generates valid xml after running tests", (std::functio
 {
     std::stringstream out;
 
-    XmlReporter reporter(out);
+    XmlReporter reporter(out, true);
 
     {
         LocalTester local;
@@ -80,4 +98,103 @@ DATA_THEORY("XmlReporter generates valid xml after running tests", (std::functio
     Assert.Equal(tinyxml2::XMLError::XML_SUCCESS, tinyxml2::XMLDocument().Parse(out.str().c_str()));
 }
 
+FACT("XmlReporter escapes everything it writes")
+{
+    std::stringstream out;
+
+    XmlReporter reporter(out, true);
+
+    {
+        LocalTester local;
+        local.Register(TestFactory([]() { Assert.Fail() << "first <line>\nsecond & \"last\" line"; }).Name("operator << 'shifts'").Suite("Suite <&>"));
+
+        local.Run(reporter);
+    }
+
+    tinyxml2::XMLDocument doc;
+    Assert.Equal(tinyxml2::XMLError::XML_SUCCESS, doc.Parse(out.str().c_str()));
+
+    auto suite = doc.FirstChildElement("testsuites")->FirstChildElement("testsuite");
+    Assert.Equal("Suite <&>", suite->Attribute("name"));
+    Assert.Equal("operator << 'shifts'", suite->FirstChildElement("testcase")->Attribute("name"));
+    Assert.Contains(std::string(suite->FirstChildElement("testcase")->FirstChildElement("failure")->Attribute("message")), "first <line>\nsecond & \"last\" line");
+}
+
+FACT("XmlReporter writes a suite as soon as its expected tests have finished")
+{
+    std::shared_ptr<xUnitpp::xUnitTest> first = TestFactory([]() {}).Name("First").Suite("Streamed");
+    std::shared_ptr<xUnitpp::xUnitTest> second = TestFactory([]() {}).Name("Second").Suite("Streamed");
+    std::shared_ptr<xUnitpp::xUnitTest> other = TestFactory([]() {}).Name("Other").Suite("Held");
+
+    std::stringstream out;
+
+    XmlReporter reporter(out, true);
+    reporter.ExpectTests("Streamed", 2);
+
+    reporter.ReportStart(first->TestDetails());
+    reporter.ReportStart(other->TestDetails());
+    reporter.ReportFinish(first->TestDetails(), 0);
+    reporter.ReportFinish(other->TestDetails(), 0);
+
+    Assert.DoesNotContain(out.str(), "Streamed");
+
+    reporter.ReportSkip(second->TestDetails(), "Not now.");
+
+    Assert.Contains(out.str(), "<testsuite name=\"Streamed\"");
+    Assert.DoesNotContain(out.str(), "Held");
+
+    reporter.ReportAllTestsComplete(3, 1, 0, 0);
+
+    tinyxml2::XMLDocument doc;
+    Assert.Equal(tinyxml2::XMLError::XML_SUCCESS, doc.Parse(out.str().c_str()));
+    Assert.Equal(3, doc.FirstChildElement("testsuites")->IntAttribute("tests"));
+    Assert.Equal("Held", doc.FirstChildElement("testsuites")->LastChildElement("testsuite")->Attribute("name"));
+}
+
+FACT("XmlReporter drops reports for tests it never saw start")
+{
+    std::shared_ptr<xUnitpp::xUnitTest> started = TestFactory([]() {}).Name("Started").Suite("Known");
+    std::shared_ptr<xUnitpp::xUnitTest> stranger = TestFactory([]() {}).Name("Stranger").Suite("Unknown");
+
+    std::stringstream out;
+
+    XmlReporter reporter(out, true);
+
+    reporter.ReportStart(started->TestDetails());
+    reporter.ReportEvent(stranger->TestDetails(), xUnitpp::TestEvent(xUnitpp::EventLevel::Fatal, "lost"));
+    reporter.ReportFinish(stranger->TestDetails(), 0);
+    reporter.ReportFinish(started->TestDetails(), 0);
+    reporter.ReportFinish(started->TestDetails(), 0);
+    reporter.ReportAllTestsComplete(1, 0, 0, 0);
+
+    tinyxml2::XMLDocument doc;
+    Assert.Equal(tinyxml2::XMLError::XML_SUCCESS, doc.Parse(out.str().c_str()));
+    Assert.Equal(0, doc.FirstChildElement("testsuites")->FirstChildElement("testsuite")->IntAttribute("failures"));
+    Assert.DoesNotContain(out.str(), "Unknown");
+    Assert.DoesNotContain(out.str(), "lost");
+}
+
+FACT("XmlReporter holds finished suites back when it can't seek to write the totals")
+{
+    std::shared_ptr<xUnitpp::xUnitTest> test = TestFactory([]() {}).Name("Only").Suite("Piped");
+
+    PipeBuffer pipe;
+    std::ostream out(&pipe);
+
+    XmlReporter reporter(out, true);
+    reporter.ExpectTests("Piped", 1);
+
+    reporter.ReportStart(test->TestDetails());
+    reporter.ReportFinish(test->TestDetails(), 0);
+
+    Assert.DoesNotContain(pipe.text, "Piped");
+
+    reporter.ReportAllTestsComplete(1, 0, 0, 0);
+
+    tinyxml2::XMLDocument doc;
+    Assert.Equal(tinyxml2::XMLError::XML_SUCCESS, doc.Parse(pipe.text.c_str()));
+    Assert.Equal(1, doc.FirstChildElement("testsuites")->IntAttribute("tests"));
+    Assert.Equal("Piped", doc.FirstChildElement("testsuites")->FirstChildElement("testsuite")->Attribute("name"));
+}
+
 }
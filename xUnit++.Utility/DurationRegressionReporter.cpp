@@ -0,0 +1,168 @@
+#include "DurationRegressionReporter.h"
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include "xUnit++/EventLevel.h"
+#include "xUnit++/ITestDetails.h"
+#include "xUnit++/ITestEvent.h"
+#include "TimingHistoryReader.h"
+
+namespace
+{
+    class RegressionEvent : public xUnitpp::ITestEvent, public xUnitpp::ITestAssert
+    {
+    public:
+        RegressionEvent(bool strict, const std::string &message, const xUnitpp::ITestDetails &testDetails)
+            : strict(strict)
+            , message(message)
+            , file(testDetails.GetFile() != nullptr ? testDetails.GetFile() : "")
+            , line(testDetails.GetLine())
+        {
+        }
+
+        virtual bool __stdcall GetIsAssertType() const override { return false; }
+        virtual bool __stdcall GetIsFailure() const override { return strict; }
+        virtual xUnitpp::EventLevel __stdcall GetLevel() const override { return strict ? xUnitpp::EventLevel::Check : xUnitpp::EventLevel::Warning; }
+        virtual const char * __stdcall GetMessage() const override { return message.c_str(); }
+        virtual const char * __stdcall GetToString() const override { return message.c_str(); }
+        virtual const char * __stdcall GetFile() const override { return file.c_str(); }
+        virtual int __stdcall GetLine() const override { return line; }
+        virtual const xUnitpp::ITestAssert & __stdcall GetAssertInterface() const override { return *this; }
+
+        virtual const char * __stdcall GetCall() const override { return ""; }
+        virtual const char * __stdcall GetUserMessage() const override { return ""; }
+        virtual const char * __stdcall GetCustomMessage() const override { return ""; }
+        virtual const char * __stdcall GetExpected() const override { return ""; }
+        virtual const char * __stdcall GetActual() const override { return ""; }
+
+    private:
+        bool strict;
+        std::string message;
+        std::string file;
+        int line;
+    };
+}
+
+namespace xUnitpp { namespace Utilities
+{
+
+DurationRegressionReporter::Limits::Limits()
+    : ratio(0)
+    , zScore(0)
+    , minimumSamples(5)
+    , recentSamples(20)
+    , minimumNs(1000000)
+    , strict(false)
+{
+}
+
+DurationRegressionReporter::DurationRegressionReporter(IOutput &output, const TimingHistoryReader &baseline, bool stableIds, const Limits &limits)
+    : output(output)
+    , baseline(baseline)
+    , stableIds(stableIds)
+    , limits(limits)
+    , regressions(0)
+    , failures(0)
+{
+}
+
+DurationRegressionReporter::~DurationRegressionReporter() noexcept(true)
+{
+}
+
+size_t DurationRegressionReporter::Regressions() const
+{
+    return regressions;
+}
+
+size_t DurationRegressionReporter::Failures() const
+{
+    return failures;
+}
+
+void DurationRegressionReporter::ReportStart(const ITestDetails &testDetails)
+{
+    output.ReportStart(testDetails);
+}
+
+void DurationRegressionReporter::ReportEvent(const ITestDetails &testDetails, const ITestEvent &evt)
+{
+    if (evt.GetIsFailure())
+    {
+        failed.insert(testDetails.GetId());
+    }
+
+    output.ReportEvent(testDetails, evt);
+}
+
+void DurationRegressionReporter::ReportSkip(const ITestDetails &testDetails, const char *reason)
+{
+    output.ReportSkip(testDetails, reason);
+}
+
+void DurationRegressionReporter::ReportFinish(const ITestDetails &testDetails, long long nsTaken)
+{
+    // a failing test is already reported, and how long it took to fail says little
+    auto test = failed.erase(testDetails.GetId()) == 0 ? baseline.Find(TimingHistory::StableId(testDetails, stableIds)) : nullptr;
+
+    if (test != nullptr)
+    {
+        double sum = 0;
+        double squares = 0;
+        size_t count = 0;
+
+        for (auto sample = test->samples.rbegin(); sample != test->samples.rend() && count != limits.recentSamples; ++sample)
+        {
+            if (sample->outcome == TimingHistory::Passed)
+            {
+                sum += (double)sample->ns;
+                squares += (double)sample->ns * (double)sample->ns;
+                ++count;
+            }
+        }
+
+        double mean = count != 0 ? sum / count : 0;
+        double deviation = count > 1 ? std::sqrt(std::max(0.0, (squares - sum * mean) / (count - 1))) : 0;
+        double z = deviation > 0 ? (nsTaken - mean) / deviation : 0;
+
+        bool slower = count != 0 && nsTaken - mean >= (double)limits.minimumNs &&
+            ((limits.ratio > 0 && nsTaken > limits.ratio * mean) ||
+             (limits.zScore > 0 && count >= limits.minimumSamples && z > limits.zScore));
+
+        if (slower)
+        {
+            std::ostringstream message;
+            message << std::fixed << std::setprecision(3) << "Took " << nsTaken / 1e6 << " ms, against a mean of " << mean / 1e6 << " ms";
+
+            if (mean > 0)
+            {
+                message << std::setprecision(2) << " (" << nsTaken / mean << " times";
+
+                if (deviation > 0)
+                {
+                    message << ", z = " << z;
+                }
+
+                message << ")";
+            }
+
+            message << " over its last " << count << " passing runs.";
+
+            ++regressions;
+            failures += limits.strict ? 1 : 0;
+
+            output.ReportEvent(testDetails, RegressionEvent(limits.strict, message.str(), testDetails));
+        }
+    }
+
+    output.ReportFinish(testDetails, nsTaken);
+}
+
+void DurationRegressionReporter::ReportAllTestsComplete(size_t testCount, size_t skipped, size_t failureCount, long long nsTotal)
+{
+    output.ReportAllTestsComplete(testCount, skipped, failureCount + failures, nsTotal);
+}
+
+}}
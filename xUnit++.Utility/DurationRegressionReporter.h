@@ -0,0 +1,82 @@
+#ifndef DURATIONREGRESSIONREPORTER_H_
+#define DURATIONREGRESSIONREPORTER_H_
+
+#if defined(_MSC_VER)
+# if !defined(_ALLOW_KEYWORD_MACROS)
+#  define _ALLOW_KEYWORD_MACROS
+# endif
+#define noexcept(x)
+#endif
+
+#include <cstddef>
+#include <unordered_set>
+#include "xUnit++/IOutput.h"
+
+namespace xUnitpp { namespace Utilities
+{
+
+class TimingHistoryReader;
+
+// Passes every report on to `output`, first adding an event to any passing test that took markedly longer
+// than its recent passing runs in a TimingHistory. The event is a Warning, or in strict mode a failure.
+class DurationRegressionReporter : public IOutput
+{
+public:
+    struct Limits
+    {
+        Limits();
+
+        // flag a test taking more than this many times its mean; 0 to not check
+        double ratio;
+
+        // flag a test this many standard deviations above its mean; 0 to not check
+        double zScore;
+
+        // fewer passing runs than this aren't enough to judge a test by zScore
+        size_t minimumSamples;
+
+        // how many of a test's most recent passing runs make its baseline
+        size_t recentSamples;
+
+        // a test taking less than this much longer than its mean isn't flagged, however large the ratio:
+        // very quick tests vary too much to judge
+        long long minimumNs;
+
+        // flagged tests fail
+        bool strict;
+    };
+
+    // `output` and `baseline` must outlive this
+    // libraries built before ITestDetails::GetStableId have no `stableIds` (see TimingHistory::StableId)
+    DurationRegressionReporter(IOutput &output, const TimingHistoryReader &baseline, bool stableIds, const Limits &limits);
+    virtual ~DurationRegressionReporter() noexcept(true);
+
+    // how many tests were flagged
+    size_t Regressions() const;
+
+    // in strict mode, how many of those would otherwise have passed: the runner doesn't count them
+    size_t Failures() const;
+
+    virtual void __stdcall ReportStart(const ITestDetails &testDetails) override;
+    virtual void __stdcall ReportEvent(const ITestDetails &testDetails, const ITestEvent &evt) override;
+    virtual void __stdcall ReportSkip(const ITestDetails &testDetails, const char *reason) override;
+    virtual void __stdcall ReportFinish(const ITestDetails &testDetails, long long nsTaken) override;
+    virtual void __stdcall ReportAllTestsComplete(size_t testCount, size_t skipped, size_t failureCount, long long nsTotal) override;
+
+private:
+    DurationRegressionReporter &operator =(DurationRegressionReporter) /* = delete; */;
+
+private:
+    IOutput &output;
+    const TimingHistoryReader &baseline;
+    bool stableIds;
+    Limits limits;
+
+    std::unordered_set<int> failed;
+    size_t regressions;
+    size_t failures;
+};
+
+}}
+
+#endif
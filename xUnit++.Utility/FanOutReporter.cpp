@@ -0,0 +1,397 @@
+#include "FanOutReporter.h"
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include "xUnit++/EventLevel.h"
+#include "xUnit++/ITestDetails.h"
+#include "xUnit++/ITestEvent.h"
+
+namespace
+{
+    std::string Safe(const char *text)
+    {
+        return text != nullptr ? text : "";
+    }
+}
+
+namespace xUnitpp { namespace Utilities
+{
+
+// test details are only valid during a report call, so queued reports carry copies
+struct FanOutReporter::DetailsCopy : public ITestDetails
+{
+    DetailsCopy(const ITestDetails &testDetails, bool stableIds)
+        : id(testDetails.GetId())
+        , stableId(stableIds ? testDetails.GetStableId() : 0)
+        , name(Safe(testDetails.GetName()))
+        , fullName(Safe(testDetails.GetFullName()))
+        , suite(Safe(testDetails.GetSuite()))
+        , params(Safe(testDetails.GetParams()))
+        , instance(testDetails.GetTestInstance())
+        , instanceCount(stableIds ? testDetails.GetInstanceCount() : -1)
+        , file(Safe(testDetails.GetFile()))
+        , line(testDetails.GetLine())
+    {
+        for (size_t i = 0; i != testDetails.GetAttributeCount(); ++i)
+        {
+            attributes.push_back(std::make_pair(Safe(testDetails.GetAttributeKey(i)), Safe(testDetails.GetAttributeValue(i))));
+        }
+    }
+
+    virtual int __stdcall GetId() const override { return id; }
+    virtual const char * __stdcall GetName() const override { return name.c_str(); }
+    virtual const char * __stdcall GetFullName() const override { return fullName.c_str(); }
+    virtual const char * __stdcall GetSuite() const override { return suite.c_str(); }
+    virtual const char * __stdcall GetParams() const override { return params.c_str(); }
+    virtual int __stdcall GetTestInstance() const override { return instance; }
+    virtual size_t __stdcall GetAttributeCount() const override { return attributes.size(); }
+    virtual const char * __stdcall GetAttributeKey(size_t index) const override { return attributes[index].first.c_str(); }
+    virtual const char * __stdcall GetAttributeValue(size_t index) const override { return attributes[index].second.c_str(); }
+    virtual const char * __stdcall GetFile() const override { return file.c_str(); }
+    virtual int __stdcall GetLine() const override { return line; }
+    virtual int __stdcall GetInstanceCount() const override { return instanceCount; }
+    virtual unsigned long long __stdcall GetStableId() const override { return stableId; }
+
+    // attributes are copied in the library's order, which is sorted by key
+    virtual void __stdcall FindAttributeKey(const char *key, size_t &begin, size_t &end) const override
+    {
+        for (begin = 0; begin != attributes.size() && attributes[begin].first < key; ++begin)
+        {
+        }
+
+        for (end = begin; end != attributes.size() && attributes[end].first == key; ++end)
+        {
+        }
+    }
+
+    int id;
+    unsigned long long stableId;
+    std::string name;
+    std::string fullName;
+    std::string suite;
+    std::string params;
+    int instance;
+    int instanceCount;
+    std::string file;
+    int line;
+    std::vector<std::pair<std::string, std::string>> attributes;
+};
+
+struct FanOutReporter::EventCopy : public ITestEvent, public ITestAssert
+{
+    EventCopy(const ITestEvent &evt)
+        : isAssert(evt.GetIsAssertType())
+        , isFailure(evt.GetIsFailure())
+        , level(evt.GetLevel())
+        , message(Safe(evt.GetMessage()))
+        , toString(Safe(evt.GetToString()))
+        , file(Safe(evt.GetFile()))
+        , line(evt.GetLine())
+    {
+        if (isAssert)
+        {
+            auto &assert = evt.GetAssertInterface();
+            call = Safe(assert.GetCall());
+            userMessage = Safe(assert.GetUserMessage());
+            customMessage = Safe(assert.GetCustomMessage());
+            expected = Safe(assert.GetExpected());
+            actual = Safe(assert.GetActual());
+        }
+    }
+
+    virtual bool __stdcall GetIsAssertType() const override { return isAssert; }
+    virtual bool __stdcall GetIsFailure() const override { return isFailure; }
+    virtual EventLevel __stdcall GetLevel() const override { return level; }
+    virtual const char * __stdcall GetMessage() const override { return message.c_str(); }
+    virtual const char * __stdcall GetToString() const override { return toString.c_str(); }
+    virtual const char * __stdcall GetFile() const override { return file.c_str(); }
+    virtual int __stdcall GetLine() const override { return line; }
+    virtual const ITestAssert & __stdcall GetAssertInterface() const override { return *this; }
+
+    virtual const char * __stdcall GetCall() const override { return call.c_str(); }
+    virtual const char * __stdcall GetUserMessage() const override { return userMessage.c_str(); }
+    virtual const char * __stdcall GetCustomMessage() const override { return customMessage.c_str(); }
+    virtual const char * __stdcall GetExpected() const override { return expected.c_str(); }
+    virtual const char * __stdcall GetActual() const override { return actual.c_str(); }
+
+    bool isAssert;
+    bool isFailure;
+    EventLevel level;
+    std::string message;
+    std::string toString;
+    std::string file;
+    int line;
+    std::string call;
+    std::string userMessage;
+    std::string customMessage;
+    std::string expected;
+    std::string actual;
+};
+
+// one report, shared by every channel's queue
+struct FanOutReporter::Report
+{
+    enum Kind
+    {
+        Start,
+        Event,
+        Skip,
+        Finish,
+        Complete
+    } kind;
+
+    std::shared_ptr<const DetailsCopy> details;
+    std::shared_ptr<const EventCopy> evt;
+    std::string reason;
+    long long ns;
+    size_t tests;
+    size_t skipped;
+    size_t failed;
+
+    void SendTo(IOutput &output) const
+    {
+        switch (kind)
+        {
+        case Start: output.ReportStart(*details); break;
+        case Event: output.ReportEvent(*details, *evt); break;
+        case Skip: output.ReportSkip(*details, reason.c_str()); break;
+        case Finish: output.ReportFinish(*details, ns); break;
+        case Complete: output.ReportAllTestsComplete(tests, skipped, failed, ns); break;
+        }
+    }
+};
+
+class FanOutReporter::Channel
+{
+public:
+    Channel(const std::string &name, IOutput &output)
+        : name(name)
+        , output(output)
+        , busy(false)
+        , closing(false)
+        , stopped(false)
+        , thread([this]() { Run(); })
+    {
+    }
+
+    ~Channel()
+    {
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            closing = true;
+        }
+
+        changed.notify_all();
+        thread.join();
+    }
+
+    void Send(const std::shared_ptr<const Report> &report)
+    {
+        {
+            std::lock_guard<std::mutex> guard(lock);
+
+            if (stopped)
+            {
+                return;
+            }
+
+            queue.push_back(report);
+        }
+
+        changed.notify_all();
+    }
+
+    void Wait()
+    {
+        std::unique_lock<std::mutex> guard(lock);
+        changed.wait(guard, [this]() { return queue.empty() && !busy; });
+    }
+
+    const std::string name;
+
+    // set once the thread stops, and never changed after
+    std::string failure;
+
+private:
+    Channel(const Channel &) /* = delete */;
+    Channel &operator =(const Channel &) /* = delete */;
+
+    void Run()
+    {
+        std::unique_lock<std::mutex> guard(lock);
+
+        for (;;)
+        {
+            changed.wait(guard, [this]() { return !queue.empty() || closing; });
+
+            if (queue.empty())
+            {
+                return;
+            }
+
+            // everything queued so far is sent without holding the lock, so reports keep queueing meanwhile
+            std::deque<std::shared_ptr<const Report>> reports;
+            reports.swap(queue);
+            busy = true;
+
+            guard.unlock();
+
+            std::string error;
+
+            try
+            {
+                for (auto &report : reports)
+                {
+                    report->SendTo(output);
+                }
+            }
+            catch (const std::exception &e)
+            {
+                error = e.what();
+            }
+            catch (...)
+            {
+                error = "unknown exception.";
+            }
+
+            guard.lock();
+            busy = false;
+
+            if (!error.empty())
+            {
+                failure = error;
+                stopped = true;
+                queue.clear();
+            }
+
+            changed.notify_all();
+        }
+    }
+
+private:
+    IOutput &output;
+
+    std::mutex lock;
+    std::condition_variable changed;
+    std::deque<std::shared_ptr<const Report>> queue;
+    bool busy;
+    bool closing;
+    bool stopped;
+
+    // last, so it starts once everything it uses is ready
+    std::thread thread;
+};
+
+FanOutReporter::FanOutReporter(bool stableIds)
+    : stableIds(stableIds)
+{
+}
+
+FanOutReporter::~FanOutReporter() noexcept(true)
+{
+}
+
+void FanOutReporter::Add(const std::string &name, IOutput &output)
+{
+    channels.emplace_back(new Channel(name, output));
+}
+
+void FanOutReporter::Wait()
+{
+    for (auto &channel : channels)
+    {
+        channel->Wait();
+    }
+}
+
+std::vector<std::pair<std::string, std::string>> FanOutReporter::Failures() const
+{
+    std::vector<std::pair<std::string, std::string>> failures;
+
+    for (auto &channel : channels)
+    {
+        if (!channel->failure.empty())
+        {
+            failures.push_back(std::make_pair(channel->name, channel->failure));
+        }
+    }
+
+    return failures;
+}
+
+std::shared_ptr<const FanOutReporter::DetailsCopy> FanOutReporter::Copy(const ITestDetails &testDetails)
+{
+    auto it = running.find(testDetails.GetId());
+    return it != running.end() ? it->second : std::make_shared<const DetailsCopy>(testDetails, stableIds);
+}
+
+void FanOutReporter::Send(const std::shared_ptr<const Report> &report)
+{
+    for (auto &channel : channels)
+    {
+        channel->Send(report);
+    }
+}
+
+void FanOutReporter::ReportStart(const ITestDetails &testDetails)
+{
+    auto report = std::make_shared<Report>();
+    report->kind = Report::Start;
+    report->details = std::make_shared<const DetailsCopy>(testDetails, stableIds);
+
+    running[testDetails.GetId()] = report->details;
+
+    Send(report);
+}
+
+void FanOutReporter::ReportEvent(const ITestDetails &testDetails, const ITestEvent &evt)
+{
+    auto report = std::make_shared<Report>();
+    report->kind = Report::Event;
+    report->details = Copy(testDetails);
+    report->evt = std::make_shared<const EventCopy>(evt);
+
+    Send(report);
+}
+
+void FanOutReporter::ReportSkip(const ITestDetails &testDetails, const char *reason)
+{
+    auto report = std::make_shared<Report>();
+    report->kind = Report::Skip;
+    report->details = Copy(testDetails);
+    report->reason = Safe(reason);
+
+    Send(report);
+}
+
+void FanOutReporter::ReportFinish(const ITestDetails &testDetails, long long nsTaken)
+{
+    auto report = std::make_shared<Report>();
+    report->kind = Report::Finish;
+    report->details = Copy(testDetails);
+    report->ns = nsTaken;
+
+    running.erase(testDetails.GetId());
+
+    Send(report);
+}
+
+void FanOutReporter::ReportAllTestsComplete(size_t testCount, size_t skipped, size_t failureCount, long long nsTotal)
+{
+    auto report = std::make_shared<Report>();
+    report->kind = Report::Complete;
+    report->tests = testCount;
+    report->skipped = skipped;
+    report->failed = failureCount;
+    report->ns = nsTotal;
+
+    Send(report);
+
+    // like any other reporter, everything has been reported once this returns
+    Wait();
+}
+
+}}
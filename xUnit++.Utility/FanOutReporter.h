@@ -0,0 +1,71 @@
+#ifndef FANOUTREPORTER_H_
+#define FANOUTREPORTER_H_
+
+#if defined(_MSC_VER)
+# if !defined(_ALLOW_KEYWORD_MACROS)
+#  define _ALLOW_KEYWORD_MACROS
+# endif
+#define noexcept(x)
+#endif
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "xUnit++/IOutput.h"
+
+namespace xUnitpp { namespace Utilities
+{
+
+// Passes every report on to any number of reporters, each from its own queue and thread.
+// A report call only copies what it was given and queues it, so test threads never wait on a
+// reporter, and a slow reporter never holds back the others. A reporter that throws is stopped,
+// and the rest carry on without it.
+class FanOutReporter : public IOutput
+{
+public:
+    // libraries built before ITestDetails::GetStableId have no `stableIds`, nor GetInstanceCount:
+    // the copies of their tests' details have 0 and -1 for them
+    explicit FanOutReporter(bool stableIds);
+    virtual ~FanOutReporter() noexcept(true);
+
+    // `output` must outlive this, and is only ever called from its own thread
+    // `name` identifies it in Failures
+    void Add(const std::string &name, IOutput &output);
+
+    // waits for every reporter to finish with every report made so far
+    void Wait();
+
+    // the reporters that threw, and what they threw, once they have been waited for
+    std::vector<std::pair<std::string, std::string>> Failures() const;
+
+    virtual void __stdcall ReportStart(const ITestDetails &testDetails) override;
+    virtual void __stdcall ReportEvent(const ITestDetails &testDetails, const ITestEvent &evt) override;
+    virtual void __stdcall ReportSkip(const ITestDetails &testDetails, const char *reason) override;
+    virtual void __stdcall ReportFinish(const ITestDetails &testDetails, long long nsTaken) override;
+    virtual void __stdcall ReportAllTestsComplete(size_t testCount, size_t skipped, size_t failureCount, long long nsTotal) override;
+
+private:
+    FanOutReporter(const FanOutReporter &) /* = delete */;
+    FanOutReporter &operator =(const FanOutReporter &) /* = delete */;
+
+    struct DetailsCopy;
+    struct EventCopy;
+    struct Report;
+    class Channel;
+
+    std::shared_ptr<const DetailsCopy> Copy(const ITestDetails &testDetails);
+    void Send(const std::shared_ptr<const Report> &report);
+
+private:
+    bool stableIds;
+    std::vector<std::unique_ptr<Channel>> channels;
+
+    // copied once when a test starts, and shared by every report about it until it finishes
+    std::unordered_map<int, std::shared_ptr<const DetailsCopy>> running;
+};
+
+}}
+
+#endif
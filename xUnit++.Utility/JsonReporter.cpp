@@ -0,0 +1,198 @@
+#include "JsonReporter.h"
+#include <string>
+#include "xUnit++/EventLevel.h"
+#include "xUnit++/ITestDetails.h"
+#include "xUnit++/ITestEvent.h"
+
+namespace
+{
+    // the buffer is written out once it holds this much, or when a line is added this long after the last write
+    const size_t BufferSize = 64 * 1024;
+    const std::chrono::milliseconds BufferTime(100);
+
+    const char HexDigits[] = "0123456789abcdef";
+
+    void JsonString(std::string &json, const char *value)
+    {
+        json += '"';
+
+        for (auto c = value; c != nullptr && *c != 0; ++c)
+        {
+            switch (*c)
+            {
+            case '"': json += "\\\""; break;
+            case '\\': json += "\\\\"; break;
+            case '\n': json += "\\n"; break;
+            case '\r': json += "\\r"; break;
+            case '\t': json += "\\t"; break;
+            default:
+                if ((unsigned char)*c < 0x20)
+                {
+                    json += "\\u00";
+                    json += HexDigits[(unsigned char)*c >> 4];
+                    json += HexDigits[(unsigned char)*c & 0xf];
+                }
+                else
+                {
+                    json += *c;
+                }
+                break;
+            }
+        }
+
+        json += '"';
+    }
+
+    void JsonField(std::string &json, const char *name, const char *value)
+    {
+        json += ",\"";
+        json += name;
+        json += "\":";
+        JsonString(json, value);
+    }
+
+    template<typename T>
+    void JsonField(std::string &json, const char *name, T value)
+    {
+        json += ",\"";
+        json += name;
+        json += "\":";
+        json += std::to_string(value);
+    }
+
+    void JsonField(std::string &json, const char *name, bool value)
+    {
+        json += ",\"";
+        json += name;
+        json += "\":";
+        json += value ? "true" : "false";
+    }
+
+    const char *LevelName(xUnitpp::EventLevel level)
+    {
+        switch (level)
+        {
+        case xUnitpp::EventLevel::Debug: return "debug";
+        case xUnitpp::EventLevel::Info: return "info";
+        case xUnitpp::EventLevel::Warning: return "warning";
+        case xUnitpp::EventLevel::Check: return "check";
+        case xUnitpp::EventLevel::Assert: return "assert";
+        case xUnitpp::EventLevel::Fatal: return "fatal";
+        }
+
+        return "unknown";
+    }
+}
+
+namespace xUnitpp { namespace Utilities
+{
+
+JsonReporter::JsonReporter(std::ostream &output, bool stableIds)
+    : output(output)
+    , stableIds(stableIds)
+    , lastWrite(std::chrono::steady_clock::now())
+{
+    buffer.reserve(BufferSize);
+}
+
+JsonReporter::~JsonReporter() noexcept(true)
+{
+    // a run that never completed still leaves every line it reported
+    EndLine(true);
+}
+
+void JsonReporter::BeginLine(const char *type, const ITestDetails &testDetails)
+{
+    buffer += "{\"type\":\"";
+    buffer += type;
+    buffer += '"';
+
+    JsonField(buffer, "id", testDetails.GetId());
+
+    if (stableIds)
+    {
+        char stableId[17] = {};
+        auto hash = testDetails.GetStableId();
+        for (int digit = 15; digit >= 0; --digit, hash >>= 4)
+        {
+            stableId[digit] = HexDigits[hash & 0xf];
+        }
+
+        JsonField(buffer, "stableId", (const char *)stableId);
+    }
+}
+
+void JsonReporter::EndLine(bool flush)
+{
+    auto now = std::chrono::steady_clock::now();
+
+    if (!buffer.empty() && (flush || buffer.size() >= BufferSize || now - lastWrite >= BufferTime))
+    {
+        output.write(buffer.data(), (std::streamsize)buffer.size());
+        output.flush();
+
+        buffer.clear();
+        lastWrite = now;
+    }
+}
+
+void JsonReporter::ReportStart(const ITestDetails &testDetails)
+{
+    BeginLine("start", testDetails);
+    JsonField(buffer, "suite", testDetails.GetSuite());
+    JsonField(buffer, "name", testDetails.GetFullName());
+    JsonField(buffer, "file", testDetails.GetFile());
+    JsonField(buffer, "line", testDetails.GetLine());
+    buffer += "}\n";
+
+    EndLine();
+}
+
+void JsonReporter::ReportEvent(const ITestDetails &testDetails, const ITestEvent &evt)
+{
+    BeginLine("event", testDetails);
+    JsonField(buffer, "level", LevelName(evt.GetLevel()));
+    JsonField(buffer, "failure", evt.GetIsFailure());
+    JsonField(buffer, "file", evt.GetFile());
+    JsonField(buffer, "line", evt.GetLine());
+    JsonField(buffer, "message", evt.GetToString());
+    buffer += "}\n";
+
+    EndLine();
+}
+
+void JsonReporter::ReportSkip(const ITestDetails &testDetails, const char *reason)
+{
+    BeginLine("skip", testDetails);
+    JsonField(buffer, "suite", testDetails.GetSuite());
+    JsonField(buffer, "name", testDetails.GetFullName());
+    JsonField(buffer, "file", testDetails.GetFile());
+    JsonField(buffer, "line", testDetails.GetLine());
+    JsonField(buffer, "reason", reason);
+    buffer += "}\n";
+
+    EndLine();
+}
+
+void JsonReporter::ReportFinish(const ITestDetails &testDetails, long long nsTaken)
+{
+    BeginLine("finish", testDetails);
+    JsonField(buffer, "ns", nsTaken);
+    buffer += "}\n";
+
+    EndLine();
+}
+
+void JsonReporter::ReportAllTestsComplete(size_t testCount, size_t skipped, size_t failureCount, long long nsTotal)
+{
+    buffer += "{\"type\":\"complete\"";
+    JsonField(buffer, "tests", testCount);
+    JsonField(buffer, "failures", failureCount);
+    JsonField(buffer, "skipped", skipped);
+    JsonField(buffer, "ns", nsTotal);
+    buffer += "}\n";
+
+    EndLine(true);
+}
+
+}}
@@ -0,0 +1,59 @@
+#ifndef JSONREPORTER_H_
+#define JSONREPORTER_H_
+
+#if defined(_MSC_VER)
+# if !defined(_ALLOW_KEYWORD_MACROS)
+#  define _ALLOW_KEYWORD_MACROS
+# endif
+#define noexcept(x)
+#endif
+
+#include <chrono>
+#include <ostream>
+#include <string>
+#include "xUnit++/IOutput.h"
+
+namespace xUnitpp { namespace Utilities
+{
+
+// Writes one JSON object per line for every start, event, skip and finish, as they happen, then one for the whole run:
+//
+//   {"type":"start","id":4,"stableId":"9f86d081884c7d65","suite":"Math","name":"Adds","file":"Math.cpp","line":12}
+//   {"type":"event","id":4,"stableId":"9f86d081884c7d65","level":"check","failure":true,"file":"Math.cpp","line":14,"message":"..."}
+//   {"type":"skip","id":5,"stableId":"...","suite":"Math","name":"Divides","file":"Math.cpp","line":20,"reason":"..."}
+//   {"type":"finish","id":4,"stableId":"9f86d081884c7d65","ns":1200}
+//   {"type":"complete","tests":2,"failures":1,"skipped":1,"ns":1900}
+//
+// Stable ids are written as hex strings, since JSON numbers can't hold 64 bits exactly.
+// Lines are written to the output a buffer at a time: when the buffer fills, when a line comes long enough after the last write,
+// and at the end.
+class JsonReporter : public IOutput
+{
+public:
+    // libraries built before ITestDetails::GetStableId have no `stableIds`, and their lines leave them out
+    JsonReporter(std::ostream &output, bool stableIds);
+    virtual ~JsonReporter() noexcept(true);
+
+    virtual void __stdcall ReportStart(const ITestDetails &testDetails) override;
+    virtual void __stdcall ReportEvent(const ITestDetails &testDetails, const ITestEvent &evt) override;
+    virtual void __stdcall ReportSkip(const ITestDetails &testDetails, const char *reason) override;
+    virtual void __stdcall ReportFinish(const ITestDetails &testDetails, long long nsTaken) override;
+    virtual void __stdcall ReportAllTestsComplete(size_t testCount, size_t skipped, size_t failureCount, long long nsTotal) override;
+
+private:
+    JsonReporter &operator =(JsonReporter) /* = delete; */;
+
+    void BeginLine(const char *type, const ITestDetails &testDetails);
+    void EndLine(bool flush = false);
+
+private:
+    std::ostream &output;
+    bool stableIds;
+
+    std::string buffer;
+    std::chrono::steady_clock::time_point lastWrite;
+};
+
+}}
+
+#endif
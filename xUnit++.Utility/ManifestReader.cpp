@@ -0,0 +1,195 @@
+#include "ManifestReader.h"
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+
+namespace
+{
+    template<typename T>
+    const T *After(const void *data, size_t offset)
+    {
+        return reinterpret_cast<const T *>(static_cast<const char *>(data) + offset);
+    }
+
+    struct KeyLess
+    {
+        KeyLess(const char *strings)
+            : strings(strings)
+        {
+        }
+
+        bool operator()(const xUnitpp::Manifest::Attribute &attribute, const char *key) const
+        {
+            return std::strcmp(strings + attribute.key, key) < 0;
+        }
+
+        bool operator()(const char *key, const xUnitpp::Manifest::Attribute &attribute) const
+        {
+            return std::strcmp(key, strings + attribute.key) < 0;
+        }
+
+        const char *strings;
+    };
+}
+
+namespace xUnitpp { namespace Utilities
+{
+
+bool ManifestReader::Readable(const void *data, size_t size)
+{
+    if (data == nullptr || size < sizeof(Manifest::Header))
+    {
+        return false;
+    }
+
+    auto header = static_cast<const Manifest::Header *>(data);
+
+    if (!std::equal(std::begin(header->magic), std::end(header->magic), Manifest::Magic) || header->version != Manifest::Version)
+    {
+        return false;
+    }
+
+    const size_t testsSize = header->testCount * sizeof(Manifest::Test);
+    const size_t attributesSize = header->attributeCount * sizeof(Manifest::Attribute);
+
+    if (size != sizeof(Manifest::Header) + testsSize + attributesSize + header->stringsSize)
+    {
+        return false;
+    }
+
+    auto strings = After<char>(data, size - header->stringsSize);
+    if (header->stringsSize != 0 && strings[header->stringsSize - 1] != '\0')
+    {
+        return false;
+    }
+
+    // every offset has to land inside the block, so readers never have to check
+    auto tests = After<Manifest::Test>(data, sizeof(Manifest::Header));
+    for (auto test = tests; test != tests + header->testCount; ++test)
+    {
+        if (test->suite >= header->stringsSize || test->name >= header->stringsSize || test->file >= header->stringsSize ||
+            test->firstAttribute > header->attributeCount || test->attributeCount > header->attributeCount - test->firstAttribute)
+        {
+            return false;
+        }
+    }
+
+    auto attributes = After<Manifest::Attribute>(data, sizeof(Manifest::Header) + testsSize);
+    for (auto attribute = attributes; attribute != attributes + header->attributeCount; ++attribute)
+    {
+        if (attribute->key >= header->stringsSize || attribute->value >= header->stringsSize)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+ManifestReader::ManifestReader(const void *data, size_t size)
+    : header(static_cast<const Manifest::Header *>(data))
+    , tests(After<Manifest::Test>(data, sizeof(Manifest::Header)))
+    , attributes(After<Manifest::Attribute>(data, sizeof(Manifest::Header) + header->testCount * sizeof(Manifest::Test)))
+    , strings(After<char>(data, size - header->stringsSize))
+{
+}
+
+size_t ManifestReader::size() const
+{
+    return header->testCount;
+}
+
+ManifestDetails ManifestReader::operator [](size_t index) const
+{
+    return ManifestDetails(*this, tests[index]);
+}
+
+const char *ManifestReader::String(unsigned int offset) const
+{
+    return strings + offset;
+}
+
+ManifestDetails::ManifestDetails(const ManifestReader &manifest, const Manifest::Test &test)
+    : manifest(&manifest)
+    , test(&test)
+{
+}
+
+int __stdcall ManifestDetails::GetId() const
+{
+    return test->id;
+}
+
+const char * __stdcall ManifestDetails::GetName() const
+{
+    return manifest->String(test->name);
+}
+
+const char * __stdcall ManifestDetails::GetFullName() const
+{
+    // only theory rows have parameters in their name, and they aren't in the manifest
+    return GetName();
+}
+
+const char * __stdcall ManifestDetails::GetSuite() const
+{
+    return manifest->String(test->suite);
+}
+
+const char * __stdcall ManifestDetails::GetParams() const
+{
+    return "";
+}
+
+int __stdcall ManifestDetails::GetTestInstance() const
+{
+    return 0;
+}
+
+int __stdcall ManifestDetails::GetInstanceCount() const
+{
+    return test->instanceCount;
+}
+
+size_t __stdcall ManifestDetails::GetAttributeCount() const
+{
+    return test->attributeCount;
+}
+
+const char * __stdcall ManifestDetails::GetAttributeKey(size_t index) const
+{
+    return manifest->String(manifest->attributes[test->firstAttribute + index].key);
+}
+
+const char * __stdcall ManifestDetails::GetAttributeValue(size_t index) const
+{
+    return manifest->String(manifest->attributes[test->firstAttribute + index].value);
+}
+
+void __stdcall ManifestDetails::FindAttributeKey(const char *key, size_t &begin, size_t &end) const
+{
+    auto first = manifest->attributes + test->firstAttribute;
+    auto last = first + test->attributeCount;
+
+    auto range = std::equal_range(first, last, key, KeyLess(manifest->strings));
+
+    begin = std::distance(first, range.first);
+    end = std::distance(first, range.second);
+}
+
+const char * __stdcall ManifestDetails::GetFile() const
+{
+    return manifest->String(test->file);
+}
+
+int __stdcall ManifestDetails::GetLine() const
+{
+    return test->line;
+}
+
+unsigned long long __stdcall ManifestDetails::GetStableId() const
+{
+    return test->hash;
+}
+
+}}
@@ -0,0 +1,67 @@
+#ifndef MANIFESTREADER_H_
+#define MANIFESTREADER_H_
+
+#include <cstddef>
+#include "xUnit++/ITestDetails.h"
+#include "xUnit++/TestManifest.h"
+
+namespace xUnitpp { namespace Utilities
+{
+
+class ManifestReader;
+
+// One test in a manifest, read in place.
+class ManifestDetails : public ITestDetails
+{
+public:
+    ManifestDetails(const ManifestReader &manifest, const Manifest::Test &test);
+
+    // ITestDetails implementation
+    virtual int __stdcall GetId() const override;
+    virtual const char * __stdcall GetName() const override;
+    virtual const char * __stdcall GetFullName() const override;
+    virtual const char * __stdcall GetSuite() const override;
+    virtual const char * __stdcall GetParams() const override;
+    virtual int __stdcall GetTestInstance() const override;
+    virtual size_t __stdcall GetAttributeCount() const override;
+    virtual const char * __stdcall GetAttributeKey(size_t index) const override;
+    virtual const char * __stdcall GetAttributeValue(size_t index) const override;
+    virtual void __stdcall FindAttributeKey(const char *key, size_t &begin, size_t &end) const override;
+    virtual const char * __stdcall GetFile() const override;
+    virtual int __stdcall GetLine() const override;
+    virtual int __stdcall GetInstanceCount() const override;
+    virtual unsigned long long __stdcall GetStableId() const override;
+
+private:
+    const ManifestReader *manifest;
+    const Manifest::Test *test;
+};
+
+// A view of a manifest someone else owns: nothing is copied.
+class ManifestReader
+{
+    friend class ManifestDetails;
+
+public:
+    // false unless `data` is a whole manifest of a version this reader understands
+    static bool Readable(const void *data, size_t size);
+
+    // `data` must be Readable
+    ManifestReader(const void *data, size_t size);
+
+    size_t size() const;
+    ManifestDetails operator [](size_t index) const;
+
+private:
+    const char *String(unsigned int offset) const;
+
+private:
+    const Manifest::Header *header;
+    const Manifest::Test *tests;
+    const Manifest::Attribute *attributes;
+    const char *strings;
+};
+
+}}
+
+#endif
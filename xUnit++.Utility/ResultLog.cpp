@@ -0,0 +1,44 @@
+#include "ResultLog.h"
+
+namespace
+{
+    struct CrcTable
+    {
+        CrcTable()
+        {
+            for (uint32_t i = 0; i != 256; ++i)
+            {
+                uint32_t crc = i;
+                for (int bit = 0; bit != 8; ++bit)
+                {
+                    crc = (crc & 1) != 0 ? (crc >> 1) ^ 0xedb88320 : crc >> 1;
+                }
+
+                entries[i] = crc;
+            }
+        }
+
+        uint32_t entries[256];
+    };
+
+    // built before main, rather than on first use, since not every compiler makes that thread safe
+    const CrcTable Table;
+}
+
+namespace xUnitpp { namespace ResultLog
+{
+
+uint32_t Crc32(const void *data, size_t size)
+{
+    uint32_t crc = 0xffffffff;
+
+    auto bytes = static_cast<const uint8_t *>(data);
+    for (auto byte = bytes; byte != bytes + size; ++byte)
+    {
+        crc = Table.entries[(crc ^ *byte) & 0xff] ^ (crc >> 8);
+    }
+
+    return crc ^ 0xffffffff;
+}
+
+}}
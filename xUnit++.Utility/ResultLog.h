@@ -0,0 +1,119 @@
+#ifndef RESULTLOG_H_
+#define RESULTLOG_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+//
+// A run's results as an append-only stream of records, small enough to keep for runs of millions
+// of tests: a header, then records of
+//
+//   type (1 byte) | payload size (varint) | payload | CRC-32 of everything before it in the record (4 bytes, little endian)
+//
+// Numbers in a payload are varints, signed ones zigzagged first. Strings that repeat (suites, names,
+// files, attribute keys and values) are written once, as a String record, and referred to by number
+// after that; strings that don't (params, messages, reasons) are written in place. Every string ends
+// in a '\0', so a reader can hand them out without copying.
+//
+// Records are only ever appended, and each one carries its own CRC, so a log cut short by a crash
+// still reads up to its last whole record.
+//
+
+namespace xUnitpp { namespace ResultLog
+{
+
+// bumped whenever the layout below changes
+static const uint8_t Version = 1;
+
+static const char Magic[8] = { 'x', 'U', 'n', 'i', 't', '+', '+', 'L' };
+
+// Magic, then Version and Flags, a byte each
+static const size_t HeaderSize = sizeof(Magic) + 2;
+
+enum Flags : uint8_t
+{
+    HasStableIds = 1        // libraries built before ITestDetails::GetStableId leave it out, and their ids are 0
+};
+
+enum RecordType : uint8_t
+{
+    // the text of the next string number, starting from 0
+    String = 1,
+
+    // id, stable id, suite#, name#, params, instance, instance count, file#, line, attribute count, (key#, value#)...
+    Start = 2,
+
+    // id, level, flags (EventFlags), file#, line, to string, message, and for an assert: call, user message, custom message, expected, actual
+    Event = 3,
+
+    // the same details as Start, then the reason
+    Skip = 4,
+
+    // id, nanoseconds
+    Finish = 5,
+
+    // tests, skipped, failed, nanoseconds
+    Complete = 6
+};
+
+enum EventFlags : uint8_t
+{
+    IsFailure = 1,
+    IsAssert = 2
+};
+
+static const size_t CrcSize = 4;
+
+uint32_t Crc32(const void *data, size_t size);
+
+inline void WriteVarint(std::string &out, uint64_t value)
+{
+    while (value >= 0x80)
+    {
+        out += (char)(uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+
+    out += (char)(uint8_t)value;
+}
+
+inline void WriteSigned(std::string &out, int64_t value)
+{
+    WriteVarint(out, ((uint64_t)value << 1) ^ (uint64_t)(value >> 63));
+}
+
+// false when the varint runs past `end`
+inline bool ReadVarint(const uint8_t *&in, const uint8_t *end, uint64_t &value)
+{
+    value = 0;
+
+    for (int shift = 0; in != end && shift < 64; shift += 7)
+    {
+        auto byte = *in++;
+        value |= (uint64_t)(byte & 0x7f) << shift;
+
+        if ((byte & 0x80) == 0)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+inline bool ReadSigned(const uint8_t *&in, const uint8_t *end, int64_t &value)
+{
+    uint64_t zigzag;
+    if (!ReadVarint(in, end, zigzag))
+    {
+        return false;
+    }
+
+    value = (int64_t)(zigzag >> 1) ^ -(int64_t)(zigzag & 1);
+    return true;
+}
+
+}}
+
+#endif
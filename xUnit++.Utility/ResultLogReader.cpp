@@ -0,0 +1,424 @@
+#include "ResultLogReader.h"
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include "xUnit++/EventLevel.h"
+#include "xUnit++/ITestDetails.h"
+#include "xUnit++/ITestEvent.h"
+
+namespace
+{
+    // reads a record's payload front to back; a payload that runs short reads as zeros and empty strings
+    class Payload
+    {
+    public:
+        Payload(const uint8_t *begin, const uint8_t *end)
+            : in(begin)
+            , end(end)
+        {
+        }
+
+        uint64_t Varint()
+        {
+            uint64_t value;
+            return xUnitpp::ResultLog::ReadVarint(in, end, value) ? value : 0;
+        }
+
+        long long Signed()
+        {
+            int64_t value;
+            return xUnitpp::ResultLog::ReadSigned(in, end, value) ? value : 0;
+        }
+
+        const char *Text()
+        {
+            auto terminator = static_cast<const uint8_t *>(std::memchr(in, 0, end - in));
+            if (terminator == nullptr)
+            {
+                in = end;
+                return "";
+            }
+
+            auto text = reinterpret_cast<const char *>(in);
+            in = terminator + 1;
+            return text;
+        }
+
+    private:
+        const uint8_t *in;
+        const uint8_t *end;
+    };
+
+    struct KeyLess
+    {
+        bool operator()(const std::pair<const char *, const char *> &attribute, const char *key) const
+        {
+            return std::strcmp(attribute.first, key) < 0;
+        }
+
+        bool operator()(const char *key, const std::pair<const char *, const char *> &attribute) const
+        {
+            return std::strcmp(key, attribute.first) < 0;
+        }
+    };
+
+    class LoggedDetails : public xUnitpp::ITestDetails
+    {
+    public:
+        template<typename StringLookup>
+        LoggedDetails(Payload &payload, StringLookup string)
+        {
+            id = (int)payload.Signed();
+            stableId = payload.Varint();
+            suite = string(payload.Varint());
+            name = string(payload.Varint());
+            params = payload.Text();
+            instance = (int)payload.Signed();
+            instanceCount = (int)payload.Signed();
+            file = string(payload.Varint());
+            line = (int)payload.Signed();
+
+            for (auto count = payload.Varint(); count != 0; --count)
+            {
+                auto key = string(payload.Varint());
+                attributes.push_back(std::make_pair(key, string(payload.Varint())));
+            }
+
+            // the same as the library's own full names
+            fullName = name;
+            if (*params != '\0')
+            {
+                fullName += "[" + std::to_string(instance) + "]" + params;
+            }
+        }
+
+        virtual int __stdcall GetId() const override { return id; }
+        virtual const char * __stdcall GetName() const override { return name; }
+        virtual const char * __stdcall GetFullName() const override { return fullName.c_str(); }
+        virtual const char * __stdcall GetSuite() const override { return suite; }
+        virtual const char * __stdcall GetParams() const override { return params; }
+        virtual int __stdcall GetTestInstance() const override { return instance; }
+        virtual size_t __stdcall GetAttributeCount() const override { return attributes.size(); }
+        virtual const char * __stdcall GetAttributeKey(size_t index) const override { return attributes[index].first; }
+        virtual const char * __stdcall GetAttributeValue(size_t index) const override { return attributes[index].second; }
+        virtual const char * __stdcall GetFile() const override { return file; }
+        virtual int __stdcall GetLine() const override { return line; }
+        virtual int __stdcall GetInstanceCount() const override { return instanceCount; }
+        virtual unsigned long long __stdcall GetStableId() const override { return stableId; }
+
+        // attributes are logged in the library's order, which is sorted by key
+        virtual void __stdcall FindAttributeKey(const char *key, size_t &begin, size_t &end) const override
+        {
+            auto range = std::equal_range(attributes.begin(), attributes.end(), key, KeyLess());
+            begin = range.first - attributes.begin();
+            end = range.second - attributes.begin();
+        }
+
+    private:
+        int id;
+        unsigned long long stableId;
+        const char *suite;
+        const char *name;
+        const char *params;
+        int instance;
+        int instanceCount;
+        const char *file;
+        int line;
+        std::vector<std::pair<const char *, const char *>> attributes;
+        std::string fullName;
+    };
+
+    class LoggedEvent : public xUnitpp::ITestEvent, public xUnitpp::ITestAssert
+    {
+    public:
+        // the test's id has already been read
+        template<typename StringLookup>
+        LoggedEvent(Payload &payload, StringLookup string)
+            : call("")
+            , userMessage("")
+            , customMessage("")
+            , expected("")
+            , actual("")
+        {
+            level = (xUnitpp::EventLevel)payload.Varint();
+            flags = (uint8_t)payload.Varint();
+            file = string(payload.Varint());
+            line = (int)payload.Signed();
+            toString = payload.Text();
+            message = payload.Text();
+
+            if ((flags & xUnitpp::ResultLog::IsAssert) != 0)
+            {
+                call = payload.Text();
+                userMessage = payload.Text();
+                customMessage = payload.Text();
+                expected = payload.Text();
+                actual = payload.Text();
+            }
+        }
+
+        virtual bool __stdcall GetIsAssertType() const override { return (flags & xUnitpp::ResultLog::IsAssert) != 0; }
+        virtual bool __stdcall GetIsFailure() const override { return (flags & xUnitpp::ResultLog::IsFailure) != 0; }
+        virtual xUnitpp::EventLevel __stdcall GetLevel() const override { return level; }
+        virtual const char * __stdcall GetMessage() const override { return message; }
+        virtual const char * __stdcall GetToString() const override { return toString; }
+        virtual const char * __stdcall GetFile() const override { return file; }
+        virtual int __stdcall GetLine() const override { return line; }
+        virtual const xUnitpp::ITestAssert & __stdcall GetAssertInterface() const override { return *this; }
+
+        virtual const char * __stdcall GetCall() const override { return call; }
+        virtual const char * __stdcall GetUserMessage() const override { return userMessage; }
+        virtual const char * __stdcall GetCustomMessage() const override { return customMessage; }
+        virtual const char * __stdcall GetExpected() const override { return expected; }
+        virtual const char * __stdcall GetActual() const override { return actual; }
+
+    private:
+        xUnitpp::EventLevel level;
+        uint8_t flags;
+        const char *file;
+        int line;
+        const char *toString;
+        const char *message;
+        const char *call;
+        const char *userMessage;
+        const char *customMessage;
+        const char *expected;
+        const char *actual;
+    };
+}
+
+namespace xUnitpp { namespace Utilities
+{
+
+bool ResultLogReader::Readable(const void *data, size_t size)
+{
+    if (data == nullptr || size < ResultLog::HeaderSize)
+    {
+        return false;
+    }
+
+    auto bytes = static_cast<const char *>(data);
+    return std::equal(bytes, bytes + sizeof(ResultLog::Magic), ResultLog::Magic) && (uint8_t)bytes[sizeof(ResultLog::Magic)] == ResultLog::Version;
+}
+
+ResultLogReader::ResultLogReader(const void *data, size_t size)
+    : data(static_cast<const uint8_t *>(data))
+    , validSize(ResultLog::HeaderSize)
+    , hasStableIds((this->data[sizeof(ResultLog::Magic) + 1] & ResultLog::HasStableIds) != 0)
+    , complete(false)
+{
+    auto end = this->data + size;
+
+    for (auto record = this->data + validSize; record != end; )
+    {
+        auto in = record + 1;
+
+        uint64_t payloadSize;
+        if (!ResultLog::ReadVarint(in, end, payloadSize) || payloadSize > (uint64_t)(end - in) || (uint64_t)(end - in) - payloadSize < ResultLog::CrcSize)
+        {
+            break;
+        }
+
+        auto payload = in;
+        auto crcBytes = payload + payloadSize;
+
+        uint32_t crc = crcBytes[0] | (crcBytes[1] << 8) | (crcBytes[2] << 16) | ((uint32_t)crcBytes[3] << 24);
+        if (crc != ResultLog::Crc32(record, crcBytes - record))
+        {
+            break;
+        }
+
+        if (*record == ResultLog::String)
+        {
+            if (payloadSize == 0 || crcBytes[-1] != '\0')
+            {
+                break;
+            }
+
+            strings.push_back(reinterpret_cast<const char *>(payload));
+        }
+        else if (*record == ResultLog::Complete)
+        {
+            complete = true;
+        }
+
+        record = crcBytes + ResultLog::CrcSize;
+        validSize = record - this->data;
+    }
+}
+
+bool ResultLogReader::HasStableIds() const
+{
+    return hasStableIds;
+}
+
+bool ResultLogReader::IsComplete() const
+{
+    return complete;
+}
+
+size_t ResultLogReader::size() const
+{
+    return validSize;
+}
+
+const char *ResultLogReader::String(uint64_t number) const
+{
+    return number < strings.size() ? strings[(size_t)number] : "";
+}
+
+void ResultLogReader::Walk(const std::function<void (ResultLog::RecordType, const uint8_t *, const uint8_t *)> &record) const
+{
+    // every record up to validSize was checked when the log was opened
+    for (auto in = data + ResultLog::HeaderSize; in != data + validSize; )
+    {
+        auto type = (ResultLog::RecordType)*in++;
+
+        uint64_t payloadSize;
+        ResultLog::ReadVarint(in, data + validSize, payloadSize);
+
+        record(type, in, in + payloadSize);
+        in += payloadSize + ResultLog::CrcSize;
+    }
+}
+
+std::vector<ResultLogReader::Result> ResultLogReader::Results() const
+{
+    auto string = [&](uint64_t number) { return String(number); };
+
+    std::vector<Result> results;
+    std::unordered_map<int, size_t> byId;
+
+    Walk([&](ResultLog::RecordType type, const uint8_t *begin, const uint8_t *end)
+        {
+            Payload payload(begin, end);
+
+            if (type == ResultLog::Start || type == ResultLog::Skip)
+            {
+                LoggedDetails details(payload, string);
+
+                Result result = { details.GetId(), details.GetStableId(), details.GetSuite(), details.GetName(), details.GetParams(),
+                    details.GetTestInstance(), details.GetFile(), details.GetLine(), type == ResultLog::Skip, false, type == ResultLog::Skip, 0 };
+
+                byId[result.id] = results.size();
+                results.push_back(result);
+            }
+            else if (type == ResultLog::Event || type == ResultLog::Finish)
+            {
+                auto it = byId.find((int)payload.Signed());
+                if (it == byId.end())
+                {
+                    return;
+                }
+
+                if (type == ResultLog::Finish)
+                {
+                    results[it->second].finished = true;
+                    results[it->second].ns = payload.Signed();
+                }
+                else
+                {
+                    payload.Varint();   // level
+                    results[it->second].failed |= (payload.Varint() & ResultLog::IsFailure) != 0;
+                }
+            }
+        });
+
+    return results;
+}
+
+void ResultLogReader::Replay(IOutput &output) const
+{
+    auto string = [&](uint64_t number) { return String(number); };
+
+    // details are only sent with Start and Skip, so keep them for the records that follow
+    std::unordered_map<int, LoggedDetails> running;
+    std::unordered_set<int> failed;
+
+    size_t tests = 0;
+    size_t skipped = 0;
+    long long ns = 0;
+    bool completed = false;
+
+    Walk([&](ResultLog::RecordType type, const uint8_t *begin, const uint8_t *end)
+        {
+            Payload payload(begin, end);
+
+            switch (type)
+            {
+            case ResultLog::Start:
+                {
+                    LoggedDetails details(payload, string);
+                    auto id = details.GetId();
+
+                    ++tests;
+                    output.ReportStart(running.insert(std::make_pair(id, std::move(details))).first->second);
+                }
+                break;
+
+            case ResultLog::Skip:
+                {
+                    LoggedDetails details(payload, string);
+
+                    ++skipped;
+                    output.ReportSkip(details, payload.Text());
+                }
+                break;
+
+            case ResultLog::Event:
+                {
+                    auto it = running.find((int)payload.Signed());
+                    if (it != running.end())
+                    {
+                        LoggedEvent evt(payload, string);
+
+                        if (evt.GetIsFailure())
+                        {
+                            failed.insert(it->first);
+                        }
+
+                        output.ReportEvent(it->second, evt);
+                    }
+                }
+                break;
+
+            case ResultLog::Finish:
+                {
+                    auto it = running.find((int)payload.Signed());
+                    if (it != running.end())
+                    {
+                        auto taken = payload.Signed();
+                        ns += taken;
+
+                        output.ReportFinish(it->second, taken);
+                        running.erase(it);
+                    }
+                }
+                break;
+
+            case ResultLog::Complete:
+                {
+                    auto testCount = (size_t)payload.Varint();
+                    auto skippedCount = (size_t)payload.Varint();
+                    auto failureCount = (size_t)payload.Varint();
+
+                    output.ReportAllTestsComplete(testCount, skippedCount, failureCount, payload.Signed());
+                    completed = true;
+                }
+                break;
+
+            default:
+                break;
+            }
+        });
+
+    if (!completed)
+    {
+        output.ReportAllTestsComplete(tests, skipped, failed.size(), ns);
+    }
+}
+
+}}
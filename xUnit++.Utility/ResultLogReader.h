@@ -0,0 +1,73 @@
+#ifndef RESULTLOGREADER_H_
+#define RESULTLOGREADER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include "xUnit++/IOutput.h"
+#include "ResultLog.h"
+
+namespace xUnitpp { namespace Utilities
+{
+
+// A view of a ResultLog someone else owns, usually a MappedFile: nothing is copied,
+// and every string handed out points into the log.
+class ResultLogReader
+{
+public:
+    // false unless `data` starts with the header of a log version this reader understands
+    static bool Readable(const void *data, size_t size);
+
+    // `data` must be Readable
+    // every record's CRC is checked here, and the log ends at the first record that isn't whole
+    ResultLogReader(const void *data, size_t size);
+
+    bool HasStableIds() const;
+
+    // false when the log has no Complete record: the run died, or is still going
+    bool IsComplete() const;
+
+    // how much of `data` is header and whole records
+    size_t size() const;
+
+    // one per test started or skipped, in the order they were
+    struct Result
+    {
+        int id;
+        unsigned long long stableId;
+        const char *suite;
+        const char *name;
+        const char *params;
+        int instance;
+        const char *file;
+        int line;
+        bool skipped;
+        bool failed;
+        bool finished;
+        long long ns;
+    };
+
+    // only decodes what a Result holds: events are looked at no further than whether they failed
+    std::vector<Result> Results() const;
+
+    // reports everything in the log to `output`, as if it were happening now
+    // a log that isn't complete is completed with totals counted from its records
+    void Replay(IOutput &output) const;
+
+private:
+    void Walk(const std::function<void (ResultLog::RecordType, const uint8_t *, const uint8_t *)> &record) const;
+    const char *String(uint64_t number) const;
+
+private:
+    const uint8_t *data;
+    size_t validSize;
+    bool hasStableIds;
+    bool complete;
+
+    std::vector<const char *> strings;
+};
+
+}}
+
+#endif
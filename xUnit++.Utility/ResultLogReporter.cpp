@@ -0,0 +1,198 @@
+#include "ResultLogReporter.h"
+#include <string>
+#include <utility>
+#include <vector>
+#include "xUnit++/ITestDetails.h"
+#include "xUnit++/ITestEvent.h"
+
+namespace
+{
+    // the same limits as JsonReporter
+    const size_t BufferSize = 64 * 1024;
+    const std::chrono::milliseconds BufferTime(100);
+
+    void WriteText(std::string &out, const char *text)
+    {
+        if (text != nullptr)
+        {
+            out += text;
+        }
+
+        out += '\0';
+    }
+}
+
+namespace xUnitpp { namespace Utilities
+{
+
+ResultLogReporter::ResultLogReporter(std::ostream &output, bool stableIds)
+    : output(output)
+    , stableIds(stableIds)
+    , lastWrite(std::chrono::steady_clock::now())
+{
+    buffer.reserve(BufferSize);
+
+    buffer.append(ResultLog::Magic, sizeof(ResultLog::Magic));
+    buffer += (char)ResultLog::Version;
+    buffer += (char)(stableIds ? ResultLog::HasStableIds : 0);
+
+    // even a run that writes nothing else leaves a readable log
+    Write(true);
+}
+
+ResultLogReporter::~ResultLogReporter() noexcept(true)
+{
+    Write(true);
+}
+
+uint64_t ResultLogReporter::Intern(const char *text)
+{
+    std::string key(text != nullptr ? text : "");
+
+    auto it = strings.find(key);
+    if (it != strings.end())
+    {
+        return it->second;
+    }
+
+    auto number = (uint64_t)strings.size();
+
+    std::string record;
+    WriteText(record, key.c_str());
+    WriteRecord(ResultLog::String, record);
+
+    strings.insert(std::make_pair(std::move(key), number));
+    return number;
+}
+
+void ResultLogReporter::WriteDetails(const ITestDetails &testDetails)
+{
+    // interned first, so their String records come before the record using them
+    auto suite = Intern(testDetails.GetSuite());
+    auto name = Intern(testDetails.GetName());
+    auto file = Intern(testDetails.GetFile());
+
+    std::vector<std::pair<uint64_t, uint64_t>> attributes;
+    for (size_t i = 0; i != testDetails.GetAttributeCount(); ++i)
+    {
+        attributes.push_back(std::make_pair(Intern(testDetails.GetAttributeKey(i)), Intern(testDetails.GetAttributeValue(i))));
+    }
+
+    payload.clear();
+    ResultLog::WriteSigned(payload, testDetails.GetId());
+    ResultLog::WriteVarint(payload, stableIds ? testDetails.GetStableId() : 0);
+    ResultLog::WriteVarint(payload, suite);
+    ResultLog::WriteVarint(payload, name);
+    WriteText(payload, testDetails.GetParams());
+    ResultLog::WriteSigned(payload, testDetails.GetTestInstance());
+    ResultLog::WriteSigned(payload, stableIds ? testDetails.GetInstanceCount() : -1);
+    ResultLog::WriteVarint(payload, file);
+    ResultLog::WriteSigned(payload, testDetails.GetLine());
+    ResultLog::WriteVarint(payload, attributes.size());
+
+    for (auto &attribute : attributes)
+    {
+        ResultLog::WriteVarint(payload, attribute.first);
+        ResultLog::WriteVarint(payload, attribute.second);
+    }
+}
+
+void ResultLogReporter::WriteRecord(ResultLog::RecordType type, const std::string &payload)
+{
+    auto begin = buffer.size();
+
+    buffer += (char)type;
+    ResultLog::WriteVarint(buffer, payload.size());
+    buffer += payload;
+
+    auto crc = ResultLog::Crc32(buffer.data() + begin, buffer.size() - begin);
+    for (int byte = 0; byte != 4; ++byte, crc >>= 8)
+    {
+        buffer += (char)(uint8_t)crc;
+    }
+}
+
+void ResultLogReporter::Write(bool flush)
+{
+    auto now = std::chrono::steady_clock::now();
+
+    if (!buffer.empty() && (flush || buffer.size() >= BufferSize || now - lastWrite >= BufferTime))
+    {
+        output.write(buffer.data(), (std::streamsize)buffer.size());
+        output.flush();
+
+        buffer.clear();
+        lastWrite = now;
+    }
+}
+
+void ResultLogReporter::ReportStart(const ITestDetails &testDetails)
+{
+    WriteDetails(testDetails);
+    WriteRecord(ResultLog::Start, payload);
+
+    Write();
+}
+
+void ResultLogReporter::ReportEvent(const ITestDetails &testDetails, const ITestEvent &evt)
+{
+    auto file = Intern(evt.GetFile());
+
+    uint8_t flags = (evt.GetIsFailure() ? ResultLog::IsFailure : 0) | (evt.GetIsAssertType() ? ResultLog::IsAssert : 0);
+
+    payload.clear();
+    ResultLog::WriteSigned(payload, testDetails.GetId());
+    ResultLog::WriteVarint(payload, (uint64_t)evt.GetLevel());
+    ResultLog::WriteVarint(payload, flags);
+    ResultLog::WriteVarint(payload, file);
+    ResultLog::WriteSigned(payload, evt.GetLine());
+    WriteText(payload, evt.GetToString());
+    WriteText(payload, evt.GetMessage());
+
+    if (evt.GetIsAssertType())
+    {
+        auto &assert = evt.GetAssertInterface();
+        WriteText(payload, assert.GetCall());
+        WriteText(payload, assert.GetUserMessage());
+        WriteText(payload, assert.GetCustomMessage());
+        WriteText(payload, assert.GetExpected());
+        WriteText(payload, assert.GetActual());
+    }
+
+    WriteRecord(ResultLog::Event, payload);
+
+    Write();
+}
+
+void ResultLogReporter::ReportSkip(const ITestDetails &testDetails, const char *reason)
+{
+    WriteDetails(testDetails);
+    WriteText(payload, reason);
+    WriteRecord(ResultLog::Skip, payload);
+
+    Write();
+}
+
+void ResultLogReporter::ReportFinish(const ITestDetails &testDetails, long long nsTaken)
+{
+    payload.clear();
+    ResultLog::WriteSigned(payload, testDetails.GetId());
+    ResultLog::WriteSigned(payload, nsTaken);
+    WriteRecord(ResultLog::Finish, payload);
+
+    Write();
+}
+
+void ResultLogReporter::ReportAllTestsComplete(size_t testCount, size_t skipped, size_t failureCount, long long nsTotal)
+{
+    payload.clear();
+    ResultLog::WriteVarint(payload, testCount);
+    ResultLog::WriteVarint(payload, skipped);
+    ResultLog::WriteVarint(payload, failureCount);
+    ResultLog::WriteSigned(payload, nsTotal);
+    WriteRecord(ResultLog::Complete, payload);
+
+    Write(true);
+}
+
+}}
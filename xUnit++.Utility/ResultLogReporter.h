@@ -0,0 +1,62 @@
+#ifndef RESULTLOGREPORTER_H_
+#define RESULTLOGREPORTER_H_
+
+#if defined(_MSC_VER)
+# if !defined(_ALLOW_KEYWORD_MACROS)
+#  define _ALLOW_KEYWORD_MACROS
+# endif
+#define noexcept(x)
+#endif
+
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include "xUnit++/IOutput.h"
+#include "ResultLog.h"
+
+namespace xUnitpp { namespace Utilities
+{
+
+// Writes a run's results as a ResultLog (see ResultLog.h), a record per report call.
+// Like JsonReporter, records are written a buffer at a time, and the buffer never waits long,
+// so a run that dies loses no more than its last moments.
+class ResultLogReporter : public IOutput
+{
+public:
+    // libraries built before ITestDetails::GetStableId have no `stableIds`, nor GetInstanceCount:
+    // their records have 0 and -1 for them
+    ResultLogReporter(std::ostream &output, bool stableIds);
+    virtual ~ResultLogReporter() noexcept(true);
+
+    virtual void __stdcall ReportStart(const ITestDetails &testDetails) override;
+    virtual void __stdcall ReportEvent(const ITestDetails &testDetails, const ITestEvent &evt) override;
+    virtual void __stdcall ReportSkip(const ITestDetails &testDetails, const char *reason) override;
+    virtual void __stdcall ReportFinish(const ITestDetails &testDetails, long long nsTaken) override;
+    virtual void __stdcall ReportAllTestsComplete(size_t testCount, size_t skipped, size_t failureCount, long long nsTotal) override;
+
+private:
+    ResultLogReporter &operator =(ResultLogReporter) /* = delete; */;
+
+    // the string's number, writing a String record for it the first time it is seen
+    uint64_t Intern(const char *text);
+
+    void WriteDetails(const ITestDetails &testDetails);
+    void WriteRecord(ResultLog::RecordType type, const std::string &payload);
+    void Write(bool flush = false);
+
+private:
+    std::ostream &output;
+    bool stableIds;
+
+    std::unordered_map<std::string, uint64_t> strings;
+
+    std::string payload;
+    std::string buffer;
+    std::chrono::steady_clock::time_point lastWrite;
+};
+
+}}
+
+#endif
@@ -67,6 +67,9 @@ namespace xUnitpp { namespace Utilities
 TestAssembly::TestAssembly(const std::string &file, bool shadowCopy)
     : EnumerateTestDetails(nullptr)
     , FilteredTestsRunner(nullptr)
+    , GetTestManifest(nullptr)
+    , SelectedTestsRunner(nullptr)
+    , GetRegistryFootprint(nullptr)
     , module(nullptr)
     , tempFile(shadowCopy ? CopyFile(file) : file)
     , shadowCopied(shadowCopy)
@@ -78,6 +81,9 @@ TestAssembly::TestAssembly(const std::string &file, bool shadowCopy)
         {
             EnumerateTestDetails = (xUnitpp::EnumerateTestDetails)GetProcAddress(module, "EnumerateTestDetails");
             FilteredTestsRunner = (xUnitpp::FilteredTestsRunner)GetProcAddress(module, "FilteredTestsRunner");
+            GetTestManifest = (xUnitpp::GetTestManifest)GetProcAddress(module, "GetTestManifest");
+            SelectedTestsRunner = (xUnitpp::SelectedTestsRunner)GetProcAddress(module, "SelectedTestsRunner");
+            GetRegistryFootprint = (xUnitpp::GetRegistryFootprint)GetProcAddress(module, "GetRegistryFootprint");
         }
 #else
         if ((module = dlopen(tempFile.c_str(), RTLD_LAZY)) != nullptr)
@@ -87,6 +93,9 @@ TestAssembly::TestAssembly(const std::string &file, bool shadowCopy)
             // this weird syntax works around that
             *(void **)(&EnumerateTestDetails) = dlsym(module, "EnumerateTestDetails");
             *(void **)(&FilteredTestsRunner) = dlsym(module, "FilteredTestsRunner");
+            *(void **)(&GetTestManifest) = dlsym(module, "GetTestManifest");
+            *(void **)(&SelectedTestsRunner) = dlsym(module, "SelectedTestsRunner");
+            *(void **)(&GetRegistryFootprint) = dlsym(module, "GetRegistryFootprint");
         }
 #endif
     }
@@ -40,6 +40,11 @@ public:
     xUnitpp::EnumerateTestDetails EnumerateTestDetails;
     xUnitpp::FilteredTestsRunner FilteredTestsRunner;
 
+    // null for libraries built before they were exported
+    xUnitpp::GetTestManifest GetTestManifest;
+    xUnitpp::SelectedTestsRunner SelectedTestsRunner;
+    xUnitpp::GetRegistryFootprint GetRegistryFootprint;
+
 private:
     HMODULE module;
     std::string tempFile;
@@ -0,0 +1,645 @@
+#include "TestFilter.h"
+#include <cctype>
+#include <regex>
+
+namespace
+{
+    // one bit per test in an index
+    typedef std::vector<uint64_t> Bits;
+
+    Bits NoTests(size_t count)
+    {
+        return Bits((count + 63) / 64, 0);
+    }
+
+    void Include(Bits &bits, size_t test)
+    {
+        bits[test / 64] |= 1ULL << (test % 64);
+    }
+
+    void Include(Bits &bits, const std::vector<uint32_t> &tests)
+    {
+        for (auto test : tests)
+        {
+            Include(bits, test);
+        }
+    }
+
+    void Invert(Bits &bits, size_t count)
+    {
+        for (auto &word : bits)
+        {
+            word = ~word;
+        }
+
+        // bits past the last test stay clear
+        if (count % 64 != 0)
+        {
+            bits.back() &= (1ULL << (count % 64)) - 1;
+        }
+    }
+}
+
+namespace xUnitpp { namespace Utilities
+{
+
+struct TestFilter::Node
+{
+    enum Kind
+    {
+        And,
+        Or,
+        Not,
+        Suite,
+        Name,
+        File,
+        Attribute
+    };
+
+    explicit Node(Kind kind)
+        : kind(kind)
+    {
+    }
+
+    Node(Kind kind, std::unique_ptr<Node> left, std::unique_ptr<Node> right = nullptr)
+        : kind(kind)
+        , left(std::move(left))
+        , right(std::move(right))
+    {
+    }
+
+    Kind kind;
+    std::unique_ptr<Node> left;
+    std::unique_ptr<Node> right;
+
+    std::regex pattern;
+
+    // an empty value matches every value of the key
+    std::string key;
+    std::string value;
+};
+
+}}
+
+namespace
+{
+    using xUnitpp::Utilities::TestIndex;
+    typedef xUnitpp::Utilities::TestFilter::Node Node;
+
+    std::unique_ptr<Node> Join(Node::Kind kind, std::unique_ptr<Node> left, std::unique_ptr<Node> right)
+    {
+        if (!left)
+        {
+            return right;
+        }
+
+        return std::unique_ptr<Node>(new Node(kind, std::move(left), std::move(right)));
+    }
+
+    std::unique_ptr<Node> Pattern(Node::Kind kind, const std::string &pattern)
+    {
+        std::unique_ptr<Node> node(new Node(kind));
+        node->pattern = std::regex(pattern, std::regex_constants::icase);
+        return node;
+    }
+
+    std::unique_ptr<Node> Attribute(const std::string &key, const std::string &value)
+    {
+        std::unique_ptr<Node> node(new Node(Node::Attribute));
+        node->key = key;
+        node->value = value;
+        return node;
+    }
+
+    void Match(const std::regex &pattern, const TestIndex::Strings &strings, const std::vector<uint32_t> &column, Bits &bits)
+    {
+        // each distinct string is matched once, however many tests share it
+        std::vector<char> matched(strings.values.size());
+        for (size_t i = 0; i != matched.size(); ++i)
+        {
+            matched[i] = std::regex_search(strings.values[i], pattern);
+        }
+
+        for (size_t test = 0; test != column.size(); ++test)
+        {
+            if (matched[column[test]])
+            {
+                Include(bits, test);
+            }
+        }
+    }
+
+    Bits Evaluate(const Node &node, const TestIndex &index)
+    {
+        switch (node.kind)
+        {
+        case Node::And:
+        case Node::Or:
+            {
+                auto bits = Evaluate(*node.left, index);
+                auto right = Evaluate(*node.right, index);
+
+                for (size_t i = 0; i != bits.size(); ++i)
+                {
+                    bits[i] = node.kind == Node::And ? (bits[i] & right[i]) : (bits[i] | right[i]);
+                }
+
+                return bits;
+            }
+
+        case Node::Not:
+            {
+                auto bits = Evaluate(*node.left, index);
+                Invert(bits, index.size());
+                return bits;
+            }
+
+        case Node::Suite:
+        case Node::Name:
+        case Node::File:
+            {
+                auto bits = NoTests(index.size());
+
+                if (node.kind == Node::Suite)
+                {
+                    Match(node.pattern, index.suites, index.suite, bits);
+                }
+                else if (node.kind == Node::Name)
+                {
+                    Match(node.pattern, index.names, index.name, bits);
+                }
+                else
+                {
+                    Match(node.pattern, index.files, index.file, bits);
+                }
+
+                return bits;
+            }
+
+        case Node::Attribute:
+            {
+                auto bits = NoTests(index.size());
+
+                auto key = index.attributes.find(node.key);
+                if (key != index.attributes.end())
+                {
+                    if (node.value.empty())
+                    {
+                        for (const auto &value : key->second)
+                        {
+                            Include(bits, value.second);
+                        }
+                    }
+                    else
+                    {
+                        auto value = key->second.find(node.value);
+                        if (value != key->second.end())
+                        {
+                            Include(bits, value->second);
+                        }
+                    }
+                }
+
+                return bits;
+            }
+        }
+
+        return NoTests(index.size());
+    }
+
+    class Parser
+    {
+    public:
+        Parser(const std::string &text)
+            : text(text)
+            , pos(0)
+        {
+        }
+
+        std::unique_ptr<Node> Parse()
+        {
+            auto node = Expression();
+
+            SkipSpace();
+            if (node && pos != text.size())
+            {
+                return Fail("Unexpected \"" + text.substr(pos) + "\"");
+            }
+
+            return node;
+        }
+
+        const std::string &Error() const
+        {
+            return error;
+        }
+
+    private:
+        Parser &operator =(Parser) /* = delete */;
+
+        std::unique_ptr<Node> Fail(const std::string &message)
+        {
+            if (error.empty())
+            {
+                error = message + " in filter \"" + text + "\".";
+            }
+
+            return nullptr;
+        }
+
+        void SkipSpace()
+        {
+            while (pos != text.size() && std::isspace((unsigned char)text[pos]))
+            {
+                ++pos;
+            }
+        }
+
+        // an operator, either as a symbol or as a case insensitive word
+        bool Operator(const char *symbol, const char *word)
+        {
+            SkipSpace();
+
+            auto length = std::char_traits<char>::length(symbol);
+            if (text.compare(pos, length, symbol) == 0)
+            {
+                pos += length;
+                return true;
+            }
+
+            length = std::char_traits<char>::length(word);
+            if (pos + length > text.size())
+            {
+                return false;
+            }
+
+            for (size_t i = 0; i != length; ++i)
+            {
+                if (std::tolower((unsigned char)text[pos + i]) != word[i])
+                {
+                    return false;
+                }
+            }
+
+            // "order" is not "or" followed by "der"
+            if (pos + length != text.size() && (std::isalnum((unsigned char)text[pos + length]) || text[pos + length] == '_'))
+            {
+                return false;
+            }
+
+            pos += length;
+            return true;
+        }
+
+        std::unique_ptr<Node> Expression()
+        {
+            auto node = Term();
+
+            while (node && Operator("||", "or"))
+            {
+                auto right = Term();
+                node = right ? Join(Node::Or, std::move(node), std::move(right)) : nullptr;
+            }
+
+            return node;
+        }
+
+        std::unique_ptr<Node> Term()
+        {
+            auto node = Factor();
+
+            while (node && Operator("&&", "and"))
+            {
+                auto right = Factor();
+                node = right ? Join(Node::And, std::move(node), std::move(right)) : nullptr;
+            }
+
+            return node;
+        }
+
+        std::unique_ptr<Node> Factor()
+        {
+            if (Operator("!", "not"))
+            {
+                auto node = Factor();
+                return node ? std::unique_ptr<Node>(new Node(Node::Not, std::move(node))) : nullptr;
+            }
+
+            SkipSpace();
+
+            if (pos != text.size() && text[pos] == '(')
+            {
+                ++pos;
+
+                auto node = Expression();
+
+                SkipSpace();
+                if (pos == text.size() || text[pos] != ')')
+                {
+                    return Fail("Missing \")\"");
+                }
+
+                ++pos;
+                return node;
+            }
+
+            return Match();
+        }
+
+        std::unique_ptr<Node> Match()
+        {
+            auto start = pos;
+            while (pos != text.size() && std::isalpha((unsigned char)text[pos]))
+            {
+                ++pos;
+            }
+
+            std::string field = text.substr(start, pos - start);
+            for (auto &c : field)
+            {
+                c = (char)std::tolower(c);
+            }
+
+            if (pos == text.size() || text[pos] != ':' || field.empty())
+            {
+                pos = start;
+                return Fail(pos == text.size() ? "Expected suite:, name:, file: or attr:" : "Expected suite:, name:, file: or attr: at \"" + text.substr(pos) + "\"");
+            }
+
+            ++pos;
+
+            if (field == "attr")
+            {
+                std::string key, value;
+                if (!Text(key, "=") || key.empty())
+                {
+                    return Fail("attr: expects an attribute name");
+                }
+
+                if (pos != text.size() && text[pos] == '=')
+                {
+                    ++pos;
+
+                    if (!Text(value, ""))
+                    {
+                        return nullptr;
+                    }
+                }
+
+                return Attribute(key, value);
+            }
+
+            Node::Kind kind;
+            if (field == "suite")
+            {
+                kind = Node::Suite;
+            }
+            else if (field == "name")
+            {
+                kind = Node::Name;
+            }
+            else if (field == "file")
+            {
+                kind = Node::File;
+            }
+            else
+            {
+                pos = start;
+                return Fail("Unknown field \"" + field + ":\"");
+            }
+
+            std::string pattern;
+            if (!Text(pattern, "") || pattern.empty())
+            {
+                return Fail(field + ": expects a pattern");
+            }
+
+            try
+            {
+                // compiled once, here, rather than once per test
+                return Pattern(kind, pattern);
+            }
+            catch (const std::regex_error &)
+            {
+                return Fail("\"" + pattern + "\" is not a valid regular expression");
+            }
+        }
+
+        // quoted text, or bare text up to whitespace, a parenthesis or one of `stops`
+        bool Text(std::string &result, const char *stops)
+        {
+            if (pos != text.size() && text[pos] == '"')
+            {
+                for (++pos; pos != text.size() && text[pos] != '"'; ++pos)
+                {
+                    if (text[pos] == '\\' && pos + 1 != text.size())
+                    {
+                        ++pos;
+                    }
+
+                    result += text[pos];
+                }
+
+                if (pos == text.size())
+                {
+                    Fail("Missing closing quote");
+                    return false;
+                }
+
+                ++pos;
+                return true;
+            }
+
+            while (pos != text.size() && !std::isspace((unsigned char)text[pos]) && text[pos] != '(' && text[pos] != ')' &&
+                std::char_traits<char>::find(stops, std::char_traits<char>::length(stops), text[pos]) == nullptr)
+            {
+                result += text[pos++];
+            }
+
+            return true;
+        }
+
+    private:
+        const std::string &text;
+        size_t pos;
+        std::string error;
+    };
+}
+
+namespace xUnitpp { namespace Utilities
+{
+
+uint32_t TestIndex::Strings::Add(const char *value)
+{
+    auto it = lookup.emplace(value == nullptr ? "" : value, (uint32_t)values.size());
+    if (it.second)
+    {
+        values.push_back(it.first->first);
+    }
+
+    return it.first->second;
+}
+
+void TestIndex::Add(const ITestDetails &td)
+{
+    auto test = (uint32_t)ids.size();
+
+    ids.push_back(td.GetId());
+    suite.push_back(suites.Add(td.GetSuite()));
+    name.push_back(names.Add(td.GetName()));
+    file.push_back(files.Add(td.GetFile()));
+
+    for (size_t i = 0; i != td.GetAttributeCount(); ++i)
+    {
+        auto &tests = attributes[td.GetAttributeKey(i)][td.GetAttributeValue(i)];
+
+        // a test listing the same attribute twice is still only one test
+        if (tests.empty() || tests.back() != test)
+        {
+            tests.push_back(test);
+        }
+    }
+}
+
+size_t TestIndex::size() const
+{
+    return ids.size();
+}
+
+int TestIndex::Id(size_t test) const
+{
+    return ids[test];
+}
+
+TestFilter::TestFilter()
+{
+}
+
+TestFilter::~TestFilter()
+{
+}
+
+std::string TestFilter::Parse(const std::string &expression)
+{
+    Parser parser(expression);
+
+    auto node = parser.Parse();
+    if (!node)
+    {
+        return parser.Error().empty() ? "Empty filter." : parser.Error();
+    }
+
+    Require(std::move(node));
+    return "";
+}
+
+std::string TestFilter::RequireAnySuite(const std::vector<std::string> &patterns)
+{
+    std::unique_ptr<Node> node;
+
+    for (const auto &pattern : patterns)
+    {
+        try
+        {
+            node = Join(Node::Or, std::move(node), Pattern(Node::Suite, pattern));
+        }
+        catch (const std::regex_error &)
+        {
+            return "\"" + pattern + "\" is not a valid regular expression.";
+        }
+    }
+
+    Require(std::move(node));
+    return "";
+}
+
+std::string TestFilter::RequireAnyName(const std::vector<std::string> &patterns)
+{
+    std::unique_ptr<Node> node;
+
+    for (const auto &pattern : patterns)
+    {
+        try
+        {
+            node = Join(Node::Or, std::move(node), Pattern(Node::Name, pattern));
+        }
+        catch (const std::regex_error &)
+        {
+            return "\"" + pattern + "\" is not a valid regular expression.";
+        }
+    }
+
+    Require(std::move(node));
+    return "";
+}
+
+void TestFilter::RequireAnyAttribute(const std::multimap<std::string, std::string> &attributes)
+{
+    std::unique_ptr<Node> node;
+
+    for (const auto &attribute : attributes)
+    {
+        node = Join(Node::Or, std::move(node), Attribute(attribute.first, attribute.second));
+    }
+
+    Require(std::move(node));
+}
+
+void TestFilter::ExcludeAllAttributes(const std::multimap<std::string, std::string> &attributes)
+{
+    std::unique_ptr<Node> node;
+
+    for (const auto &attribute : attributes)
+    {
+        node = Join(Node::And, std::move(node), Attribute(attribute.first, attribute.second));
+    }
+
+    if (node)
+    {
+        Require(std::unique_ptr<Node>(new Node(Node::Not, std::move(node))));
+    }
+}
+
+void TestFilter::Require(std::unique_ptr<Node> node)
+{
+    if (node)
+    {
+        root = Join(Node::And, std::move(root), std::move(node));
+    }
+}
+
+std::vector<size_t> TestFilter::Select(const TestIndex &index) const
+{
+    std::vector<size_t> selected;
+
+    if (!root)
+    {
+        selected.reserve(index.size());
+        for (size_t test = 0; test != index.size(); ++test)
+        {
+            selected.push_back(test);
+        }
+
+        return selected;
+    }
+
+    auto bits = Evaluate(*root, index);
+
+    for (size_t word = 0; word != bits.size(); ++word)
+    {
+        for (auto remaining = bits[word]; remaining != 0; remaining &= remaining - 1)
+        {
+            size_t bit = 0;
+            while ((remaining & (1ULL << bit)) == 0)
+            {
+                ++bit;
+            }
+
+            selected.push_back(word * 64 + bit);
+        }
+    }
+
+    return selected;
+}
+
+}}
@@ -0,0 +1,95 @@
+#ifndef TESTFILTER_H_
+#define TESTFILTER_H_
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "xUnit++/ITestDetails.h"
+
+namespace xUnitpp { namespace Utilities
+{
+
+// What a filter needs to know about every test in a library, gathered in one pass over the tests.
+// Suites, names and files are stored once per distinct string, so a pattern is only ever matched
+// against each distinct string once; attributes are inverted, from key and value to the tests that have them.
+class TestIndex
+{
+public:
+    struct Strings
+    {
+        uint32_t Add(const char *value);
+
+        std::vector<std::string> values;
+        std::unordered_map<std::string, uint32_t> lookup;
+    };
+
+    // tests are numbered in the order they are added
+    void Add(const ITestDetails &td);
+
+    size_t size() const;
+    int Id(size_t test) const;
+
+    Strings suites;
+    Strings names;
+    Strings files;
+
+    std::vector<uint32_t> suite;
+    std::vector<uint32_t> name;
+    std::vector<uint32_t> file;
+
+    // key -> value -> the (ascending) tests with that attribute
+    std::unordered_map<std::string, std::map<std::string, std::vector<uint32_t>>> attributes;
+
+private:
+    std::vector<int> ids;
+};
+
+// A boolean expression over tests, parsed and compiled once, then evaluated against a whole TestIndex at a time.
+//
+//   expression := term { ("or" | "||") term }
+//   term       := factor { ("and" | "&&") factor }
+//   factor     := ("not" | "!") factor | "(" expression ")" | match
+//   match      := ("suite" | "name" | "file") ":" pattern | "attr" ":" key [ "=" [value] ]
+//
+// Patterns are case insensitive regular expressions, found anywhere in the text they are matched against.
+// Patterns, keys and values may be quoted with "" when they need spaces, parentheses or '='.
+class TestFilter
+{
+public:
+    // selects every test
+    TestFilter();
+    ~TestFilter();
+
+    // restricts this filter to tests that also match `expression`
+    // returns an error message, or "" if the expression was understood
+    std::string Parse(const std::string &expression);
+
+    // restricts this filter to tests that also pass the console's classic options
+    // the patterns return an error message, or "" if every one is a valid regular expression
+    std::string RequireAnySuite(const std::vector<std::string> &patterns);
+    std::string RequireAnyName(const std::vector<std::string> &patterns);
+    void RequireAnyAttribute(const std::multimap<std::string, std::string> &attributes);
+    void ExcludeAllAttributes(const std::multimap<std::string, std::string> &attributes);
+
+    // the selected tests, ascending
+    std::vector<size_t> Select(const TestIndex &index) const;
+
+public:
+    struct Node;
+
+private:
+    TestFilter(const TestFilter &) /* = delete */;
+    TestFilter &operator =(TestFilter) /* = delete */;
+
+    void Require(std::unique_ptr<Node> node);
+
+private:
+    std::unique_ptr<Node> root;
+};
+
+}}
+
+#endif
@@ -0,0 +1,65 @@
+#include "TimingHistory.h"
+#include "xUnit++/ITestDetails.h"
+#include "xUnit++/TestManifest.h"
+
+#if defined(WIN32)
+#include <Windows.h>
+#else
+#include <cerrno>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace xUnitpp { namespace TimingHistory
+{
+
+std::string FileName(const std::string &directory)
+{
+    if (directory.empty())
+    {
+        return "history.xuh";
+    }
+
+    auto last = directory[directory.size() - 1];
+    return directory + ((last == '/' || last == '\\') ? "" : "/") + "history.xuh";
+}
+
+bool MakeDirectory(const std::string &directory)
+{
+#if defined(WIN32)
+    return CreateDirectoryA(directory.c_str(), nullptr) || GetLastError() == ERROR_ALREADY_EXISTS;
+#else
+    return mkdir(directory.c_str(), 0777) == 0 || errno == EEXIST;
+#endif
+}
+
+std::string HostName()
+{
+#if defined(WIN32)
+    char name[MAX_COMPUTERNAME_LENGTH + 1] = {0};
+    DWORD size = sizeof(name);
+
+    return GetComputerNameA(name, &size) ? std::string(name, size) : "";
+#else
+    char name[256] = {0};
+
+    // a name that doesn't fit isn't guaranteed to be terminated
+    return gethostname(name, sizeof(name) - 1) == 0 ? name : "";
+#endif
+}
+
+uint64_t StableId(const ITestDetails &testDetails, bool stableIds)
+{
+    if (stableIds)
+    {
+        return testDetails.GetStableId();
+    }
+
+    auto stableId = Manifest::StableHash(testDetails.GetSuite(), testDetails.GetName());
+    auto params = testDetails.GetParams();
+
+    return (params == nullptr || *params == '\0') && testDetails.GetTestInstance() == 0 ? stableId :
+        Manifest::StableHash(stableId, testDetails.GetTestInstance(), params != nullptr ? params : "");
+}
+
+}}
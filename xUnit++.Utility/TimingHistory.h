@@ -0,0 +1,95 @@
+#ifndef TIMINGHISTORY_H_
+#define TIMINGHISTORY_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "ResultLog.h"
+
+//
+// How long every test took in every run given the same --history directory, kept in one file there.
+// A header, then records framed exactly as a ResultLog's:
+//
+//   type (1 byte) | payload size (varint) | payload | CRC-32 of everything before it in the record (4 bytes, little endian)
+//
+// Tests are keyed by stable id, written as 8 bytes, little endian, so a test keeps its history while
+// other tests come and go around it. A test's suite and name are written once, the first time the
+// file sees it, and each run is then a single record holding a sample for every test it ran.
+//
+// The file is only ever appended to, a run at a time with one write, so runs sharing a directory
+// (the shards of one run, say) never interleave inside a record. Runs which start together on a new
+// history can't know which of them is first, so each may write the header; a header found where a
+// record should start is skipped, which no record can be mistaken for, since none starts with 'x'.
+// A record cut short by a crash ends the history, as it does a log.
+//
+
+namespace xUnitpp
+{
+    struct ITestDetails;
+}
+
+namespace xUnitpp { namespace TimingHistory
+{
+
+// bumped whenever the layout below changes
+static const uint8_t Version = 1;
+
+static const char Magic[8] = { 'x', 'U', 'n', 'i', 't', '+', '+', 'H' };
+
+// Magic, then Version
+static const size_t HeaderSize = sizeof(Magic) + 1;
+
+static const size_t StableIdSize = 8;
+
+enum RecordType : uint8_t
+{
+    // stable id, suite, full name
+    Name = 1,
+
+    // unix time, host, commit, sample count, then for each sample: stable id, outcome (1 byte), nanoseconds
+    Run = 2
+};
+
+enum Outcome : uint8_t
+{
+    Passed = 0,
+    Failed = 1,
+    Skipped = 2
+};
+
+// where the history of `directory` is kept
+std::string FileName(const std::string &directory);
+
+// creates `directory` when it doesn't exist yet; false if it still doesn't
+bool MakeDirectory(const std::string &directory);
+
+// the name of the machine running the tests, or "" when it won't say
+std::string HostName();
+
+// the key of a test's history: its stable id, or for libraries built before ITestDetails::GetStableId
+// (no `stableIds`), the same hash worked out from its suite, name and params
+uint64_t StableId(const ITestDetails &testDetails, bool stableIds);
+
+inline void WriteStableId(std::string &out, uint64_t stableId)
+{
+    for (size_t byte = 0; byte != StableIdSize; ++byte, stableId >>= 8)
+    {
+        out += (char)(uint8_t)stableId;
+    }
+}
+
+inline uint64_t ReadStableId(const uint8_t *in)
+{
+    uint64_t stableId = 0;
+
+    for (size_t byte = StableIdSize; byte != 0; --byte)
+    {
+        stableId = (stableId << 8) | in[byte - 1];
+    }
+
+    return stableId;
+}
+
+}}
+
+#endif
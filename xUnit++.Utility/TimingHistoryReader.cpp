@@ -0,0 +1,175 @@
+#include "TimingHistoryReader.h"
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+    // false, and nothing read, when the text isn't terminated before `end`
+    bool ReadText(const uint8_t *&in, const uint8_t *end, const char *&text)
+    {
+        auto terminator = static_cast<const uint8_t *>(std::memchr(in, 0, end - in));
+        if (terminator == nullptr)
+        {
+            return false;
+        }
+
+        text = reinterpret_cast<const char *>(in);
+        in = terminator + 1;
+        return true;
+    }
+}
+
+namespace xUnitpp { namespace Utilities
+{
+
+TimingHistoryReader::Test::Test()
+    : suite("")
+    , name("")
+{
+}
+
+bool TimingHistoryReader::Readable(const void *data, size_t size)
+{
+    if (data == nullptr || size < TimingHistory::HeaderSize)
+    {
+        return false;
+    }
+
+    auto bytes = static_cast<const char *>(data);
+    return std::equal(bytes, bytes + sizeof(TimingHistory::Magic), TimingHistory::Magic) && (uint8_t)bytes[sizeof(TimingHistory::Magic)] == TimingHistory::Version;
+}
+
+TimingHistoryReader::TimingHistoryReader(const void *data, size_t size)
+    : data(static_cast<const uint8_t *>(data))
+    , validSize(TimingHistory::HeaderSize)
+{
+    auto end = this->data + size;
+
+    for (auto record = this->data + validSize; record != end; )
+    {
+        // runs which start together on a new history each write the header (see TimingHistory.h)
+        if (Readable(record, end - record))
+        {
+            record += TimingHistory::HeaderSize;
+            validSize = record - this->data;
+            continue;
+        }
+
+        auto in = record + 1;
+
+        uint64_t payloadSize;
+        if (!ResultLog::ReadVarint(in, end, payloadSize) || payloadSize > (uint64_t)(end - in) || (uint64_t)(end - in) - payloadSize < ResultLog::CrcSize)
+        {
+            break;
+        }
+
+        auto payload = in;
+        auto payloadEnd = payload + payloadSize;
+
+        uint32_t crc = payloadEnd[0] | (payloadEnd[1] << 8) | (payloadEnd[2] << 16) | ((uint32_t)payloadEnd[3] << 24);
+        if (crc != ResultLog::Crc32(record, payloadEnd - record))
+        {
+            break;
+        }
+
+        bool whole = true;
+
+        if (*record == TimingHistory::Name)
+        {
+            const char *suite;
+            const char *name;
+
+            whole = payloadSize >= TimingHistory::StableIdSize;
+            in = payload + TimingHistory::StableIdSize;
+
+            if (whole && ReadText(in, payloadEnd, suite) && ReadText(in, payloadEnd, name))
+            {
+                auto &test = tests[TimingHistory::ReadStableId(payload)];
+                test.suite = suite;
+                test.name = name;
+            }
+            else
+            {
+                whole = false;
+            }
+        }
+        else if (*record == TimingHistory::Run)
+        {
+            uint64_t time;
+            uint64_t count;
+            Run run;
+
+            whole = ResultLog::ReadVarint(in, payloadEnd, time) && ReadText(in, payloadEnd, run.host) && ReadText(in, payloadEnd, run.commit) &&
+                ResultLog::ReadVarint(in, payloadEnd, count);
+
+            run.time = (long long)time;
+
+            // samples are only indexed once the whole run has read
+            std::vector<std::pair<uint64_t, Sample>> samples;
+
+            for (; whole && count != 0; --count)
+            {
+                uint64_t ns;
+
+                if ((size_t)(payloadEnd - in) < TimingHistory::StableIdSize + 1)
+                {
+                    whole = false;
+                    break;
+                }
+
+                auto stableId = TimingHistory::ReadStableId(in);
+                in += TimingHistory::StableIdSize;
+
+                Sample sample;
+                sample.run = runs.size();
+                sample.outcome = (TimingHistory::Outcome)*in++;
+
+                whole = ResultLog::ReadVarint(in, payloadEnd, ns);
+                sample.ns = (long long)ns;
+
+                samples.push_back(std::make_pair(stableId, sample));
+            }
+
+            if (whole)
+            {
+                for (auto &sample : samples)
+                {
+                    tests[sample.first].samples.push_back(sample.second);
+                }
+
+                runs.push_back(run);
+            }
+        }
+
+        if (!whole)
+        {
+            break;
+        }
+
+        record = payloadEnd + ResultLog::CrcSize;
+        validSize = record - this->data;
+    }
+}
+
+size_t TimingHistoryReader::size() const
+{
+    return validSize;
+}
+
+const std::vector<TimingHistoryReader::Run> &TimingHistoryReader::Runs() const
+{
+    return runs;
+}
+
+const TimingHistoryReader::Test *TimingHistoryReader::Find(uint64_t stableId) const
+{
+    auto it = tests.find(stableId);
+    return it != tests.end() ? &it->second : nullptr;
+}
+
+const std::unordered_map<uint64_t, TimingHistoryReader::Test> &TimingHistoryReader::Tests() const
+{
+    return tests;
+}
+
+}}
@@ -0,0 +1,71 @@
+#ifndef TIMINGHISTORYREADER_H_
+#define TIMINGHISTORYREADER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include "TimingHistory.h"
+
+namespace xUnitpp { namespace Utilities
+{
+
+// A view of a TimingHistory someone else owns, usually a MappedFile. Every sample is indexed
+// by its test when this is made; the strings handed out point into the history.
+class TimingHistoryReader
+{
+public:
+    // false unless `data` starts with the header of a history version this reader understands
+    static bool Readable(const void *data, size_t size);
+
+    // `data` must be Readable
+    // every record's CRC is checked here, and the history ends at the first record that isn't whole
+    TimingHistoryReader(const void *data, size_t size);
+
+    // how much of `data` is header and whole records
+    size_t size() const;
+
+    struct Run
+    {
+        long long time;         // seconds since the unix epoch
+        const char *host;
+        const char *commit;
+    };
+
+    // oldest first
+    const std::vector<Run> &Runs() const;
+
+    struct Sample
+    {
+        size_t run;             // into Runs
+        TimingHistory::Outcome outcome;
+        long long ns;
+    };
+
+    struct Test
+    {
+        Test();
+
+        const char *suite;
+        const char *name;
+
+        // oldest first
+        std::vector<Sample> samples;
+    };
+
+    // nullptr for a test this history has never seen
+    const Test *Find(uint64_t stableId) const;
+
+    const std::unordered_map<uint64_t, Test> &Tests() const;
+
+private:
+    const uint8_t *data;
+    size_t validSize;
+
+    std::vector<Run> runs;
+    std::unordered_map<uint64_t, Test> tests;
+};
+
+}}
+
+#endif
@@ -0,0 +1,121 @@
+#include "TimingHistoryReporter.h"
+#include <ctime>
+#include "xUnit++/ITestDetails.h"
+#include "xUnit++/ITestEvent.h"
+#include "TimingHistoryReader.h"
+
+namespace
+{
+    void WriteText(std::string &out, const char *text)
+    {
+        if (text != nullptr)
+        {
+            out += text;
+        }
+
+        out += '\0';
+    }
+}
+
+namespace xUnitpp { namespace Utilities
+{
+
+TimingHistoryReporter::TimingHistoryReporter(std::ostream &output, const TimingHistoryReader *history, const std::string &host, const std::string &commit, bool stableIds)
+    : output(output)
+    , history(history)
+    , host(host)
+    , commit(commit)
+    , stableIds(stableIds)
+    , sampleCount(0)
+{
+    if (history == nullptr)
+    {
+        buffer.append(TimingHistory::Magic, sizeof(TimingHistory::Magic));
+        buffer += (char)TimingHistory::Version;
+    }
+}
+
+TimingHistoryReporter::~TimingHistoryReporter() noexcept(true)
+{
+}
+
+void TimingHistoryReporter::WriteRecord(TimingHistory::RecordType type, const std::string &payload)
+{
+    auto begin = buffer.size();
+
+    buffer += (char)type;
+    ResultLog::WriteVarint(buffer, payload.size());
+    buffer += payload;
+
+    auto crc = ResultLog::Crc32(buffer.data() + begin, buffer.size() - begin);
+    for (int byte = 0; byte != 4; ++byte, crc >>= 8)
+    {
+        buffer += (char)(uint8_t)crc;
+    }
+}
+
+void TimingHistoryReporter::AddSample(const ITestDetails &testDetails, TimingHistory::Outcome outcome, long long ns)
+{
+    auto stableId = TimingHistory::StableId(testDetails, stableIds);
+
+    auto known = history != nullptr ? history->Find(stableId) : nullptr;
+
+    // a test is named once, the first time the history sees it
+    if ((known == nullptr || *known->name == '\0') && named.insert(stableId).second)
+    {
+        std::string name;
+        TimingHistory::WriteStableId(name, stableId);
+        WriteText(name, testDetails.GetSuite());
+        WriteText(name, testDetails.GetFullName());
+        WriteRecord(TimingHistory::Name, name);
+    }
+
+    TimingHistory::WriteStableId(samples, stableId);
+    samples += (char)outcome;
+    ResultLog::WriteVarint(samples, (uint64_t)(ns < 0 ? 0 : ns));
+    ++sampleCount;
+}
+
+void TimingHistoryReporter::ReportStart(const ITestDetails &)
+{
+}
+
+void TimingHistoryReporter::ReportEvent(const ITestDetails &testDetails, const ITestEvent &evt)
+{
+    if (evt.GetIsFailure())
+    {
+        failed.insert(testDetails.GetId());
+    }
+}
+
+void TimingHistoryReporter::ReportSkip(const ITestDetails &testDetails, const char *)
+{
+    AddSample(testDetails, TimingHistory::Skipped, 0);
+}
+
+void TimingHistoryReporter::ReportFinish(const ITestDetails &testDetails, long long nsTaken)
+{
+    AddSample(testDetails, failed.erase(testDetails.GetId()) != 0 ? TimingHistory::Failed : TimingHistory::Passed, nsTaken);
+}
+
+void TimingHistoryReporter::ReportAllTestsComplete(size_t, size_t, size_t, long long)
+{
+    std::string run;
+    ResultLog::WriteVarint(run, (uint64_t)std::time(nullptr));
+    WriteText(run, host.c_str());
+    WriteText(run, commit.c_str());
+    ResultLog::WriteVarint(run, sampleCount);
+    run += samples;
+
+    WriteRecord(TimingHistory::Run, run);
+
+    // one write, so a run sharing the file with another lands whole, before or after it
+    output.write(buffer.data(), (std::streamsize)buffer.size());
+    output.flush();
+
+    buffer.clear();
+    samples.clear();
+    sampleCount = 0;
+}
+
+}}
@@ -0,0 +1,68 @@
+#ifndef TIMINGHISTORYREPORTER_H_
+#define TIMINGHISTORYREPORTER_H_
+
+#if defined(_MSC_VER)
+# if !defined(_ALLOW_KEYWORD_MACROS)
+#  define _ALLOW_KEYWORD_MACROS
+# endif
+#define noexcept(x)
+#endif
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <unordered_set>
+#include <vector>
+#include "xUnit++/IOutput.h"
+#include "TimingHistory.h"
+
+namespace xUnitpp { namespace Utilities
+{
+
+class TimingHistoryReader;
+
+// Adds a run to a TimingHistory (see TimingHistory.h): how long each test took, and whether it passed.
+// Nothing is written until the run is complete, and then all of it is written at once, to the end of `output`.
+class TimingHistoryReporter : public IOutput
+{
+public:
+    // `history` is what `output` already holds, so tests it has already named aren't named again;
+    // when it is nullptr, `output` is taken to be empty and the header is written first, which is
+    // harmless if another run got there first: readers skip a repeated header
+    // libraries built before ITestDetails::GetStableId have no `stableIds` (see TimingHistory::StableId)
+    TimingHistoryReporter(std::ostream &output, const TimingHistoryReader *history, const std::string &host, const std::string &commit, bool stableIds);
+    virtual ~TimingHistoryReporter() noexcept(true);
+
+    virtual void __stdcall ReportStart(const ITestDetails &testDetails) override;
+    virtual void __stdcall ReportEvent(const ITestDetails &testDetails, const ITestEvent &evt) override;
+    virtual void __stdcall ReportSkip(const ITestDetails &testDetails, const char *reason) override;
+    virtual void __stdcall ReportFinish(const ITestDetails &testDetails, long long nsTaken) override;
+    virtual void __stdcall ReportAllTestsComplete(size_t testCount, size_t skipped, size_t failureCount, long long nsTotal) override;
+
+private:
+    TimingHistoryReporter &operator =(TimingHistoryReporter) /* = delete; */;
+
+    void AddSample(const ITestDetails &testDetails, TimingHistory::Outcome outcome, long long ns);
+    void WriteRecord(TimingHistory::RecordType type, const std::string &payload);
+
+private:
+    std::ostream &output;
+    const TimingHistoryReader *history;
+    std::string host;
+    std::string commit;
+    bool stableIds;
+
+    std::unordered_set<int> failed;
+    std::unordered_set<uint64_t> named;
+
+    // the header, if it is needed, then a Name record for each test new to the history
+    std::string buffer;
+
+    // the Run record's samples
+    std::string samples;
+    size_t sampleCount;
+};
+
+}}
+
+#endif
@@ -0,0 +1,377 @@
+#include "XmlMerge.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <thread>
+#include <utility>
+#include "tinyxml2.h"
+#include "XmlReporter.h"
+
+namespace
+{
+    std::string Attribute(const tinyxml2::XMLElement *element, const char *name)
+    {
+        auto value = element->Attribute(name);
+        return value != nullptr ? value : "";
+    }
+
+    void XmlAttribute(std::string &xml, const char *name, const std::string &value)
+    {
+        xml += ' ';
+        xml += name;
+        xml += "=\"";
+        xUnitpp::Utilities::XmlEscape(xml, value);
+        xml += '"';
+    }
+
+    template<typename T>
+    void XmlAttribute(std::string &xml, const char *name, T value)
+    {
+        xml += ' ';
+        xml += name;
+        xml += "=\"";
+        xml += std::to_string(value);
+        xml += '"';
+    }
+}
+
+namespace xUnitpp { namespace Utilities
+{
+
+struct XmlMerge::Test
+{
+    std::string name;
+    std::string stableId;
+    double time;
+    std::vector<std::pair<std::string, std::string>> properties;
+    std::vector<std::string> failures;
+    bool skipped;
+    std::string skipMessage;
+
+    // replaced by a retry read later
+    bool dropped;
+};
+
+struct XmlMerge::Suite
+{
+    Suite(const std::string &name)
+        : name(name)
+    {
+    }
+
+    std::string name;
+    std::vector<Test> tests;
+
+    // the input each test was last read from, and where its tests from that input are, by Key
+    std::unordered_map<std::string, std::pair<size_t, std::vector<size_t>>> byKey;
+
+    // a test is known by its stable id; xml from libraries without them only has its name to go on
+    static std::string Key(const Test &test)
+    {
+        return test.stableId.empty() ? "name " + test.name : "id " + test.stableId;
+    }
+};
+
+// one input, parsed and copied out of its document, so the document can go
+struct XmlMerge::Input
+{
+    std::string error;
+    double time;
+    std::vector<std::pair<std::string, std::vector<Test>>> suites;
+};
+
+XmlMerge::XmlMerge()
+    : time(0)
+    , retried(0)
+{
+}
+
+XmlMerge::~XmlMerge()
+{
+}
+
+std::string XmlMerge::ReadFiles(const std::vector<std::string> &files, unsigned int threads)
+{
+    return Read(files.size(), threads,
+        [&](size_t i, tinyxml2::XMLDocument &document) { return (int)document.LoadFile(files[i].c_str()); },
+        [&](size_t i) { return files[i]; });
+}
+
+std::string XmlMerge::ReadDocuments(const std::vector<std::string> &documents, unsigned int threads)
+{
+    return Read(documents.size(), threads,
+        [&](size_t i, tinyxml2::XMLDocument &document) { return (int)document.Parse(documents[i].data(), documents[i].size()); },
+        [&](size_t i) { return "document " + std::to_string(i); });
+}
+
+std::string XmlMerge::Read(size_t count, unsigned int threads, const std::function<int (size_t, tinyxml2::XMLDocument &)> &load,
+    const std::function<std::string (size_t)> &name)
+{
+    std::vector<Input> inputs(count);
+    std::atomic<size_t> next(0);
+
+    // parsing is most of the work, and each input is parsed on its own
+    auto parse = [&]()
+        {
+            for (size_t i = next++; i < count; i = next++)
+            {
+                auto &input = inputs[i];
+
+                tinyxml2::XMLDocument document;
+                if (load(i, document) != tinyxml2::XML_SUCCESS)
+                {
+                    input.error = name(i) + ": not readable as xml (tinyxml2 error " + std::to_string(document.ErrorID()) + ").";
+                    continue;
+                }
+
+                auto root = document.FirstChildElement("testsuites");
+                if (root == nullptr)
+                {
+                    input.error = name(i) + ": not xUnit++ xml results; there is no testsuites element.";
+                    continue;
+                }
+
+                input.time = root->DoubleAttribute("time");
+
+                for (auto suite = root->FirstChildElement("testsuite"); suite != nullptr; suite = suite->NextSiblingElement("testsuite"))
+                {
+                    input.suites.push_back(std::make_pair(Attribute(suite, "name"), std::vector<Test>()));
+                    auto &tests = input.suites.back().second;
+
+                    for (auto testcase = suite->FirstChildElement("testcase"); testcase != nullptr; testcase = testcase->NextSiblingElement("testcase"))
+                    {
+                        Test test;
+                        test.name = Attribute(testcase, "name");
+                        test.time = testcase->DoubleAttribute("time");
+                        test.skipped = false;
+                        test.dropped = false;
+
+                        for (auto child = testcase->FirstChildElement(); child != nullptr; child = child->NextSiblingElement())
+                        {
+                            if (std::strcmp(child->Name(), "property") == 0)
+                            {
+                                test.properties.push_back(std::make_pair(Attribute(child, "name"), Attribute(child, "value")));
+
+                                if (test.properties.back().first == XmlStableIdProperty)
+                                {
+                                    test.stableId = test.properties.back().second;
+                                }
+                            }
+                            else if (std::strcmp(child->Name(), "failure") == 0)
+                            {
+                                test.failures.push_back(Attribute(child, "message"));
+                            }
+                            else if (std::strcmp(child->Name(), "skipped") == 0)
+                            {
+                                test.skipped = true;
+                                test.skipMessage = Attribute(child, "message");
+                            }
+                        }
+
+                        tests.push_back(std::move(test));
+                    }
+                }
+            }
+        };
+
+    threads = std::max(1U, std::min(threads, (unsigned int)count));
+
+    std::vector<std::thread> pool;
+    for (unsigned int thread = 1; thread < threads; ++thread)
+    {
+        pool.push_back(std::thread(parse));
+    }
+
+    parse();
+
+    for (auto &thread : pool)
+    {
+        thread.join();
+    }
+
+    // merged in the order given, so later inputs are the retries
+    std::string errors;
+
+    for (size_t i = 0; i != count; ++i)
+    {
+        if (!inputs[i].error.empty())
+        {
+            errors += inputs[i].error + "\n";
+        }
+        else
+        {
+            Merge(inputs[i], i);
+        }
+
+        inputs[i] = Input();
+    }
+
+    return errors;
+}
+
+void XmlMerge::Merge(Input &input, size_t order)
+{
+    time += input.time;
+
+    for (auto &suiteTests : input.suites)
+    {
+        auto &suite = suites[suiteTests.first];
+        if (!suite)
+        {
+            suite.reset(new Suite(suiteTests.first));
+        }
+
+        std::unordered_map<std::string, size_t> inputCounts;
+        for (auto &test : suiteTests.second)
+        {
+            ++inputCounts[Suite::Key(test)];
+        }
+
+        for (auto &test : suiteTests.second)
+        {
+            auto key = Suite::Key(test);
+            auto &known = suite->byKey[key];
+
+            // Tests can share a key within one run, so only another input's tests are retries, and only when
+            // there are as many of them as there are already: a shard with fewer namesakes than those read so
+            // far has tests of its own, not retries. With stable ids there is one test to a key.
+            if (!known.second.empty() && known.first != order && inputCounts[key] >= known.second.size())
+            {
+                for (auto earlier : known.second)
+                {
+                    suite->tests[earlier].dropped = true;
+                }
+
+                retried += known.second.size();
+                known.second.clear();
+            }
+
+            known.first = order;
+            known.second.push_back(suite->tests.size());
+            suite->tests.push_back(std::move(test));
+        }
+    }
+}
+
+void XmlMerge::Write(std::ostream &output) const
+{
+    std::vector<const Suite *> sorted;
+    for (auto &suite : suites)
+    {
+        sorted.push_back(suite.second.get());
+    }
+
+    std::sort(sorted.begin(), sorted.end(), [](const Suite *lhs, const Suite *rhs) { return lhs->name < rhs->name; });
+
+    size_t totalTests = 0;
+    size_t totalFailed = 0;
+    std::string body;
+
+    for (auto suite : sorted)
+    {
+        // like XmlReporter, a suite counts failure messages, and the root counts failed tests
+        size_t tests = 0;
+        size_t failures = 0;
+        size_t skipped = 0;
+        double suiteTime = 0;
+
+        std::string xml;
+
+        for (auto &test : suite->tests)
+        {
+            if (test.dropped)
+            {
+                continue;
+            }
+
+            ++tests;
+            failures += test.failures.size();
+            totalFailed += test.failures.empty() ? 0 : 1;
+            skipped += test.skipped ? 1 : 0;
+            suiteTime += test.time;
+
+            xml += "      <testcase";
+            XmlAttribute(xml, "name", test.name);
+            XmlAttribute(xml, "time", test.time);
+
+            if (test.properties.empty() && test.failures.empty() && !test.skipped)
+            {
+                xml += " />\n";
+                continue;
+            }
+
+            xml += ">\n";
+
+            for (auto &property : test.properties)
+            {
+                xml += "         <property";
+                XmlAttribute(xml, "name", property.first);
+                XmlAttribute(xml, "value", property.second);
+                xml += " />\n";
+            }
+
+            for (auto &failure : test.failures)
+            {
+                xml += "         <failure";
+                XmlAttribute(xml, "message", failure);
+                xml += " />\n";
+            }
+
+            if (test.skipped)
+            {
+                xml += "         <skipped";
+                XmlAttribute(xml, "message", test.skipMessage);
+                xml += " />\n";
+            }
+
+            xml += "      </testcase>\n";
+        }
+
+        if (tests == 0)
+        {
+            continue;
+        }
+
+        totalTests += tests;
+
+        body += "   <testsuite";
+        XmlAttribute(body, "name", suite->name);
+        XmlAttribute(body, "tests", tests);
+        XmlAttribute(body, "failures", failures);
+        XmlAttribute(body, "skipped", skipped);
+        XmlAttribute(body, "time", suiteTime);
+        body += ">\n";
+        body += xml;
+        body += "   </testsuite>\n";
+    }
+
+    std::string root = "<?xml version=\"1.0\" encoding=\"utf-8\" ?>\n<testsuites";
+    XmlAttribute(root, "tests", totalTests);
+    XmlAttribute(root, "failures", totalFailed);
+    XmlAttribute(root, "time", time);
+    root += ">\n";
+
+    output << root << body << "</testsuites>\n";
+}
+
+size_t XmlMerge::Tests() const
+{
+    size_t tests = 0;
+
+    for (auto &suite : suites)
+    {
+        for (auto &test : suite.second->tests)
+        {
+            tests += test.dropped ? 0 : 1;
+        }
+    }
+
+    return tests;
+}
+
+size_t XmlMerge::Retried() const
+{
+    return retried;
+}
+
+}}
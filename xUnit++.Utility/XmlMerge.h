@@ -0,0 +1,66 @@
+#ifndef XMLMERGE_H_
+#define XMLMERGE_H_
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace tinyxml2
+{
+    class XMLDocument;
+}
+
+namespace xUnitpp { namespace Utilities
+{
+
+// Merges the xml that XmlReporter writes for several runs, usually the shards of one run, into one report
+// in the same format. Suites with the same name are combined, and their counts and times worked out again.
+// A test in more than one input was retried, and only its results from the input read last are kept. Tests are
+// matched by the stable id XmlReporter writes with them, so namesakes in different shards are kept apart; xml
+// without stable ids is matched by name, and a later input is only taken for a retry when it has at least as
+// many tests of that name.
+class XmlMerge
+{
+public:
+    XmlMerge();
+    ~XmlMerge();
+
+    // parses up to `threads` files at once, then merges them in the order given
+    // returns why any of them couldn't be read, a line each; the rest are still merged
+    std::string ReadFiles(const std::vector<std::string> &files, unsigned int threads);
+
+    // the same, for documents already in memory
+    std::string ReadDocuments(const std::vector<std::string> &documents, unsigned int threads);
+
+    void Write(std::ostream &output) const;
+
+    size_t Tests() const;
+
+    // tests dropped in favour of a later retry
+    size_t Retried() const;
+
+private:
+    XmlMerge(const XmlMerge &) /* = delete */;
+    XmlMerge &operator =(const XmlMerge &) /* = delete */;
+
+    struct Test;
+    struct Suite;
+    struct Input;
+
+    std::string Read(size_t count, unsigned int threads, const std::function<int (size_t, tinyxml2::XMLDocument &)> &load,
+        const std::function<std::string (size_t)> &name);
+    void Merge(Input &input, size_t order);
+
+private:
+    std::unordered_map<std::string, std::unique_ptr<Suite>> suites;
+    double time;
+    size_t retried;
+};
+
+}}
+
+#endif
@@ -1,8 +1,11 @@
 #include "XmlReporter.h"
 #include <algorithm>
 #include <chrono>
+#include <cstdio>
 #include <fstream>
 #include <iostream>
+#include <string>
+#include <utility>
 #include <vector>
 #include "xUnit++/ITestDetails.h"
 #include "xUnit++/ITestEvent.h"
@@ -13,13 +16,29 @@ namespace
 {
     struct TestResult
     {
-        TestResult(const xUnitpp::ITestDetails &testDetails)
-            : testDetails(testDetails)
+        // test details are only valid during a report call, so keep copies of what gets written
+        TestResult(const xUnitpp::ITestDetails &testDetails, bool stableIds)
+            : fullName(testDetails.GetFullName())
+            , lineInfo(testDetails.GetFile(), testDetails.GetLine())
             , status(Success)
         {
+            if (stableIds)
+            {
+                char hex[17];
+                std::snprintf(hex, sizeof(hex), "%016llx", testDetails.GetStableId());
+                stableId = hex;
+            }
+
+            for (auto i = 0U; i != testDetails.GetAttributeCount(); ++i)
+            {
+                attributes.push_back(std::make_pair(std::string(testDetails.GetAttributeKey(i)), std::string(testDetails.GetAttributeValue(i))));
+            }
         }
 
-        const xUnitpp::ITestDetails &testDetails;
+        std::string fullName;
+        std::string stableId;
+        std::vector<std::pair<std::string, std::string>> attributes;
+        xUnitpp::LineInfo lineInfo;
 
         enum
         {
@@ -38,15 +57,12 @@ namespace
 
 struct xUnitpp::Utilities::XmlReporter::SuiteResult
 {
-    SuiteResult()
-    {
-    }
-
     SuiteResult(const std::string &name)
         : name(name)
         , tests(0)
         , failures(0)
         , skipped(0)
+        , finished(0)
     {
     }
 
@@ -54,20 +70,28 @@ struct xUnitpp::Utilities::XmlReporter::SuiteResult
     int tests;
     int failures;
     int skipped;
+    size_t finished;
 
     std::vector<TestResult> testResults;
 };
 
 namespace
 {
-    TestResult &GetTestResult(std::vector<TestResult> &testResults, const std::string &fullName)
+    typedef std::unordered_map<int, std::pair<xUnitpp::Utilities::XmlReporter::SuiteResult *, size_t>> RunningTests;
+
+    // room for the totals on the root element, which are only known at the end; numbers never need more
+    const size_t TotalsWidth = 100;
+
+    // nullptr for a test that never started, or has already finished, whose reports are dropped
+    TestResult *GetTestResult(const RunningTests &runningTests, const xUnitpp::ITestDetails &testDetails)
     {
-        // if fullName isn't found it's a bug: go ahead and crash :P
-        return *std::find_if(testResults.begin(), testResults.end(),
-            [&](const TestResult &test)
-            {
-                return test.testDetails.GetFullName() == fullName;
-            });
+        auto running = runningTests.find(testDetails.GetId());
+        if (running == runningTests.end())
+        {
+            return nullptr;
+        }
+
+        return &running->second.first->testResults[running->second.second];
     }
 
     float SuiteTime(const xUnitpp::Utilities::XmlReporter::SuiteResult &suiteResult)
@@ -82,30 +106,11 @@ namespace
         return xUnitpp::Time::ToSeconds(timeTaken).count();
     }
 
-    void ReplaceChar(std::string &str, char c, const std::string &replacement)
-    {
-        for (size_t pos = str.find(c); pos != std::string::npos; pos = str.find(c, pos + 1))
-        {
-            str.replace(pos, 1, replacement);
-        }
-    }
-
-    std::string XmlEscape(const std::string &value)
-    {
-        std::string escaped = value;
-
-        ReplaceChar(escaped, '&', "&amp;");
-        ReplaceChar(escaped, '<', "&lt;");
-        ReplaceChar(escaped, '>', "&gt;");
-        ReplaceChar(escaped, '\'', "&apos;");
-        ReplaceChar(escaped, '\"', "&quot;");
-
-        return escaped;
-    }
-
     std::string XmlAttribute(const std::string &name, const std::string &value)
     {
-        return " " + name + "=\"" + value + "\"";
+        std::string attribute = " " + name + "=\"";
+        xUnitpp::Utilities::XmlEscape(attribute, value);
+        return attribute + "\"";
     }
 
     std::string XmlAttribute(const std::string &name, const char *value)
@@ -116,7 +121,7 @@ namespace
     template<typename T>
     std::string XmlAttribute(const std::string &name, T value)
     {
-        return XmlAttribute(name, std::to_string(value));
+        return " " + name + "=\"" + std::to_string(value) + "\"";
     }
 
     std::string XmlBeginDoc()
@@ -128,15 +133,13 @@ namespace
             " ?>\n";
     }
 
-    std::string XmlBeginResults(size_t tests, size_t failures, long long nsTotal)
+    std::string XmlTotals(size_t tests, size_t failures, long long nsTotal)
     {
         xUnitpp::Time::Duration totalTime(nsTotal);
         return
-            "<testsuites" +
-                XmlAttribute("tests", tests) +
-                XmlAttribute("failures", failures) +
-                XmlAttribute("time", xUnitpp::Time::ToSeconds(totalTime).count()) +
-            ">\n";
+            XmlAttribute("tests", tests) +
+            XmlAttribute("failures", failures) +
+            XmlAttribute("time", xUnitpp::Time::ToSeconds(totalTime).count());
     }
 
     std::string XmlEndResults()
@@ -197,7 +200,7 @@ namespace
         {
             result += std::string("         ") +
                 "<failure" +
-                    XmlAttribute("message", fileAndLine + ": " + XmlEscape(message)) +
+                    XmlAttribute("message", fileAndLine + ": " + message) +
                 " />\n";
         }
 
@@ -208,16 +211,88 @@ namespace
     {
         return std::string("         ") +
             "<skipped" +
-                XmlAttribute("message", XmlEscape(message)) +
-            "</skipped>\n";
+                XmlAttribute("message", message) +
+            " />\n";
+    }
+
+    std::string XmlSuite(const xUnitpp::Utilities::XmlReporter::SuiteResult &suite)
+    {
+        std::string xml = XmlBeginSuite(suite);
+
+        for (const auto &test : suite.testResults)
+        {
+            xml += XmlBeginTest(test.fullName, test);
+
+            bool singleTag = test.status == TestResult::Success && test.attributes.empty() && test.stableId.empty();
+
+            if (!singleTag)
+            {
+                // close <TestCase>
+                xml += ">\n";
+            }
+
+            if (!test.stableId.empty())
+            {
+                xml += XmlTestAttribute(xUnitpp::Utilities::XmlStableIdProperty, test.stableId);
+            }
+
+            for (const auto &attribute : test.attributes)
+            {
+                if (attribute.first != "Skip")
+                {
+                    xml += XmlTestAttribute(attribute.first, attribute.second);
+                }
+            }
+
+            if (test.status == TestResult::Failure)
+            {
+                xml += XmlTestFailed(to_string(test.lineInfo), test.messages);
+            }
+            else if (test.status == TestResult::Skipped)
+            {
+                xml += XmlTestSkipped(test.messages[0]);
+            }
+
+            xml += XmlEndTest(singleTag);
+        }
+
+        return xml + XmlEndSuite();
     }
 }
 
 namespace xUnitpp { namespace Utilities
 {
 
-XmlReporter::XmlReporter(std::ostream &output)
+// line breaks are kept as references, since attribute values lose them otherwise
+void XmlEscape(std::string &escaped, const std::string &value)
+{
+    escaped.reserve(escaped.size() + value.size());
+
+    for (auto c : value)
+    {
+        switch (c)
+        {
+        case '&': escaped += "&amp;"; break;
+        case '<': escaped += "&lt;"; break;
+        case '>': escaped += "&gt;"; break;
+        case '\'': escaped += "&apos;"; break;
+        case '\"': escaped += "&quot;"; break;
+        case '\n': escaped += "&#10;"; break;
+        case '\r': escaped += "&#13;"; break;
+        case '\t': escaped += "&#9;"; break;
+        default:
+            // no other control character may appear in xml 1.0, not even as a reference
+            escaped += ((unsigned char)c < 0x20) ? '?' : c;
+            break;
+        }
+    }
+}
+
+XmlReporter::XmlReporter(std::ostream &output, bool stableIds)
     : output(output)
+    , stableIds(stableIds)
+    , begun(false)
+    , totalsAt(-1)
 {
 }
 
@@ -225,77 +300,123 @@ XmlReporter::~XmlReporter() noexcept(true)
 {
 }
 
-void XmlReporter::ReportAllTestsComplete(size_t testCount, size_t, size_t failureCount, long long nsTotal)
+void XmlReporter::ExpectTests(const std::string &suite, size_t tests)
 {
-    output << XmlBeginDoc();
-    output << XmlBeginResults(testCount, failureCount, nsTotal);
+    expectedTests[suite] = tests;
+}
 
-    for (const auto &itSuite : suiteResults)
+XmlReporter::SuiteResult &XmlReporter::Suite(const ITestDetails &testDetails)
+{
+    auto &suiteResult = suiteResults[testDetails.GetSuite()];
+    if (!suiteResult)
     {
-        output << XmlBeginSuite(itSuite.second);
+        suiteResult.reset(new SuiteResult(testDetails.GetSuite()));
+    }
 
-        for (const auto &test : itSuite.second.testResults)
-        {
-            output << XmlBeginTest(test.testDetails.GetFullName(), test);
+    return *suiteResult;
+}
 
-            if (test.status != TestResult::Success || test.testDetails.GetAttributeCount() != 0)
-            {
-                // close <TestCase>
-                output << ">\n";
-            }
+void XmlReporter::Finished(SuiteResult &suite)
+{
+    auto expected = expectedTests.find(suite.name);
 
-            for (auto i = 0U; i != test.testDetails.GetAttributeCount(); ++i)
-            {
-                std::string key = test.testDetails.GetAttributeKey(i);
-                if (key != "Skip")
-                {
-                    std::string value = test.testDetails.GetAttributeValue(i);
+    if (expected != expectedTests.end() && ++suite.finished == expected->second)
+    {
+        expectedTests.erase(expected);
+        Write(suite);
+    }
+}
 
-                    output << XmlTestAttribute(key, value);
-                }
-            }
+void XmlReporter::BeginResults()
+{
+    if (!begun)
+    {
+        begun = true;
 
-            if (test.status == TestResult::Failure)
-            {
-                xUnitpp::LineInfo li(test.testDetails.GetFile(), test.testDetails.GetLine());
-                output << XmlTestFailed(to_string(li), test.messages);
-            }
-            else if (test.status == TestResult::Skipped)
-            {
-                output << XmlTestSkipped(test.messages[0]);
-            }
+        output << XmlBeginDoc() << "<testsuites";
 
-            output << XmlEndTest(test.status == TestResult::Success && test.testDetails.GetAttributeCount() == 0);
+        // the totals are written over this padding at the end, if the output lets us go back to it
+        totalsAt = output.tellp();
+        if (totalsAt != -1)
+        {
+            output << std::string(TotalsWidth, ' ') << ">\n";
         }
+    }
+}
 
-        output << XmlEndSuite();
+void XmlReporter::Write(SuiteResult &suite)
+{
+    BeginResults();
+
+    if (totalsAt != -1)
+    {
+        output << XmlSuite(suite);
+        output.flush();
+    }
+    else
+    {
+        held += XmlSuite(suite);
     }
 
-    output << XmlEndResults();
+    // the name goes with the suite
+    auto name = suite.name;
+    suiteResults.erase(name);
 }
 
-void XmlReporter::ReportStart(const ITestDetails &testDetails)
+void XmlReporter::ReportAllTestsComplete(size_t testCount, size_t, size_t failureCount, long long nsTotal)
 {
-    std::string suite = testDetails.GetSuite();
-    if (suiteResults.find(suite) == suiteResults.end())
+    BeginResults();
+
+    // whatever is left was never expected, or ran fewer tests than expected
+    std::vector<std::string> remaining;
+    for (const auto &suite : suiteResults)
+    {
+        remaining.push_back(suite.first);
+    }
+
+    std::sort(remaining.begin(), remaining.end());
+
+    for (const auto &suite : remaining)
+    {
+        Write(*suiteResults[suite]);
+    }
+
+    auto totals = XmlTotals(testCount, failureCount, nsTotal);
+
+    if (totalsAt != -1)
+    {
+        auto end = output.tellp();
+        output.seekp(totalsAt);
+        output << totals;
+        output.seekp(end);
+    }
+    else
     {
-        suiteResults.insert(std::make_pair(suite, SuiteResult(suite)));
+        output << totals << ">\n" << held;
+        held.clear();
     }
 
-    suiteResults[suite].tests++;
-    suiteResults[suite].testResults.push_back(TestResult(testDetails));
+    output << XmlEndResults();
+}
+
+void XmlReporter::ReportStart(const ITestDetails &testDetails)
+{
+    auto &suiteResult = Suite(testDetails);
+    suiteResult.tests++;
+    suiteResult.testResults.push_back(TestResult(testDetails, stableIds));
+
+    runningTests[testDetails.GetId()] = std::make_pair(&suiteResult, suiteResult.testResults.size() - 1);
 }
 
 void XmlReporter::ReportEvent(const ITestDetails &testDetails, const ITestEvent &evt)
 {
-    if (evt.GetIsFailure())
-    {
-        std::string suite = testDetails.GetSuite();
-        std::string name = testDetails.GetFullName();
+    auto running = runningTests.find(testDetails.GetId());
 
-        suiteResults[suite].failures++;
+    if (evt.GetIsFailure() && running != runningTests.end())
+    {
+        running->second.first->failures++;
 
-        auto &testResult = GetTestResult(suiteResults[suite].testResults, name);
+        auto &testResult = *GetTestResult(runningTests, testDetails);
         testResult.messages.push_back(evt.GetToString());
         testResult.status = TestResult::Failure;
     }
@@ -305,19 +426,30 @@ void XmlReporter::ReportSkip(const ITestDetails &testDetails, const char *reason
 {
     ReportStart(testDetails);
 
-    std::string suite = testDetails.GetSuite();
-    std::string name = testDetails.GetFullName();
-
-    suiteResults[suite].skipped++;
+    auto &suiteResult = *runningTests.find(testDetails.GetId())->second.first;
+    suiteResult.skipped++;
 
-    auto &testResult = GetTestResult(suiteResults[suite].testResults, name);
+    auto &testResult = *GetTestResult(runningTests, testDetails);
     testResult.messages.push_back(reason);
     testResult.status = TestResult::Skipped;
+
+    runningTests.erase(testDetails.GetId());
+    Finished(suiteResult);
 }
 
 void XmlReporter::ReportFinish(const ITestDetails &testDetails, long long nsTaken)
 {
-    GetTestResult(suiteResults[testDetails.GetSuite()].testResults, testDetails.GetFullName()).time = Time::Duration(nsTaken);
+    auto running = runningTests.find(testDetails.GetId());
+    if (running == runningTests.end())
+    {
+        return;
+    }
+
+    running->second.first->testResults[running->second.second].time = Time::Duration(nsTaken);
+
+    auto &suiteResult = *running->second.first;
+    runningTests.erase(running);
+    Finished(suiteResult);
 }
 
 }}
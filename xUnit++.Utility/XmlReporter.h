@@ -8,19 +8,36 @@
 #define noexcept(x)
 #endif
 
-#include <map>
+#include <ios>
+#include <memory>
 #include <ostream>
+#include <string>
+#include <unordered_map>
+#include <utility>
 #include "xUnit++/IOutput.h"
 
 namespace xUnitpp { namespace Utilities
 {
 
+// appends `value` to `escaped` in one pass, escaped for an xml attribute or text
+void XmlEscape(std::string &escaped, const std::string &value);
+
+// the property each test's stable id is written as, in hex, so XmlMerge can tell retries from namesakes
+static const char XmlStableIdProperty[] = "stableId";
+
+// Writes results as JUnit style xml. Each suite is written out, and forgotten, as soon as as many of its tests
+// as expected have finished; suites without an expectation are written once every test is complete.
+// The totals on the root element are filled in last, so output that can't be seeked back is held until then.
 class XmlReporter : public IOutput
 {
 public:
-    XmlReporter(std::ostream &output);
+    // libraries built before ITestDetails::GetStableId have no `stableIds`, and their tests are written without one
+    XmlReporter(std::ostream &output, bool stableIds);
     virtual ~XmlReporter() noexcept(true);
 
+    // how many tests in `suite` are going to run, theory rows included
+    void ExpectTests(const std::string &suite, size_t tests);
+
     virtual void __stdcall ReportStart(const ITestDetails &td) override;
     virtual void __stdcall ReportEvent(const ITestDetails &testDetails, const ITestEvent &evt) override;
     virtual void __stdcall ReportSkip(const ITestDetails &testDetails, const char *reason) override;
@@ -33,9 +50,24 @@ public:
 private:
     XmlReporter &operator =(XmlReporter) /* = delete; */;
 
+    SuiteResult &Suite(const ITestDetails &testDetails);
+    void Finished(SuiteResult &suite);
+    void BeginResults();
+    void Write(SuiteResult &suite);
+
 private:
     std::ostream &output;
-    std::map<std::string, SuiteResult> suiteResults;
+    bool stableIds;
+    std::unordered_map<std::string, std::unique_ptr<SuiteResult>> suiteResults;
+    std::unordered_map<std::string, size_t> expectedTests;
+
+    // each running test's suite, and its place in that suite's results, by id
+    std::unordered_map<int, std::pair<SuiteResult *, size_t>> runningTests;
+
+    // where the totals go, once the root element has been begun; -1 if the output can't seek back to them
+    bool begun;
+    std::streamoff totalsAt;
+    std::string held;
 };
 
 }}
@@ -27,6 +27,12 @@ namespace
         return marshal_as<String ^>(td.GetFullName());
     }
 
+    // theory rows are only created when the theory runs, so they record their results against the theory's test case
+    String ^CaseKey(const xUnitpp::ITestDetails &td)
+    {
+        return marshal_as<String ^>(td.GetName());
+    }
+
     std::string DisplayName(const xUnitpp::ITestDetails &td)
     {
         std::string name = td.GetName();
@@ -62,9 +68,9 @@ namespace
         {
             auto key = TestKey(td);
             auto name = TestName(td);
-            recorder->RecordStart(testCases[key]);
+            recorder->RecordStart(testCases[CaseKey(td)]);
 
-            auto result = gcnew TestResult(testCases[key]);
+            auto result = gcnew TestResult(testCases[CaseKey(td)]);
             result->ComputerName = Environment::MachineName;
             result->DisplayName = name;
             result->Outcome = TestOutcome::None;
@@ -87,8 +93,7 @@ namespace
 
         void ReportSkip(const xUnitpp::ITestDetails &td, const std::string &)
         {
-            auto key = TestKey(td);
-            auto testCase = testCases[key];
+            auto testCase = testCases[CaseKey(td)];
             auto result = gcnew TestResult(testCase);
             result->ComputerName = Environment::MachineName;
             result->DisplayName = TestName(td);
@@ -109,7 +114,7 @@ namespace
                 result->Outcome = TestOutcome::Passed;
             }
 
-            recorder->RecordEnd(testCases[key], result->Outcome);
+            recorder->RecordEnd(testCases[CaseKey(td)], result->Outcome);
             recorder->RecordResult(result);
         }
 
@@ -57,11 +57,20 @@ namespace CommandLine
     Options::Options()
         : verbose(false)
         , list(false)
+        , memory(false)
+        , slowerRatio(0)
+        , slowerZ(0)
+        , strictTiming(false)
+        , historyQuery(false)
+        , historyRuns(10)
         , timeLimit(0)
         , threadLimit(0)
         , shadowCopy(true)
         , sort(false)
         , group(false)
+        , seed(0)
+        , shardIndex(0)
+        , shardCount(0)
     {
     }
 
@@ -89,6 +98,43 @@ namespace CommandLine
             arguments.emplace(argv[i]);
         }
 
+        // history <directory> [pattern] [--runs <count>] queries a timing history instead of running anything
+        if (!arguments.empty() && arguments.front() == "history")
+        {
+            arguments.pop();
+            options.historyQuery = true;
+
+            if (arguments.empty() || arguments.front().front() == '-')
+            {
+                return "history expects a following history directory." + Usage(exe());
+            }
+
+            options.history = TakeFront(arguments);
+
+            while (!arguments.empty())
+            {
+                auto opt = TakeFront(arguments);
+
+                if (opt == "-r" || opt == "--runs")
+                {
+                    if (arguments.empty() || !GetInt(arguments, options.historyRuns) || options.historyRuns <= 0)
+                    {
+                        return opt + " expects a following count of runs greater than 0." + Usage(exe());
+                    }
+                }
+                else if (opt.front() != '-' && options.historyPattern.empty())
+                {
+                    options.historyPattern = opt;
+                }
+                else
+                {
+                    return "Unrecognized history option " + opt + "." + Usage(exe());
+                }
+            }
+
+            return "";
+        }
+
         while (!arguments.empty())
         {
             auto opt = TakeFront(arguments);
@@ -103,6 +149,10 @@ namespace CommandLine
                 {
                     options.list = true;
                 }
+                else if (opt == "--memory")
+                {
+                    options.memory = true;
+                }
                 else if (opt == "-s" || opt == "--suite")
                 {
                     if (arguments.empty())
@@ -139,6 +189,15 @@ namespace CommandLine
                         return error + Usage(exe());
                     }
                 }
+                else if (opt == "-f" || opt == "--filter")
+                {
+                    if (arguments.empty())
+                    {
+                        return opt + " expects a following filter expression argument." + Usage(exe());
+                    }
+
+                    options.filters.push_back(TakeFront(arguments));
+                }
                 else if (opt == "-x" || opt == "--xml")
                 {
                     if (arguments.empty() || arguments.front().front() == '-')
@@ -151,6 +210,72 @@ namespace CommandLine
                         options.xmlOutput = TakeFront(arguments);
                     }
                 }
+                else if (opt == "--json")
+                {
+                    if (arguments.empty() || arguments.front().front() == '-')
+                    {
+                        // "." is a special filename meaning "use stdout"
+                        options.jsonOutput = ".";
+                    }
+                    else
+                    {
+                        options.jsonOutput = TakeFront(arguments);
+                    }
+                }
+                else if (opt == "--log")
+                {
+                    if (arguments.empty())
+                    {
+                        return opt + " expects a following log file name." + Usage(exe());
+                    }
+
+                    options.logOutput = TakeFront(arguments);
+                }
+                else if (opt == "--history")
+                {
+                    if (arguments.empty())
+                    {
+                        return opt + " expects a following history directory." + Usage(exe());
+                    }
+
+                    options.history = TakeFront(arguments);
+                }
+                else if (opt == "--commit")
+                {
+                    if (arguments.empty())
+                    {
+                        return opt + " expects a following commit id." + Usage(exe());
+                    }
+
+                    options.commit = TakeFront(arguments);
+                }
+                else if (opt == "--baseline")
+                {
+                    if (arguments.empty())
+                    {
+                        return opt + " expects a following history directory." + Usage(exe());
+                    }
+
+                    options.baseline = TakeFront(arguments);
+                }
+                else if (opt == "--slower")
+                {
+                    if (arguments.empty() || !(std::istringstream(TakeFront(arguments)) >> options.slowerRatio) || options.slowerRatio <= 1)
+                    {
+                        return opt + " expects a following ratio greater than 1." + Usage(exe());
+                    }
+                }
+                else if (opt == "--slower-z")
+                {
+                    if (arguments.empty() || !(std::istringstream(TakeFront(arguments)) >> options.slowerZ) || options.slowerZ <= 0)
+                    {
+                        return opt + " expects a following number of standard deviations greater than 0." + Usage(exe());
+                    }
+                }
+                else if (opt == "--strict-timing")
+                {
+                    options.strictTiming = true;
+                }
                 else if (opt == "-t" || opt == "--timelimit")
                 {
                     if (arguments.empty() || !GetInt(arguments, options.timeLimit))
@@ -174,6 +299,22 @@ namespace CommandLine
                     options.sort = true;
                     options.group = true;
                 }
+                else if (opt == "--seed")
+                {
+                    if (arguments.empty() || !(std::istringstream(TakeFront(arguments)) >> options.seed))
+                    {
+                        return opt + " expects a following number to shuffle tests with." + Usage(exe());
+                    }
+                }
+                else if (opt == "--shard")
+                {
+                    char slash = 0;
+                    if (arguments.empty() || !(std::istringstream(TakeFront(arguments)) >> options.shardIndex >> slash >> options.shardCount) ||
+                        slash != '/' || options.shardIndex >= options.shardCount)
+                    {
+                        return opt + " expects a following shard, as <index>/<count> with index < count." + Usage(exe());
+                    }
+                }
                 else if (opt == "--no-shadow")
                 {
                     options.shadowCopy = false;
@@ -199,13 +340,22 @@ namespace CommandLine
             return "At least one testLibrary must be specified." + Usage(exe());
         }
 
+        if (options.baseline.empty())
+        {
+            options.baseline = options.history;
+        }
+
+        if ((options.slowerRatio != 0 || options.slowerZ != 0) && options.baseline.empty())
+        {
+            return "--slower and --slower-z need a history to compare with, from --baseline or --history." + Usage(exe());
+        }
+
         return "";
     }
 
     std::string Usage(const std::string &exe)
     {
         static const std::string usage =
-            " <testLibrary>+ [option]+\n"
             "\n"
             "options:\n\n"
             "  -v --verbose                   : Verbose mode: include successful test timing\n"
@@ -214,21 +364,49 @@ namespace CommandLine
             "  -n --name <TEST>+              : Test(s) to run (regex match)\n"
             "  -i --include <NAME=[VALUE]>+   : Include tests with exactly matching <name=value> attribute(s)\n"
             "  -e --exclude <NAME=[VALUE]>+   : Exclude tests with exactly matching <name=value> attribute(s)\n"
+            "  -f --filter <EXPRESSION>       : Run only tests matching EXPRESSION (see below)\n"
             "  -t --timelimit <milliseconds>  : Set the default test time limit\n"
             "  -x --xml [FILENAME]            : Output Xunit-style XML, to optional file named FILENAME\n"
+            "     --json [FILENAME]           : Output a JSON object per line as tests run, to optional file named FILENAME\n"
+            "     --log <FILENAME>            : Output a compact binary results log to FILENAME (see xUnit++.convert)\n"
+            "     --history <DIRECTORY>       : Add every test's duration and outcome to the timing history kept in DIRECTORY\n"
+            "     --commit <ID>               : The commit to record with --history (default: $GIT_COMMIT)\n"
+            "     --baseline <DIRECTORY>      : The timing history to compare durations with (default: the --history DIRECTORY)\n"
+            "     --slower <RATIO>            : Warn of passing tests taking more than RATIO times their baseline mean\n"
+            "     --slower-z <Z>              : Warn of passing tests taking Z standard deviations over their baseline mean\n"
+            "     --strict-timing             : Fail the tests --slower or --slower-z would warn of\n"
             "  -c --concurrent <max tests>    : Set maximum number of concurrent tests\n"
             "  -o --sort                      : Sort tests by suite and then by test name\n"
             "  -g --group                     : Group test output under suite headers (implies --sort)\n"
+            "     --seed <number>             : Shuffle tests into the same order as any other run with this seed\n"
+            "     --shard <index>/<count>     : Run only the index'th of count roughly equal shares of the tests (from 0)\n"
             "     --no-shadow                 : Disable shadow copying the test binaries\n"
+            "     --memory                    : Report the memory taken by each library's test metadata, shared and unshared\n"
             "\n"
             "Tests are selected with an OR operation for inclusive attributes.\n"
             "Tests are excluded with an AND operation for exclusive attributes.\n"
             "When VALUE is omitted, any attribute with name NAME is matched.\n"
             "\n"
-            "Sorting and grouping test output causes test results to be cached until after all tests have completed.\n"
+            "Filter expressions combine suite:PATTERN, name:PATTERN, file:PATTERN and attr:NAME[=VALUE]\n"
+            "with and (&&), or (||), not (!) and parentheses, e.g. \"suite:Math and not attr:Speed=Slow\".\n"
+            "Patterns are case-insensitive regexes; quote any text containing spaces, parentheses or '='.\n"
+            "Every filter, suite, name and attribute option must be satisfied for a test to be run.\n"
+            "\n"
+            "Any of --xml, --json and --log can be written at once, each from its own thread;\n"
+            "results are also printed to the console unless --xml or --json is written to stdout.\n"
+            "\n"
+            "history prints the last runs (10 by default) of each test in the history kept in directory\n"
+            "whose \"suite :: name\" matches the case-insensitive regex PATTERN, with its mean passing time.\n"
+            "\n"
+            "A test's baseline is its last 20 passing runs; --slower-z needs at least 5 of them. Tests taking\n"
+            "less than 1 millisecond longer than their mean are never flagged.\n"
+            "\n"
+            "Sorting and grouping test output causes test results to be cached until after all tests have completed;\n"
+            "the results of large runs are cached in temporary files.\n"
             "Normally, test results are printed as soon as the test is complete.\n";
 
-        return "\nusage: " + exe + usage;
+        return "\nusage: " + exe + " <testLibrary>+ [option]+\n"
+            "   or: " + exe + " history <directory> [PATTERN] [-r --runs <count>]\n" + usage;
     }
 }
 
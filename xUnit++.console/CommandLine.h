@@ -17,17 +17,33 @@ namespace CommandLine
 
         bool verbose;
         bool list;
+        bool memory;
         std::vector<std::string> suites;
         std::vector<std::string> testNames;
         std::multimap<std::string, std::string> inclusiveAttributes;
         std::multimap<std::string, std::string> exclusiveAttributes;
+        std::vector<std::string> filters;
         std::set<std::string> libraries;
         std::string xmlOutput;
+        std::string jsonOutput;
+        std::string logOutput;
+        std::string history;
+        std::string commit;
+        std::string baseline;
+        double slowerRatio;
+        double slowerZ;
+        bool strictTiming;
+        bool historyQuery;
+        std::string historyPattern;
+        int historyRuns;
         int timeLimit;
         int threadLimit;
         bool shadowCopy;
         bool sort;
         bool group;
+        unsigned long long seed;
+        unsigned int shardIndex;
+        unsigned int shardCount;
     };
 
     std::string Parse(int argc, char **argv, Options &options);
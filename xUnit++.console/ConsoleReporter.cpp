@@ -1,18 +1,24 @@
 #include "ConsoleReporter.h"
 #include <algorithm>
 #include <chrono>
+#include <cstdint>
 #include <cstdio>
+#include <functional>
 #include <iostream>
 #include <memory>
 #include <mutex>
+#include <queue>
 #include <string>
+#include <tuple>
 #include <unordered_map>
+#include <vector>
 #include "xUnit++/EventLevel.h"
 #include "xUnit++/LineInfo.h"
 #include "xUnit++/ITestDetails.h"
 #include "xUnit++/ITestEvent.h"
 
 #if defined (_WIN32)
+#include <io.h>
 #include <Windows.h>
 #undef ReportEvent
 #undef GetMessage
@@ -44,9 +50,23 @@ namespace
         HANDLE stdOut;
         WORD attributes;
     } resetConsoleColors;
+
+    bool IsConsole()
+    {
+        return _isatty(_fileno(stdout)) != 0;
+    }
 }
 
 #else
+#include <unistd.h>
+
+namespace
+{
+    bool IsConsole()
+    {
+        return isatty(STDOUT_FILENO) != 0;
+    }
+}
 #endif
 
 namespace
@@ -158,41 +178,379 @@ namespace
         return xUnitpp::LineInfo(t.GetFile(), t.GetLine());
     }
 
-    std::string FileAndLine(const xUnitpp::ITestDetails &td, const xUnitpp::LineInfo &lineInfo)
+    std::string FileAndLine(const xUnitpp::LineInfo &testLineInfo, const xUnitpp::LineInfo &lineInfo)
     {
         auto result = to_string(lineInfo);
         if (result.empty())
         {
-            result = to_string(GetSafeLineInfo(td));
+            result = to_string(testLineInfo);
         }
 
         return result;
     }
 
-    template<typename TStream>
-    TStream &operator <<(TStream &stream, Color color)
+    // Text is built up with its colors, then handed to stdout in a single write.
+    // Colors are only written to a console: a pipe or a file gets plain text.
+    class ConsoleText
     {
+    public:
+        ConsoleText &operator ()(Color color, const std::string &message)
+        {
+            if (Colored() && color != lastColor)
+            {
 #if defined (_WIN32)
-        stream.flush();
-        if (color != Color::Default)
+                // the console's colors aren't part of the text, so where they change is remembered instead
+                colors.push_back(std::make_pair(text.size(), color));
+#else
+                text += to_ansicode(color);
+#endif
+                lastColor = color;
+            }
+
+            text += message;
+            return *this;
+        }
+
+        // plain text, in whatever color came before it
+        ConsoleText &operator ()(const std::string &message)
         {
-            SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), (unsigned short)color);
+            text += message;
+            return *this;
         }
-        else
+
+        void Reserve(size_t size)
         {
-            resetConsoleColors.Reset();
+            text.reserve(text.size() + size);
         }
+
+        size_t size() const
+        {
+            return text.size();
+        }
+
+        void Write()
+        {
+            // anything written through std::cout has to come out first
+            std::cout.flush();
+
+#if defined (_WIN32)
+            size_t written = 0;
+            for (const auto &change : colors)
+            {
+                std::fwrite(text.data() + written, 1, change.first - written, stdout);
+                std::fflush(stdout);
+                written = change.first;
+
+                if (change.second != Color::Default)
+                {
+                    SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), (unsigned short)change.second);
+                }
+                else
+                {
+                    resetConsoleColors.Reset();
+                }
+            }
+
+            std::fwrite(text.data() + written, 1, text.size() - written, stdout);
+            colors.clear();
 #else
-        stream << to_ansicode(color);
+            std::fwrite(text.data(), 1, text.size(), stdout);
 #endif
+            std::fflush(stdout);
 
-        return stream;
-    }
+            text.clear();
+        }
+
+    private:
+        static bool Colored()
+        {
+            static const bool colored = IsConsole();
+            return colored;
+        }
+
+        std::string text;
+#if defined (_WIN32)
+        std::vector<std::pair<size_t, Color>> colors;
+#endif
+
+        // the console's color carries over from one write to the next, so it's only ever changed when it needs to be
+        static Color lastColor;
+    };
+
+    // no color has been set yet, so the first one always is
+    Color ConsoleText::lastColor = (Color)0xfffe;
 
     std::string safestr(const char *s)
     {
         return s == nullptr ? "" : s;
     }
+
+    // Printed results, in order of suite, name and id, without holding them all in memory at once.
+    // Each result is packed into a compact record; whenever a run of records grows past `runBytes`
+    // it is sorted and spilled to a temporary file, and the runs are merged as they are read back.
+    class SortedResults
+    {
+    public:
+        typedef std::vector<std::pair<Color, std::string>> Fragments;
+
+        SortedResults(size_t runBytes)
+            : runBytes(runBytes)
+            , bytes(0)
+        {
+        }
+
+        ~SortedResults()
+        {
+            for (auto file : spilled)
+            {
+                std::fclose(file);
+            }
+        }
+
+        void Add(const std::string &suite, const std::string &name, int id, const Fragments &fragments)
+        {
+            Record record;
+            record.suite = suite;
+            record.name = name;
+            record.id = id;
+
+            PutSize(record.body, fragments.size());
+            for (const auto &fragment : fragments)
+            {
+                PutSize(record.body, (size_t)fragment.first);
+                PutString(record.body, fragment.second);
+            }
+
+            bytes += record.suite.size() + record.name.size() + record.body.size() + sizeof(Record);
+            run.push_back(std::move(record));
+
+            if (bytes > runBytes)
+            {
+                Spill();
+            }
+        }
+
+        // calls `print` with every result's suite and fragments, in order
+        void Merge(const std::function<void(const std::string &, const Fragments &)> &print)
+        {
+            std::sort(run.begin(), run.end());
+
+            std::vector<std::unique_ptr<Reader>> readers;
+            for (auto file : spilled)
+            {
+                std::rewind(file);
+                readers.emplace_back(new FileReader(file));
+            }
+            readers.emplace_back(new RunReader(run));
+
+            // the reader holding the least record comes out on top
+            auto greater = [](const Reader *lhs, const Reader *rhs) { return rhs->current < lhs->current; };
+            std::priority_queue<Reader *, std::vector<Reader *>, decltype(greater)> next(greater);
+
+            for (const auto &reader : readers)
+            {
+                if (reader->Next())
+                {
+                    next.push(reader.get());
+                }
+            }
+
+            Fragments fragments;
+            while (!next.empty())
+            {
+                auto reader = next.top();
+                next.pop();
+
+                fragments.clear();
+
+                const char *body = reader->current.body.data();
+                for (auto count = GetSize(body); count != 0; --count)
+                {
+                    auto color = (Color)GetSize(body);
+                    fragments.emplace_back(color, GetString(body));
+                }
+
+                print(reader->current.suite, fragments);
+
+                if (reader->Next())
+                {
+                    next.push(reader);
+                }
+            }
+        }
+
+    private:
+        SortedResults(const SortedResults &) /* = delete */;
+        SortedResults &operator =(SortedResults) /* = delete */;
+
+        struct Record
+        {
+            std::string suite;
+            std::string name;
+            int id;
+            std::string body;   // the fragments: a count, then each one's color and text
+
+            bool operator <(const Record &other) const
+            {
+                return std::tie(suite, name, id) < std::tie(other.suite, other.name, other.id);
+            }
+        };
+
+        // sizes and colors are written 7 bits at a time, low bits first, so most take a single byte
+        static void PutSize(std::string &out, size_t value)
+        {
+            for (; value >= 0x80; value >>= 7)
+            {
+                out += (char)((value & 0x7f) | 0x80);
+            }
+
+            out += (char)value;
+        }
+
+        static void PutString(std::string &out, const std::string &value)
+        {
+            PutSize(out, value.size());
+            out += value;
+        }
+
+        static size_t GetSize(const char *&in)
+        {
+            size_t value = 0;
+            for (int shift = 0; ; shift += 7)
+            {
+                auto byte = (unsigned char)*in++;
+                value |= (size_t)(byte & 0x7f) << shift;
+
+                if ((byte & 0x80) == 0)
+                {
+                    return value;
+                }
+            }
+        }
+
+        static std::string GetString(const char *&in)
+        {
+            auto size = GetSize(in);
+            std::string value(in, size);
+            in += size;
+            return value;
+        }
+
+        struct Reader
+        {
+            virtual ~Reader() {}
+            virtual bool Next() = 0;
+
+            Record current;
+        };
+
+        struct RunReader : Reader
+        {
+            RunReader(std::vector<Record> &run)
+                : it(run.begin())
+                , end(run.end())
+            {
+            }
+
+            virtual bool Next() override
+            {
+                if (it == end)
+                {
+                    return false;
+                }
+
+                current = std::move(*it++);
+                return true;
+            }
+
+            std::vector<Record>::iterator it;
+            std::vector<Record>::iterator end;
+        };
+
+        // a spilled record is its size, then its suite, name, id and body
+        struct FileReader : Reader
+        {
+            FileReader(FILE *file)
+                : file(file)
+            {
+            }
+
+            virtual bool Next() override
+            {
+                size_t size = 0;
+                for (int shift = 0; ; shift += 7)
+                {
+                    auto byte = std::fgetc(file);
+                    if (byte == EOF)
+                    {
+                        return false;
+                    }
+
+                    size |= (size_t)(byte & 0x7f) << shift;
+                    if ((byte & 0x80) == 0)
+                    {
+                        break;
+                    }
+                }
+
+                buffer.resize(size);
+                if (size == 0 || std::fread(&buffer[0], 1, size, file) != size)
+                {
+                    return false;
+                }
+
+                const char *in = buffer.data();
+                current.suite = GetString(in);
+                current.name = GetString(in);
+                current.id = (int)GetSize(in);
+                current.body.assign(in, buffer.data() + buffer.size());
+                return true;
+            }
+
+            FILE *file;
+            std::string buffer;
+        };
+
+        void Spill()
+        {
+            // without anywhere to spill to, results just stay in memory
+            auto file = std::tmpfile();
+            if (file == nullptr)
+            {
+                return;
+            }
+
+            std::sort(run.begin(), run.end());
+
+            for (const auto &record : run)
+            {
+                std::string packed;
+                PutString(packed, record.suite);
+                PutString(packed, record.name);
+                PutSize(packed, (size_t)(unsigned int)record.id);
+                packed += record.body;
+
+                std::string out;
+                PutString(out, packed);
+
+                if (std::fwrite(out.data(), 1, out.size(), file) != out.size())
+                {
+                    std::fclose(file);
+                    return;
+                }
+            }
+
+            spilled.push_back(file);
+            run.clear();
+            bytes = 0;
+        }
+
+    private:
+        size_t runBytes;
+        size_t bytes;
+        std::vector<Record> run;
+        std::vector<FILE *> spilled;
+    };
 }
 
 namespace xUnitpp
@@ -211,17 +569,16 @@ class ConsoleReporter::ReportCache
             {
             }
 
-            friend std::ostream &operator <<(std::ostream &stream, const Fragment &fragment)
-            {
-                return stream << fragment.color << fragment.message;
-            }
-
             Color color;
             std::string message;
         };
 
+        // test details are only valid during a report call, so keep copies of what gets printed
         TestOutput(const xUnitpp::ITestDetails &td, bool verbose)
-            : testDetails(td)
+            : suite(safestr(td.GetSuite()))
+            , name(safestr(td.GetName()))
+            , fullName(safestr(td.GetFullName()))
+            , lineInfo(GetSafeLineInfo(td))
             , failed(false)
             , verbose(verbose)
             , skipped(false)
@@ -233,51 +590,76 @@ class ConsoleReporter::ReportCache
             return failed || verbose || !fragments.empty();
         }
 
-        void Print(bool grouped)
+        // what Print writes after the blank line that separates ungrouped results
+        SortedResults::Fragments Printed(bool grouped) const
         {
-            if (WillPrint())
+            SortedResults::Fragments printed;
+
+            if (failed)
             {
-                if (!grouped)
-                {
-                    std::cout << "\n";
-                }
+                printed.emplace_back(Color::Failure, "[ Failure ] ");
+            }
+            else if (skipped)
+            {
+                printed.emplace_back(Color::Skip, "[ Skipped ] ");
+            }
+            else
+            {
+                printed.emplace_back(Color::Success, "[ Success ] ");
+            }
 
-                if (failed)
-                {
-                    std::cout << Fragment(Color::Failure, "[ Failure ] ");
-                }
-                else if (skipped)
+            if (!grouped)
+            {
+                if (!suite.empty())
                 {
-                    std::cout << Fragment(Color::Skip, "[ Skipped ] ");
+                    printed.emplace_back(Color::Suite, suite);
+                    printed.emplace_back(Color::Separator, TestSeparator);
                 }
-                else
+            }
+
+            printed.emplace_back(Color::TestName, fullName + "\n");
+
+            for (auto &&msg : fragments)
+            {
+                printed.emplace_back(msg.color, msg.message);
+            }
+
+            return printed;
+        }
+
+        void Print(bool grouped)
+        {
+            if (WillPrint())
+            {
+                auto printed = Printed(grouped);
+
+                size_t size = 1;
+                for (const auto &fragment : printed)
                 {
-                    std::cout << Fragment(Color::Success, "[ Success ] ");
+                    // room for a color code too
+                    size += fragment.second.size() + 12;
                 }
 
+                ConsoleText text;
+                text.Reserve(size);
+
                 if (!grouped)
                 {
-                    auto suite = safestr(testDetails.GetSuite());
-                    if (!suite.empty())
-                    {
-                        std::cout << Fragment(Color::Suite, suite);
-                        std::cout << Fragment(Color::Separator, TestSeparator);
-                    }
+                    text("\n");
                 }
 
-                auto fullName = safestr(testDetails.GetFullName());
-                std::cout << Fragment(Color::TestName, fullName + "\n");
-
-                for (auto &&msg : fragments)
+                for (const auto &fragment : printed)
                 {
-                    std::cout << msg;
+                    text(fragment.first, fragment.second);
                 }
+
+                text.Write();
             }
         }
 
         void Skip(const std::string &reason)
         {
-            fragments.emplace_back(Color::FileAndLine, to_string(xUnitpp::LineInfo(testDetails.GetFile(), testDetails.GetLine())));
+            fragments.emplace_back(Color::FileAndLine, to_string(lineInfo));
             fragments.emplace_back(Color::Separator, ": ");
             fragments.emplace_back(Color::Skip, reason);
             fragments.emplace_back(Color::Default, "\n");
@@ -291,7 +673,7 @@ class ConsoleReporter::ReportCache
                 failed = true;
             }
 
-            fragments.emplace_back(Color::FileAndLine, FileAndLine(testDetails, GetSafeLineInfo(event)));
+            fragments.emplace_back(Color::FileAndLine, FileAndLine(lineInfo, GetSafeLineInfo(event)));
             fragments.emplace_back(Color::Separator, ": ");
             fragments.emplace_back(to_color(event.GetLevel()), to_string(event.GetLevel()));
             fragments.emplace_back(Color::Separator, ": ");
@@ -357,9 +739,14 @@ class ConsoleReporter::ReportCache
             return *this;
         }
 
-        const xUnitpp::ITestDetails &TestDetails() const
+        const std::string &Suite() const
         {
-            return testDetails;
+            return suite;
+        }
+
+        const std::string &Name() const
+        {
+            return name;
         }
 
     private:
@@ -367,7 +754,10 @@ class ConsoleReporter::ReportCache
         TestOutput &operator =(TestOutput) /* = delete */;
 
     private:
-        const xUnitpp::ITestDetails &testDetails;
+        std::string suite;
+        std::string name;
+        std::string fullName;
+        xUnitpp::LineInfo lineInfo;
         std::vector<Fragment> fragments;
         bool failed;
         bool verbose;
@@ -381,12 +771,19 @@ public:
         : verbose(verbose)
         , sort(sort)
         , group(group)
+        , sorted(SortRunBytes)
     {
     }
 
     void Instant(Color color, const std::string &message)
     {
-        std::cout << TestOutput::Fragment(color, message);
+        instant(color, message);
+    }
+
+    // writes everything Instant has been given since the last flush
+    void Flush()
+    {
+        instant.Write();
     }
 
     TestOutput &Cache(const xUnitpp::ITestDetails &td)
@@ -420,23 +817,31 @@ public:
             Instant(Color::FileAndLine, to_string(GetSafeLineInfo(testDetails)) + ": ");
             Instant(Color::Skip, reason);
             Instant(Color::Default, "\n");
+            Flush();
         }
         else
         {
             Cache(testDetails).Skip(reason);
+            Finish(testDetails);
         }
     }
 
     void Finish(const xUnitpp::ITestDetails &td)
     {
-        if (!sort)
+        auto it = cache.find(td.GetId());
+        if (it != cache.end())
         {
-            auto it = cache.find(td.GetId());
-            if (it != cache.end())
+            if (!sort)
             {
                 it->second->Print(false);
-                cache.erase(it);
             }
+            else if (it->second->WillPrint())
+            {
+                // a finished result is only needed again to be printed, so it's packed away until then
+                sorted.Add(it->second->Suite(), it->second->Name(), td.GetId(), it->second->Printed(group));
+            }
+
+            cache.erase(it);
         }
     }
 
@@ -444,64 +849,60 @@ public:
     {
         if (sort)
         {
-            std::vector<std::shared_ptr<TestOutput>> finalResults;
-            finalResults.reserve(cache.size());
-
-            for (auto x : cache)
-            {
-                finalResults.push_back(x.second);
-            }
-
-            std::sort(finalResults.begin(), finalResults.end(),
-                [](const std::shared_ptr<TestOutput> &lhs, const std::shared_ptr<TestOutput> &rhs)
-                {
-                    auto lhsSuite = safestr(lhs->TestDetails().GetSuite());
-                    auto rhsSuite = safestr(rhs->TestDetails().GetSuite());
-                    if (lhsSuite != rhsSuite)
-                    {
-                        return lhsSuite < rhsSuite;
-                    }
+            // merged results are written in blocks, rather than one at a time
+            const size_t BlockSize = 64 * 1024;
 
-                    auto lhsName = lhs->TestDetails().GetName();
-                    auto rhsName = rhs->TestDetails().GetName();
-                    return lhsName < rhsName;
-                });
+            ConsoleText text;
+            text.Reserve(BlockSize);
 
             std::string curSuite = "";
-            for (auto it = finalResults.begin(); it != finalResults.end(); ++it)
-            {
-                auto &result = *it;
-                if (result->WillPrint())
+            sorted.Merge([&](const std::string &suite, const SortedResults::Fragments &fragments)
                 {
                     if (group)
                     {
-                        auto suite = safestr(result->TestDetails().GetSuite());
                         if (curSuite != suite)
                         {
                             curSuite = suite;
 
                             std::string sep(curSuite.length() + 4, '=');
-                            std::cout << TestOutput::Fragment(Color::Suite, "\n\n" + sep + "\n[ " + curSuite + " ]\n" + sep + "\n");
+                            text(Color::Suite, "\n\n" + sep + "\n[ " + curSuite + " ]\n" + sep + "\n");
                         }
                     }
+                    else
+                    {
+                        text("\n");
+                    }
 
-                    result->Print(group);
-                }
-            }
+                    for (const auto &fragment : fragments)
+                    {
+                        text(fragment.first, fragment.second);
+                    }
+
+                    if (text.size() >= BlockSize)
+                    {
+                        text.Write();
+                    }
+                });
+
+            text.Write();
         }
     }
 
 private:
+    // sorted results past this many bytes are spilled to a temporary file
+    static const size_t SortRunBytes = 16 * 1024 * 1024;
+
     OutputCache cache;
     bool verbose;
     bool sort;
     bool group;
+    SortedResults sorted;
+    ConsoleText instant;
 };
 
 ConsoleReporter::ConsoleReporter(bool verbose, bool sort, bool group)
     : cache(new ReportCache(verbose, sort, group))
 {
-    //std::cout.sync_with_stdio(false);
 }
 
 ConsoleReporter::~ConsoleReporter() noexcept(true)
@@ -572,6 +973,7 @@ void ConsoleReporter::ReportAllTestsComplete(size_t testCount, size_t skipped, s
 
     cache->Instant(Color::TimeSummary, report);
     cache->Instant(Color::Default, "\n");
+    cache->Flush();
 }
 
 }
@@ -0,0 +1,119 @@
+#include "HistoryQuery.h"
+#include <algorithm>
+#include <ctime>
+#include <iomanip>
+#include <regex>
+#include <sstream>
+#include <vector>
+#include "xUnit++/MappedFile.h"
+#include "TimingHistoryReader.h"
+
+namespace
+{
+    std::string Milliseconds(long long ns)
+    {
+        std::ostringstream text;
+        text << std::fixed << std::setprecision(3) << ns / 1e6 << " ms";
+        return text.str();
+    }
+
+    // in UTC, so histories from different machines read alike
+    std::string When(long long time)
+    {
+        std::time_t seconds = (std::time_t)time;
+        char text[32] = {0};
+
+        auto utc = std::gmtime(&seconds);
+        return utc != nullptr && std::strftime(text, sizeof(text), "%Y-%m-%d %H:%M:%S", utc) != 0 ? text : "?";
+    }
+
+    const char *OutcomeName(xUnitpp::TimingHistory::Outcome outcome)
+    {
+        switch (outcome)
+        {
+        case xUnitpp::TimingHistory::Passed: return "passed";
+        case xUnitpp::TimingHistory::Failed: return "failed";
+        case xUnitpp::TimingHistory::Skipped: return "skipped";
+        }
+
+        return "?";
+    }
+}
+
+namespace xUnitpp { namespace Utilities
+{
+
+std::string QueryHistory(const std::string &directory, const std::string &pattern, int runs, std::ostream &out)
+{
+    auto fileName = TimingHistory::FileName(directory);
+    auto file = MappedFile::TryOpen(fileName);
+
+    if (!file || !TimingHistoryReader::Readable(file->begin(), file->size()))
+    {
+        return "Unable to read " + fileName + " as a timing history.";
+    }
+
+    std::regex match;
+
+    try
+    {
+        match = std::regex(pattern, std::regex_constants::icase);
+    }
+    catch (const std::regex_error &)
+    {
+        return pattern + " is not a valid regex.";
+    }
+
+    TimingHistoryReader history(file->begin(), file->size());
+
+    typedef std::pair<std::string, const TimingHistoryReader::Test *> NamedTest;
+    std::vector<NamedTest> tests;
+
+    for (auto &test : history.Tests())
+    {
+        auto name = std::string(test.second.suite) + " :: " + test.second.name;
+
+        if (!test.second.samples.empty() && std::regex_search(name, match))
+        {
+            tests.push_back(std::make_pair(name, &test.second));
+        }
+    }
+
+    std::sort(tests.begin(), tests.end(), [](const NamedTest &lhs, const NamedTest &rhs) { return lhs.first < rhs.first; });
+
+    for (auto &test : tests)
+    {
+        auto &samples = test.second->samples;
+        auto first = samples.size() > (size_t)runs ? samples.end() - runs : samples.begin();
+
+        out << test.first << " (" << samples.size() << " runs)\n";
+
+        long long total = 0;
+        size_t passed = 0;
+
+        for (auto sample = first; sample != samples.end(); ++sample)
+        {
+            auto &run = history.Runs()[sample->run];
+
+            out << "    " << When(run.time) << "  " << std::setw(12) << Milliseconds(sample->ns) << "  " << std::setw(7) << std::left
+                << OutcomeName(sample->outcome) << std::right << "  " << run.host << "  " << run.commit << "\n";
+
+            if (sample->outcome == TimingHistory::Passed)
+            {
+                total += sample->ns;
+                ++passed;
+            }
+        }
+
+        if (passed != 0)
+        {
+            out << "    mean of " << passed << " passing: " << Milliseconds(total / (long long)passed) << "\n";
+        }
+    }
+
+    out << tests.size() << " tests in " << history.Runs().size() << " runs." << std::endl;
+
+    return "";
+}
+
+}}
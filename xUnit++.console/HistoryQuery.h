@@ -0,0 +1,17 @@
+#ifndef HISTORYQUERY_H_
+#define HISTORYQUERY_H_
+
+#include <ostream>
+#include <string>
+
+namespace xUnitpp { namespace Utilities
+{
+
+// Prints the last `runs` samples of every test in the history of `directory` whose "suite :: name"
+// matches `pattern` (a case-insensitive regex; empty matches everything), with their passing mean.
+// Returns why it couldn't, or "" when it could.
+std::string QueryHistory(const std::string &directory, const std::string &pattern, int runs, std::ostream &out);
+
+}}
+
+#endif
@@ -1,15 +1,29 @@
 #include <algorithm>
+#include <cstdlib>
 #include <fstream>
 #include <iostream>
-#include <regex>
+#include <memory>
 #include <string>
 #include <tuple>
 #include <vector>
 #include "xUnit++/ExportApi.h"
 #include "xUnit++/ITestDetails.h"
+#include "xUnit++/MappedFile.h"
+#include "xUnit++/RunOptions.h"
+#include "xUnit++/TestManifest.h"
 #include "CommandLine.h"
 #include "ConsoleReporter.h"
+#include "DurationRegressionReporter.h"
+#include "FanOutReporter.h"
+#include "HistoryQuery.h"
+#include "JsonReporter.h"
+#include "ManifestReader.h"
+#include "ResultLogReporter.h"
 #include "TestAssembly.h"
+#include "TestFilter.h"
+#include "TimingHistory.h"
+#include "TimingHistoryReader.h"
+#include "TimingHistoryReporter.h"
 #include "XmlReporter.h"
 
 int main(int argc, char **argv)
@@ -25,6 +39,58 @@ int main(int argc, char **argv)
         }
     }
 
+    if (options.historyQuery)
+    {
+        auto result = xUnitpp::Utilities::QueryHistory(options.history, options.historyPattern, options.historyRuns, std::cout);
+        if (!result.empty())
+        {
+            std::cerr << result << std::endl;
+            return -1;
+        }
+
+        return 0;
+    }
+
+    std::string host;
+    std::string commit = options.commit;
+
+    if (!options.history.empty())
+    {
+        xUnitpp::TimingHistory::MakeDirectory(options.history);
+        host = xUnitpp::TimingHistory::HostName();
+
+        if (commit.empty() && std::getenv("GIT_COMMIT") != nullptr)
+        {
+            commit = std::getenv("GIT_COMMIT");
+        }
+    }
+
+    // every option that selects tests is compiled once, into one filter shared by every library
+    xUnitpp::Utilities::TestFilter filter;
+
+    {
+        auto result = filter.RequireAnySuite(options.suites);
+
+        if (result.empty())
+        {
+            result = filter.RequireAnyName(options.testNames);
+        }
+
+        for (auto it = options.filters.begin(); result.empty() && it != options.filters.end(); ++it)
+        {
+            result = filter.Parse(*it);
+        }
+
+        if (!result.empty())
+        {
+            std::cerr << result << std::endl;
+            return -1;
+        }
+
+        filter.RequireAnyAttribute(options.inclusiveAttributes);
+        filter.ExcludeAllAttributes(options.exclusiveAttributes);
+    }
+
     int totalFailures = 0;
     bool forcedFailure = false;
 
@@ -39,10 +105,59 @@ int main(int argc, char **argv)
             continue;
         }
 
-        std::vector<int> activeTestIds;
-        auto onList = [&](const xUnitpp::ITestDetails &td)
+        if (options.memory)
+        {
+            if (testAssembly.GetRegistryFootprint == nullptr)
             {
-                if (options.list)
+                std::cout << lib << " is too old to report its memory use." << std::endl;
+            }
+            else
+            {
+                xUnitpp::RegistryFootprint footprint;
+                testAssembly.GetRegistryFootprint(footprint);
+
+                std::cout << lib << ": the suite names, file names and attributes of " << footprint.tests << " tests take "
+                    << footprint.sharedBytes << " bytes shared (" << footprint.internedStrings << " strings, " << footprint.attributeSets
+                    << " attribute sets), against " << footprint.unsharedBytes << " bytes unshared." << std::endl;
+            }
+        }
+
+        xUnitpp::Utilities::TestIndex index;
+
+        // how many times each test will be reported, or -1 if a theory won't say without generating its rows
+        std::vector<int> instances;
+
+        // the manifest is read in place; older libraries only offer a callback per test
+        size_t manifestSize = 0;
+        const void *manifest = testAssembly.GetTestManifest != nullptr ? testAssembly.GetTestManifest(manifestSize) : nullptr;
+        bool haveManifest = xUnitpp::Utilities::ManifestReader::Readable(manifest, manifestSize);
+
+        if (haveManifest)
+        {
+            xUnitpp::Utilities::ManifestReader tests(manifest, manifestSize);
+
+            for (size_t i = 0; i != tests.size(); ++i)
+            {
+                index.Add(tests[i]);
+                instances.push_back(tests[i].GetInstanceCount());
+            }
+        }
+        else
+        {
+            // such libraries predate GetInstanceCount, and list each of a theory's rows as a test of its own:
+            // a row is reported once, but since it can't be told from a theory that generates its rows, it isn't counted
+            testAssembly.EnumerateTestDetails([&](const xUnitpp::ITestDetails &td)
+                {
+                    index.Add(td);
+                    instances.push_back(*td.GetParams() == '\0' ? 1 : -1);
+                });
+        }
+
+        auto selected = filter.Select(index);
+
+        if (options.list)
+        {
+            auto onList = [&](const xUnitpp::ITestDetails &td, int instances)
                 {
                     std::cout << std::endl;
                     for (auto i = 0U; i != td.GetAttributeCount(); ++i)
@@ -50,170 +165,284 @@ int main(int argc, char **argv)
                         std::cout << (std::string("[") + td.GetAttributeKey(i) + " = " + td.GetAttributeValue(i) + "]") << std::endl;
                     }
 
-                    std::cout << (td.GetSuite() + std::string(" :: ") + td.GetName()) << std::endl;
-                }
-                else
-                {
-                    activeTestIds.push_back(td.GetId());
-                }
-            };
+                    std::string name = td.GetSuite() + std::string(" :: ") + td.GetName();
+
+                    // theories report their number of rows when it is known without generating them
+                    if (instances != 1)
+                    {
+                        name += " (" + (instances < 0 ? std::string("?") : std::to_string(instances)) + " instances)";
+                    }
 
-        testAssembly.EnumerateTestDetails([&](const xUnitpp::ITestDetails &td)
+                    std::cout << name << std::endl;
+                };
+
+            if (haveManifest)
             {
-                // check suites:
-                // if any suites are specified, a test has to belong to one of them to be run
-                if (!options.suites.empty())
+                xUnitpp::Utilities::ManifestReader tests(manifest, manifestSize);
+
+                for (auto test : selected)
                 {
-                    bool included = false;
-                    for (const auto &suite : options.suites)
-                    {
-                        std::regex regex(suite, std::regex_constants::icase);
+                    onList(tests[test], tests[test].GetInstanceCount());
+                }
+            }
+            else
+            {
+                // tests are enumerated in the same order every time, so the second pass lines up with the index;
+                // each theory row is listed as it always was, on its own
+                size_t test = 0;
+                auto next = selected.begin();
 
-                        std::string testSuite = td.GetSuite() == nullptr ? "" : td.GetSuite();
-                        if (std::regex_search(testSuite, regex))
+                testAssembly.EnumerateTestDetails([&](const xUnitpp::ITestDetails &td)
+                    {
+                        if (next != selected.end() && *next == test++)
                         {
-                            included = true;
-                            break;
+                            ++next;
+                            onList(td, 1);
                         }
-                    }
+                    });
+            }
+
+            continue;
+        }
+
+        // libraries that can't shard their own tests have it done for them
+        bool shardHere = options.shardCount != 0 && testAssembly.SelectedTestsRunner == nullptr;
+
+        std::vector<int> activeTestIds;
+        activeTestIds.reserve(selected.size());
+
+        // how many tests each suite will report, so the xml can be written a suite at a time; -1 when it can't be known
+        std::vector<long long> suiteTests(index.suites.values.size(), 0);
+
+        for (auto test : selected)
+        {
+            // such libraries predate GetStableId, so their tests are sharded by suite and name alone
+            if (!shardHere ||
+                xUnitpp::Manifest::StableHash(index.suites.values[index.suite[test]].c_str(), index.names.values[index.name[test]].c_str()) % options.shardCount == options.shardIndex)
+            {
+                activeTestIds.push_back(index.Id(test));
+
+                auto &count = suiteTests[index.suite[test]];
+                count = (count < 0 || instances[test] < 0) ? -1 : count + instances[test];
+            }
+        }
 
-                    if (!included)
+        // a library that shards its own tests doesn't say which ones it ran until it runs them
+        if (options.shardCount != 0 && !shardHere)
+        {
+            std::fill(suiteTests.begin(), suiteTests.end(), -1);
+        }
+
+        if (!activeTestIds.empty())
+        {
+            std::sort(activeTestIds.begin(), activeTestIds.end());
+
+            auto runTests = [&](xUnitpp::IOutput &reporter)
+                {
+                    if (testAssembly.SelectedTestsRunner == nullptr)
                     {
+                        totalFailures += testAssembly.FilteredTestsRunner(options.timeLimit, options.threadLimit, reporter,
+                            [&](const xUnitpp::ITestDetails &testDetails)
+                            {
+                                return std::binary_search(activeTestIds.begin(), activeTestIds.end(), testDetails.GetId());
+                            });
+
                         return;
                     }
-                }
 
-                // check names
-                if (!options.testNames.empty())
-                {
-                    bool included = false;
-                    for (const auto &name : options.testNames)
-                    {
-                        std::regex regex(name, std::regex_constants::icase);
+                    xUnitpp::RunOptions runOptions;
+                    runOptions.timeLimit = options.timeLimit;
+                    runOptions.threadLimit = options.threadLimit;
+                    runOptions.seed = options.seed;
+                    runOptions.shardIndex = options.shardIndex;
+                    runOptions.shardCount = options.shardCount;
 
-                        if (std::regex_search(td.GetName(), regex))
+                    // a bitmap costs a bit per id in the selected range, a sorted array 32 bits per selected id:
+                    // hand over whichever is smaller
+                    std::vector<uint64_t> bitmap;
+                    size_t range = (size_t)((long long)activeTestIds.back() - activeTestIds.front()) + 1;
+
+                    if (range <= activeTestIds.size() * 32)
+                    {
+                        bitmap.resize((range + 63) / 64);
+                        for (auto id : activeTestIds)
                         {
-                            included = true;
-                            break;
+                            size_t bit = (size_t)((long long)id - activeTestIds.front());
+                            bitmap[bit / 64] |= 1ULL << (bit % 64);
                         }
-                    }
 
-                    if (!included)
+                        runOptions.selection = xUnitpp::RunOptions::SelectBitmap;
+                        runOptions.bitmap = bitmap.data();
+                        runOptions.firstId = activeTestIds.front();
+                        runOptions.bitCount = range;
+                    }
+                    else
                     {
-                        return;
+                        runOptions.selection = xUnitpp::RunOptions::SelectIds;
+                        runOptions.ids = activeTestIds.data();
+                        runOptions.idCount = activeTestIds.size();
                     }
-                }
 
-                // check inclusive attributes:
-                // a test has to have *any* matching attribute key and value to be run
-                if (!options.inclusiveAttributes.empty())
+                    totalFailures += testAssembly.SelectedTestsRunner(runOptions, reporter);
+                };
+
+            // libraries that predate stable ids have no SelectedTestsRunner either
+            bool stableIds = testAssembly.SelectedTestsRunner != nullptr;
+
+            // every output asked for is written at once, each by its own reporter, on its own thread
+            // the reporters and their files are declared first, so they outlive the fan-out
+            std::shared_ptr<const xUnitpp::MappedFile> historyFile;
+            std::unique_ptr<xUnitpp::Utilities::TimingHistoryReader> history;
+            std::vector<std::unique_ptr<std::ofstream>> files;
+            std::vector<std::unique_ptr<xUnitpp::IOutput>> reporters;
+            xUnitpp::Utilities::FanOutReporter fanOut(stableIds);
+
+            auto add = [&](const std::string &name, xUnitpp::IOutput *reporter)
                 {
-                    bool included = false;
+                    reporters.emplace_back(reporter);
+                    fanOut.Add(name, *reporter);
+                };
 
-                    for (auto test = options.inclusiveAttributes.begin(); !included && test != options.inclusiveAttributes.end(); ++test)
+            // "." is a special filename meaning "use stdout"
+            auto open = [&](const std::string &fileName) -> std::ostream *
+                {
+                    if (fileName == ".")
                     {
-                        size_t begin, end;
-                        td.FindAttributeKey(test->first.c_str(), begin, end);
+                        return &std::cout;
+                    }
 
-                        if (begin != end)
-                        {
-                            if (test->second == "")
-                            {
-                                included = true;
-                                break;
-                            }
+                    files.emplace_back(new std::ofstream(fileName, std::ios::binary));
 
-                            for (auto it = begin; it != end; ++it)
-                            {
-                                if (td.GetAttributeValue(it) == test->second)
-                                {
-                                    included = true;
-                                    break;
-                                }
-                            }
-                        }
+                    if (!*files.back())
+                    {
+                        std::cerr << "Unable to open " << fileName << " for writing.\n\n";
+                        return nullptr;
                     }
 
-                    if (!included)
+                    return files.back().get();
+                };
+
+            // the console's own output only gives way to another reporter writing to stdout
+            if (options.xmlOutput != "." && options.jsonOutput != ".")
+            {
+                add("console", new xUnitpp::ConsoleReporter(options.verbose, options.sort, options.group));
+            }
+
+            if (!options.xmlOutput.empty())
+            {
+                auto output = open(options.xmlOutput);
+                auto reporter = new xUnitpp::Utilities::XmlReporter(output != nullptr ? *output : std::cerr, stableIds);
+                add("xml", reporter);
+
+                for (size_t suite = 0; suite != suiteTests.size(); ++suite)
+                {
+                    if (suiteTests[suite] > 0)
                     {
-                        return;
+                        reporter->ExpectTests(index.suites.values[suite], (size_t)suiteTests[suite]);
                     }
                 }
+            }
 
-                // check exclusive attributes:
-                // if a test has *all* matching keys, it is excluded
-                if (!options.exclusiveAttributes.empty())
+            if (!options.jsonOutput.empty())
+            {
+                auto output = open(options.jsonOutput);
+                add("json", new xUnitpp::Utilities::JsonReporter(output != nullptr ? *output : std::cerr, stableIds));
+            }
+
+            if (!options.logOutput.empty())
+            {
+                // unlike the text outputs, a binary log is no use on stderr
+                if (auto output = open(options.logOutput))
+                {
+                    add("log", new xUnitpp::Utilities::ResultLogReporter(*output, stableIds));
+                }
+                else
                 {
-                    bool matchFailed = false;
-                    for (auto test = options.exclusiveAttributes.begin(); !matchFailed && test != options.exclusiveAttributes.end(); ++test)
+                    forcedFailure = true;
+                }
+            }
+
+            if (!options.history.empty())
+            {
+                auto fileName = xUnitpp::TimingHistory::FileName(options.history);
+
+                // read before this run adds to it, so the tests it already names aren't named again
+                historyFile = xUnitpp::MappedFile::TryOpen(fileName);
+
+                // an empty file is as good as none
+                if (historyFile && historyFile->size() != 0 && !xUnitpp::Utilities::TimingHistoryReader::Readable(historyFile->begin(), historyFile->size()))
+                {
+                    std::cerr << fileName << " is not a timing history, and won't be added to.\n\n";
+                    forcedFailure = true;
+                }
+                else
+                {
+                    if (historyFile && historyFile->size() != 0)
                     {
-                        size_t begin, end;
-                        td.FindAttributeKey(test->first.c_str(), begin, end);
+                        history.reset(new xUnitpp::Utilities::TimingHistoryReader(historyFile->begin(), historyFile->size()));
 
-                        if (begin != end)
+                        if (history->size() != historyFile->size())
                         {
-                            // key matched, and we want to exclude all tests with a specific value
-                            if (test->second != "")
-                            {
-                                for (; begin != end; ++begin)
-                                {
-                                    if (td.GetAttributeValue(begin) == test->second)
-                                    {
-                                        break;
-                                    }
-                                }
-
-                                if (begin == end)
-                                {
-                                    matchFailed = true;
-                                }
-                            }
+                            std::cerr << fileName << " ends in a record cut short: runs added after it won't be read.\n\n";
                         }
                     }
 
-                    if (!matchFailed)
+                    files.emplace_back(new std::ofstream(fileName, std::ios::binary | std::ios::app));
+
+                    if (*files.back())
                     {
-                        return;
+                        add("history", new xUnitpp::Utilities::TimingHistoryReporter(*files.back(), history.get(), host, commit, stableIds));
+                    }
+                    else
+                    {
+                        std::cerr << "Unable to open " << fileName << " for writing.\n\n";
+                        forcedFailure = true;
                     }
                 }
+            }
 
-                onList(td);
-            });
+            std::shared_ptr<const xUnitpp::MappedFile> baselineFile;
+            std::unique_ptr<xUnitpp::Utilities::TimingHistoryReader> baseline;
 
-        if (!activeTestIds.empty())
-        {
-            std::sort(activeTestIds.begin(), activeTestIds.end());
+            if (options.slowerRatio != 0 || options.slowerZ != 0)
+            {
+                baselineFile = xUnitpp::MappedFile::TryOpen(xUnitpp::TimingHistory::FileName(options.baseline));
 
-            auto runTests = [&](xUnitpp::IOutput &reporter)
+                if (baselineFile && xUnitpp::Utilities::TimingHistoryReader::Readable(baselineFile->begin(), baselineFile->size()))
                 {
-                    totalFailures += testAssembly.FilteredTestsRunner(options.timeLimit, options.threadLimit, reporter,
-                        [&](const xUnitpp::ITestDetails &testDetails)
-                        {
-                            return std::binary_search(activeTestIds.begin(), activeTestIds.end(), testDetails.GetId());
-                        });
-                };
-
-            if (options.xmlOutput.empty())
-            {
-                xUnitpp::ConsoleReporter reporter(options.verbose, options.sort, options.group);
-                runTests(reporter);
+                    baseline.reset(new xUnitpp::Utilities::TimingHistoryReader(baselineFile->begin(), baselineFile->size()));
+                }
+                else
+                {
+                    // the first run given --history has nothing to compare with yet
+                    std::cerr << "No timing history in " << options.baseline << " to compare durations with.\n\n";
+                }
             }
-            else if (options.xmlOutput == ".")
+
+            if (baseline)
             {
-                xUnitpp::Utilities::XmlReporter reporter(std::cout);
-                runTests(reporter);
+                xUnitpp::Utilities::DurationRegressionReporter::Limits limits;
+                limits.ratio = options.slowerRatio;
+                limits.zScore = options.slowerZ;
+                limits.strict = options.strictTiming;
+
+                // the regressions are reported through the fan-out, like any other event
+                xUnitpp::Utilities::DurationRegressionReporter regressions(fanOut, *baseline, stableIds, limits);
+                runTests(regressions);
+
+                totalFailures += (int)regressions.Failures();
             }
             else
             {
-                std::ofstream file(options.xmlOutput, std::ios::binary);
+                runTests(fanOut);
+            }
 
-                if (!file)
-                {
-                    std::cerr << "Unable to open " << options.xmlOutput << " for writing.\n\n";
-                }
+            fanOut.Wait();
 
-                xUnitpp::Utilities::XmlReporter reporter(!file ? std::cerr : file);
-                runTests(reporter);
+            for (auto &failure : fanOut.Failures())
+            {
+                std::cerr << "The " << failure.first << " output stopped part way: " << failure.second << std::endl;
+                forcedFailure = true;
             }
         }
     }
@@ -0,0 +1,112 @@
+#include <fstream>
+#include <iostream>
+#include <string>
+#include "xUnit++/MappedFile.h"
+#include "JsonReporter.h"
+#include "ResultLogReader.h"
+#include "XmlReporter.h"
+
+namespace
+{
+    const std::string Usage =
+        " <logFile> [option]\n"
+        "\n"
+        "options:\n\n"
+        "  -x --xml [FILENAME]            : Convert to Xunit-style XML, to optional file named FILENAME (the default)\n"
+        "     --json [FILENAME]           : Convert to a JSON object per line, to optional file named FILENAME\n"
+        "\n"
+        "logFile is a results log written by xUnit++.console --log.\n"
+        "A log cut short by a crash is converted up to its last whole record.\n";
+
+    void TakeFileName(int &arg, int argc, char **argv, std::string &fileName)
+    {
+        // "." is a special filename meaning "use stdout"
+        fileName = ".";
+
+        if (arg + 1 < argc && argv[arg + 1][0] != '-')
+        {
+            fileName = argv[++arg];
+        }
+    }
+}
+
+int main(int argc, char **argv)
+{
+    std::string logFile;
+    std::string outputFile = ".";
+    bool json = false;
+
+    for (int arg = 1; arg < argc; ++arg)
+    {
+        std::string opt = argv[arg];
+
+        if (opt == "-x" || opt == "--xml")
+        {
+            json = false;
+            TakeFileName(arg, argc, argv, outputFile);
+        }
+        else if (opt == "--json")
+        {
+            json = true;
+            TakeFileName(arg, argc, argv, outputFile);
+        }
+        else if (opt[0] != '-' && logFile.empty())
+        {
+            logFile = opt;
+        }
+        else
+        {
+            std::cerr << "Unrecognized option " << opt << ".\n\nusage: " << argv[0] << Usage;
+            return -1;
+        }
+    }
+
+    if (logFile.empty())
+    {
+        std::cerr << "A logFile must be specified.\n\nusage: " << argv[0] << Usage;
+        return -1;
+    }
+
+    auto log = xUnitpp::MappedFile::TryOpen(logFile);
+
+    if (!log || !xUnitpp::Utilities::ResultLogReader::Readable(log->begin(), log->size()))
+    {
+        std::cerr << "Unable to read " << logFile << " as a results log." << std::endl;
+        return -1;
+    }
+
+    xUnitpp::Utilities::ResultLogReader reader(log->begin(), log->size());
+
+    if (!reader.IsComplete())
+    {
+        std::cerr << logFile << " ends before its run did: converting the first " << reader.size() << " bytes." << std::endl;
+    }
+
+    std::ofstream file;
+
+    if (outputFile != ".")
+    {
+        file.open(outputFile, std::ios::binary);
+
+        if (!file)
+        {
+            std::cerr << "Unable to open " << outputFile << " for writing." << std::endl;
+            return -1;
+        }
+    }
+
+    std::ostream &output = outputFile == "." ? std::cout : file;
+
+    if (json)
+    {
+        xUnitpp::Utilities::JsonReporter reporter(output, reader.HasStableIds());
+        reader.Replay(reporter);
+    }
+    else
+    {
+        xUnitpp::Utilities::XmlReporter reporter(output, reader.HasStableIds());
+        reader.Replay(reporter);
+    }
+
+    return 0;
+}
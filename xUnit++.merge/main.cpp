@@ -0,0 +1,93 @@
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "XmlMerge.h"
+
+namespace
+{
+    const std::string Usage =
+        " <xmlFile>+ [option]\n"
+        "\n"
+        "options:\n\n"
+        "  -o --output <FILENAME>         : Write the merged XML to FILENAME instead of stdout\n"
+        "  -j --threads <count>           : Read at most count files at once (default: one per processor)\n"
+        "\n"
+        "xmlFiles are written by xUnit++.console --xml, usually one per --shard of the same run.\n"
+        "A test found in more than one file was retried; only its results from the last of those files are kept.\n";
+}
+
+int main(int argc, char **argv)
+{
+    std::vector<std::string> xmlFiles;
+    std::string outputFile;
+    unsigned int threads = std::thread::hardware_concurrency();
+
+    for (int arg = 1; arg < argc; ++arg)
+    {
+        std::string opt = argv[arg];
+
+        if ((opt == "-o" || opt == "--output") && arg + 1 < argc)
+        {
+            outputFile = argv[++arg];
+        }
+        else if ((opt == "-j" || opt == "--threads") && arg + 1 < argc)
+        {
+            int count = std::atoi(argv[++arg]);
+
+            if (count <= 0)
+            {
+                std::cerr << opt << " expects a following count greater than 0.\n\nusage: " << argv[0] << Usage;
+                return -1;
+            }
+
+            threads = (unsigned int)count;
+        }
+        else if (opt[0] != '-')
+        {
+            xmlFiles.push_back(opt);
+        }
+        else
+        {
+            std::cerr << "Unrecognized option " << opt << ".\n\nusage: " << argv[0] << Usage;
+            return -1;
+        }
+    }
+
+    if (xmlFiles.empty())
+    {
+        std::cerr << "At least one xmlFile must be specified.\n\nusage: " << argv[0] << Usage;
+        return -1;
+    }
+
+    xUnitpp::Utilities::XmlMerge merge;
+    auto errors = merge.ReadFiles(xmlFiles, threads == 0 ? 1 : threads);
+
+    std::cerr << errors;
+
+    std::ofstream file;
+
+    if (!outputFile.empty())
+    {
+        file.open(outputFile, std::ios::binary);
+
+        if (!file)
+        {
+            std::cerr << "Unable to open " << outputFile << " for writing." << std::endl;
+            return -1;
+        }
+    }
+
+    merge.Write(outputFile.empty() ? std::cout : file);
+
+    std::cerr << "Merged " << merge.Tests() << " tests from " << xmlFiles.size() << " files";
+    if (merge.Retried() != 0)
+    {
+        std::cerr << ", dropping " << merge.Retried() << " results that were retried";
+    }
+    std::cerr << "." << std::endl;
+
+    return errors.empty() ? 0 : 1;
+}
@@ -1,5 +1,7 @@
 #include "Attributes.h"
 #include <algorithm>
+#include <map>
+#include <mutex>
 
 namespace xUnitAttributes
 {
@@ -14,62 +16,115 @@ xUnitpp::AttributeCollection Attributes()
 namespace xUnitpp
 {
 
-AttributeCollection::AttributeCollection()
+AttributeCollection::Data::Data()
     : skipped(std::make_pair(false, ""))
 {
 }
 
+AttributeCollection::AttributeCollection()
+{
+    // every empty collection starts out sharing one set of no attributes
+    static const std::shared_ptr<Data> none = std::make_shared<Data>();
+    data = none;
+}
+
 void swap(AttributeCollection &a, AttributeCollection &b)
 {
     using std::swap;
-    swap(a.sortedAttributes, b.sortedAttributes);
-    swap(a.skipped, b.skipped);
+    swap(a.data, b.data);
+}
+
+AttributeCollection AttributeCollection::Shared(AttributeCollection &&attributes)
+{
+    static std::mutex lock;
+    static std::map<std::vector<Attribute>, AttributeCollection> shared;
+
+    std::lock_guard<std::mutex> guard(lock);
+
+    auto it = shared.find(attributes.data->sortedAttributes);
+    if (it == shared.end())
+    {
+        it = shared.insert(std::make_pair(attributes.data->sortedAttributes, std::move(attributes))).first;
+    }
+
+    return it->second;
+}
+
+AttributeCollection::Data &AttributeCollection::Mutable()
+{
+    // anyone else holding these attributes keeps them as they are
+    if (data.use_count() != 1)
+    {
+        data = std::make_shared<Data>(*data);
+    }
+
+    return *data;
 }
 
 void AttributeCollection::insert(Attribute &&a)
 {
-    sortedAttributes.push_back(a);
+    auto &data = Mutable();
 
     if (a.first == "Skip")
     {
-        skipped.first = true;
-        skipped.second = a.second;
+        data.skipped.first = true;
+        data.skipped.second = a.second;
     }
+
+    data.sortedAttributes.push_back(std::move(a));
 }
 
 const std::pair<bool, std::string> &AttributeCollection::Skipped() const
 {
-    return skipped;
+    return data->skipped;
 }
 
 bool AttributeCollection::empty() const
 {
-    return sortedAttributes.empty();
+    return data->sortedAttributes.empty();
 }
 
 AttributeCollection::const_iterator AttributeCollection::begin() const
 {
-    return sortedAttributes.begin();
+    return data->sortedAttributes.begin();
 }
 
 AttributeCollection::const_iterator AttributeCollection::end() const
 {
-    return sortedAttributes.end();
+    return data->sortedAttributes.end();
 }
 
 size_t AttributeCollection::size() const
 {
-    return sortedAttributes.size();
+    return data->sortedAttributes.size();
 }
 
 const AttributeCollection::Attribute &AttributeCollection::operator[](size_t index) const
 {
-    return sortedAttributes[index];
+    return data->sortedAttributes[index];
 }
 
 void AttributeCollection::sort()
 {
-    std::sort(sortedAttributes.begin(), sortedAttributes.end());
+    auto &data = Mutable();
+    std::sort(data.sortedAttributes.begin(), data.sortedAttributes.end());
+}
+
+size_t AttributeCollection::Bytes() const
+{
+    size_t bytes = sizeof(Data) + data->skipped.second.size();
+
+    for (const auto &attribute : data->sortedAttributes)
+    {
+        bytes += sizeof(Attribute) + attribute.first.size() + attribute.second.size() + 2;
+    }
+
+    return bytes;
+}
+
+const void *AttributeCollection::Identity() const
+{
+    return data.get();
 }
 
 AttributeCollection::iterator_range AttributeCollection::find(const Attribute &att) const
@@ -1,14 +1,27 @@
 #include "LineInfo.h"
+#include "StringPool.h"
+
+namespace
+{
+    // most asserts have no line info, and they shouldn't have to wait on the pool to say so
+    const std::string &NoFile()
+    {
+        static const std::string none;
+        return none;
+    }
+}
 
 namespace xUnitpp
 {
 
 LineInfo::LineInfo()
+    : file(NoFile())
+    , line(0)
 {
 }
 
 LineInfo::LineInfo(std::string &&file, int line)
-    : file(std::move(file))
+    : file(file.empty() ? NoFile() : StringPool::Intern(file))
     , line(line)
 {
 }
@@ -0,0 +1,181 @@
+#include "MappedFile.h"
+#include <stdexcept>
+
+#if defined(_WIN32)
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace xUnitpp
+{
+
+std::shared_ptr<const MappedFile> MappedFile::Open(const std::string &path)
+{
+    return std::shared_ptr<const MappedFile>(new MappedFile(path));
+}
+
+std::shared_ptr<const MappedFile> MappedFile::TryOpen(const std::string &path)
+{
+    try
+    {
+        return Open(path);
+    }
+    catch (const std::runtime_error &)
+    {
+        return nullptr;
+    }
+}
+
+#if defined(_WIN32)
+bool MappedFile::Size(const std::string &path, unsigned long long &size)
+{
+    WIN32_FILE_ATTRIBUTE_DATA attributes;
+    if (!GetFileAttributesExA(path.c_str(), GetFileExInfoStandard, &attributes) || (attributes.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0)
+    {
+        return false;
+    }
+
+    size = ((unsigned long long)attributes.nFileSizeHigh << 32) | attributes.nFileSizeLow;
+    return true;
+}
+
+MappedFile::MappedFile(const std::string &path)
+    : data(nullptr)
+    , length(0)
+    , file(INVALID_HANDLE_VALUE)
+    , mapping(nullptr)
+{
+    // shared for writing too, so a log can be read while its run is still adding to it
+    file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+
+    LARGE_INTEGER size;
+    if (file == INVALID_HANDLE_VALUE || !GetFileSizeEx(file, &size))
+    {
+        Close();
+        throw std::runtime_error("Unable to open " + path + ".");
+    }
+
+    length = (size_t)size.QuadPart;
+
+    // empty files can't be mapped, but there's nothing to map anyway
+    if (length != 0)
+    {
+        mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+        if (mapping == nullptr || (data = (const char *)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0)) == nullptr)
+        {
+            Close();
+            throw std::runtime_error("Unable to map " + path + ".");
+        }
+    }
+}
+
+MappedFile::~MappedFile()
+{
+    Close();
+}
+
+void MappedFile::Close()
+{
+    if (data != nullptr)
+    {
+        UnmapViewOfFile(data);
+    }
+
+    if (mapping != nullptr)
+    {
+        CloseHandle(mapping);
+    }
+
+    if (file != INVALID_HANDLE_VALUE)
+    {
+        CloseHandle(file);
+    }
+}
+#else
+bool MappedFile::Size(const std::string &path, unsigned long long &size)
+{
+    struct stat info;
+    if (stat(path.c_str(), &info) != 0 || !S_ISREG(info.st_mode))
+    {
+        return false;
+    }
+
+    size = (unsigned long long)info.st_size;
+    return true;
+}
+
+MappedFile::MappedFile(const std::string &path)
+    : data(nullptr)
+    , length(0)
+{
+    int fd = open(path.c_str(), O_RDONLY);
+
+    struct stat info;
+    if (fd < 0 || fstat(fd, &info) != 0)
+    {
+        if (fd >= 0)
+        {
+            close(fd);
+        }
+
+        throw std::runtime_error("Unable to open " + path + ".");
+    }
+
+    length = (size_t)info.st_size;
+
+    // empty files can't be mapped, but there's nothing to map anyway
+    if (length != 0)
+    {
+        void *mapped = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+
+        if (mapped == MAP_FAILED)
+        {
+            close(fd);
+            throw std::runtime_error("Unable to map " + path + ".");
+        }
+
+        // everything is read front to back, so let the kernel read ahead and drop pages behind us
+        madvise(mapped, length, MADV_SEQUENTIAL);
+
+        data = (const char *)mapped;
+    }
+
+    // the mapping keeps the file open
+    close(fd);
+}
+
+MappedFile::~MappedFile()
+{
+    Close();
+}
+
+void MappedFile::Close()
+{
+    if (data != nullptr)
+    {
+        munmap((void *)data, length);
+    }
+}
+#endif
+
+const char *MappedFile::begin() const
+{
+    return data;
+}
+
+const char *MappedFile::end() const
+{
+    return data + length;
+}
+
+size_t MappedFile::size() const
+{
+    return length;
+}
+
+}
@@ -0,0 +1,44 @@
+#include "StringPool.h"
+#include <mutex>
+#include <unordered_set>
+
+namespace
+{
+    // strings are added while tests register themselves, so the pool has to exist before any of them
+    std::mutex &PoolLock()
+    {
+        static std::mutex lock;
+        return lock;
+    }
+
+    std::unordered_set<std::string> &Pool()
+    {
+        // elements of an unordered_set stay where they are when it grows
+        static std::unordered_set<std::string> pool;
+        return pool;
+    }
+}
+
+namespace xUnitpp { namespace StringPool
+{
+
+const std::string &Intern(const std::string &text)
+{
+    std::lock_guard<std::mutex> guard(PoolLock());
+    return *Pool().insert(text).first;
+}
+
+Usage Report()
+{
+    std::lock_guard<std::mutex> guard(PoolLock());
+
+    Usage usage = { Pool().size(), 0 };
+    for (const auto &text : Pool())
+    {
+        usage.bytes += text.size() + 1;
+    }
+
+    return usage;
+}
+
+}}
@@ -1,21 +1,144 @@
 #include "TestCollection.h"
+#include <algorithm>
 #include <cctype>
 #include <chrono>
+#include <cstring>
+#include <iterator>
 #include <memory>
 #include <string>
 #include <tuple>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 #include "ExportApi.h"
 #include "IOutput.h"
+#include "RunOptions.h"
+#include "StringPool.h"
 #include "TestEventRecorder.h"
+#include "TestManifest.h"
+#include "xUnitCheck.h"
+#include "xUnitLog.h"
 #include "xUnitTestRunner.h"
 #include "xUnitTime.h"
+#include "xUnitWarn.h"
 
 namespace
 {
+    // recorders first: the event sources below hold on to them
+    const std::shared_ptr<xUnitpp::TestEventRecorder> checkRecorder = std::make_shared<xUnitpp::TestEventRecorder>();
+    const std::shared_ptr<xUnitpp::TestEventRecorder> warnRecorder = std::make_shared<xUnitpp::TestEventRecorder>();
+    const std::shared_ptr<xUnitpp::TestEventRecorder> logRecorder = std::make_shared<xUnitpp::TestEventRecorder>();
+
+    class ManifestWriter
+    {
+    public:
+        // a theory's rows are only counted when its source can do so without generating them
+        void Add(const xUnitpp::ITestDetails &details, const xUnitpp::TheorySource *theory)
+        {
+            xUnitpp::Manifest::Test test;
+            test.hash = details.GetStableId();
+            test.id = details.GetId();
+            test.line = details.GetLine();
+            test.instanceCount = theory != nullptr ? KnownCount(*theory) : 1;
+            test.flags = theory != nullptr ? (uint32_t)xUnitpp::Manifest::IsTheory : 0;
+            test.suite = String(details.GetSuite());
+            test.name = String(details.GetName());
+            test.file = String(details.GetFile());
+            test.firstAttribute = (uint32_t)attributes.size();
+            test.attributeCount = (uint32_t)details.GetAttributeCount();
+
+            for (size_t i = 0; i != details.GetAttributeCount(); ++i)
+            {
+                xUnitpp::Manifest::Attribute attribute;
+                attribute.key = String(details.GetAttributeKey(i));
+                attribute.value = String(details.GetAttributeValue(i));
+                attributes.push_back(attribute);
+            }
+
+            tests.push_back(test);
+        }
+
+        std::vector<char> Write() const
+        {
+            xUnitpp::Manifest::Header header;
+            std::copy(std::begin(xUnitpp::Manifest::Magic), std::end(xUnitpp::Manifest::Magic), header.magic);
+            header.version = xUnitpp::Manifest::Version;
+            header.testCount = (uint32_t)tests.size();
+            header.attributeCount = (uint32_t)attributes.size();
+            header.stringsSize = (uint32_t)strings.size();
+
+            std::vector<char> manifest;
+            manifest.reserve(sizeof(header) + tests.size() * sizeof(tests[0]) + attributes.size() * sizeof(attributes[0]) + strings.size());
+
+            Append(manifest, &header, sizeof(header));
+            Append(manifest, tests.data(), tests.size() * sizeof(tests[0]));
+            Append(manifest, attributes.data(), attributes.size() * sizeof(attributes[0]));
+            Append(manifest, strings.data(), strings.size());
+
+            return manifest;
+        }
+
+    private:
+        // a manifest is built inside GetTestManifest, which nothing may throw out of
+        static int KnownCount(const xUnitpp::TheorySource &theory)
+        {
+            try
+            {
+                return theory.KnownCount();
+            }
+            catch (...)
+            {
+                return xUnitpp::TheorySource::UnknownCount;
+            }
+        }
+
+        static void Append(std::vector<char> &manifest, const void *data, size_t size)
+        {
+            manifest.insert(manifest.end(), (const char *)data, (const char *)data + size);
+        }
+
+        // suites, files and attributes repeat a lot, so each string is only stored once
+        uint32_t String(const char *text)
+        {
+            auto it = offsets.find(text);
+            if (it != offsets.end())
+            {
+                return it->second;
+            }
+
+            auto offset = (uint32_t)strings.size();
+            strings.append(text, std::strlen(text) + 1);
+            offsets.insert(std::make_pair(std::string(text), offset));
+
+            return offset;
+        }
+
+    private:
+        std::vector<xUnitpp::Manifest::Test> tests;
+        std::vector<xUnitpp::Manifest::Attribute> attributes;
+        std::string strings;
+        std::unordered_map<std::string, uint32_t> offsets;
+    };
+
+    extern "C" __declspec(dllexport) const void *GetTestManifest(size_t &size)
+    {
+        const auto &manifest = xUnitpp::TestCollection::Instance().Manifest();
+
+        size = manifest.size();
+        return manifest.data();
+    }
+
     extern "C" __declspec(dllexport) void EnumerateTestDetails(xUnitpp::EnumerateTestDetailsCallback callback)
     {
-        for (const auto &test : xUnitpp::TestCollection::Instance().Tests())
+        auto &collection = xUnitpp::TestCollection::Instance();
+
+        // listing a recorded test doesn't build it
+        for (const auto &record : collection.Records())
+        {
+            callback(record);
+        }
+
+        for (const auto &test : collection.Registered())
         {
             callback(test->TestDetails());
         }
@@ -23,32 +146,252 @@ namespace
 
     extern "C" __declspec(dllexport) int FilteredTestsRunner(int timeLimit, int threadLimit, xUnitpp::IOutput &testReporter, xUnitpp::TestFilterCallback filter)
     {
-        return xUnitpp::RunTests(testReporter, filter, xUnitpp::TestCollection::Instance().Tests(),
+        auto &collection = xUnitpp::TestCollection::Instance();
+
+        // only the recorded tests which are going to run are built
+        std::vector<std::shared_ptr<xUnitpp::xUnitTest>> tests(collection.Registered());
+        for (const auto &record : collection.Records())
+        {
+            if (filter(record))
+            {
+                tests.push_back(record.Test());
+            }
+        }
+
+        return xUnitpp::RunTests(testReporter, filter, tests,
             xUnitpp::Time::ToDuration(xUnitpp::Time::ToMilliseconds(timeLimit)), threadLimit);
     }
+
+    extern "C" __declspec(dllexport) void GetRegistryFootprint(xUnitpp::RegistryFootprint &footprint)
+    {
+        footprint = xUnitpp::TestCollection::Instance().Footprint();
+    }
+
+    extern "C" __declspec(dllexport) int SelectedTestsRunner(const xUnitpp::RunOptions &runOptions, xUnitpp::IOutput &testReporter)
+    {
+        // options from an older runner stop short of the newer fields, which keep their defaults
+        xUnitpp::RunOptions options;
+        std::memcpy(&options, &runOptions, std::min<size_t>(runOptions.size, sizeof(options)));
+        options.size = sizeof(options);
+
+        return xUnitpp::RunTests(testReporter, xUnitpp::TestCollection::Instance().Select(options), options);
+    }
 }
 
 namespace xUnitpp
 {
 
+// Every test the macros define refers to these, which is also what links the exports above into a test library.
+namespace Events
+{
+    const xUnitpp::Check Check(*checkRecorder);
+    const xUnitpp::Warn Warn(*warnRecorder);
+    const xUnitpp::Log Log(*logRecorder);
+
+    const std::vector<std::shared_ptr<TestEventRecorder>> &Recorders()
+    {
+        // !!!VS use an initializer list when VS implements them
+        static const std::shared_ptr<TestEventRecorder> all[] = { checkRecorder, warnRecorder, logRecorder };
+        static const std::vector<std::shared_ptr<TestEventRecorder>> recorders(std::begin(all), std::end(all));
+        return recorders;
+    }
+}
+
+TestCollection::TestCollection()
+    : mFirst(nullptr)
+    , mLast(nullptr)
+{
+}
+
+TestCollection::TestCollection(const TestRecord *const *first, const TestRecord *const *last)
+    : mFirst(first)
+    , mLast(last)
+{
+}
+
 TestCollection &TestCollection::Instance()
 {
-    static TestCollection collection;
+    static TestCollection collection(LinkedTestRecords().first, LinkedTestRecords().second);
     return collection;
 }
 
 TestCollection::Register::Register(TestCollection &collection, std::function<void()> &&fn, std::string &&name, const std::string &suite,
             AttributeCollection &&attributes, int milliseconds, std::string &&filename, int line, std::vector<std::shared_ptr<TestEventRecorder>> &&testEventRecorders)
 {
-    collection.mTests.push_back(std::make_shared<xUnitTest>(std::move(fn), std::move(name), 0, "", suite, std::move(attributes), Time::ToDuration(Time::ToMilliseconds(milliseconds)), std::move(filename), line, std::move(testEventRecorders)));
+    collection.mRegistered.push_back(std::make_shared<xUnitTest>(std::move(fn), std::move(name), 0, "", suite, std::move(attributes), Time::ToDuration(Time::ToMilliseconds(milliseconds)), std::move(filename), line, std::move(testEventRecorders)));
 }
 
 const std::vector<std::shared_ptr<xUnitTest>> &TestCollection::Tests()
 {
+    if (mFirst == mLast)
+    {
+        // registered tests may still need their stable ids told apart
+        Records();
+        return mRegistered;
+    }
+
+    std::call_once(mTestsBuilt, [this]()
+        {
+            mTests = mRegistered;
+
+            for (const auto &record : Records())
+            {
+                mTests.push_back(record.Test());
+            }
+        });
+
     return mTests;
 }
 
-std::deque<std::string> TestCollection::Register::SplitParams(std::string &&params)
+const std::deque<RecordDetails> &TestCollection::Records()
+{
+    std::call_once(mRecordsFound, [this]()
+        {
+            int count = (int)std::count_if(mFirst, mLast, [](const TestRecord *record) { return record != nullptr; });
+            int id = TestDetails::ReserveIds(count);
+
+            // Stable ids are checked for collisions here, before anything can have asked for one.
+            // Every test in a collision is told apart by where it is written, so which of them was found first doesn't matter.
+            std::vector<unsigned long long> stableIds;
+            std::unordered_map<unsigned long long, int> uses;
+
+            for (auto it = mFirst; it != mLast; ++it)
+            {
+                if (*it != nullptr)
+                {
+                    stableIds.push_back(xUnitpp::Manifest::StableHash((*it)->suite().c_str(), (*it)->name));
+                    ++uses[stableIds.back()];
+                }
+            }
+
+            for (const auto &test : mRegistered)
+            {
+                ++uses[test->testDetails.StableId];
+            }
+
+            auto unique = [&](unsigned long long stableId, const char *file, int line)
+                {
+                    return uses[stableId] > 1 ? xUnitpp::Manifest::StableHash(stableId, file, line) : stableId;
+                };
+
+            auto stableId = stableIds.begin();
+            for (auto it = mFirst; it != mLast; ++it)
+            {
+                if (*it != nullptr)
+                {
+                    mRecords.emplace_back(**it, id++, unique(*stableId++, (*it)->file, (*it)->line));
+                }
+            }
+
+            for (const auto &test : mRegistered)
+            {
+                auto &details = test->testDetails;
+                details.StableId = unique(details.StableId, details.LineInfo.file.c_str(), details.LineInfo.line);
+            }
+        });
+
+    return mRecords;
+}
+
+const std::vector<std::shared_ptr<xUnitTest>> &TestCollection::Registered() const
+{
+    return mRegistered;
+}
+
+const std::vector<char> &TestCollection::Manifest()
+{
+    std::call_once(mManifestBuilt, [this]()
+        {
+            ManifestWriter writer;
+
+            for (const auto &record : Records())
+            {
+                writer.Add(record, record.IsTheory() ? record.Test()->TestDetails().Theory.get() : nullptr);
+            }
+
+            for (const auto &test : mRegistered)
+            {
+                writer.Add(test->TestDetails(), test->TestDetails().Theory.get());
+            }
+
+            mManifest = writer.Write();
+        });
+
+    return mManifest;
+}
+
+RegistryFootprint TestCollection::Footprint()
+{
+    RegistryFootprint footprint = {};
+    std::unordered_set<const void *> attributeSets;
+
+    for (const auto &test : Tests())
+    {
+        const auto &details = test->TestDetails();
+
+        ++footprint.tests;
+        footprint.unsharedBytes += details.Suite.size() + 1 + details.LineInfo.file.size() + 1 + details.Attributes.Bytes();
+
+        if (attributeSets.insert(details.Attributes.Identity()).second)
+        {
+            footprint.sharedBytes += details.Attributes.Bytes();
+        }
+    }
+
+    // the pool also holds the files of any asserts that have failed with line info, so this errs on the high side
+    auto strings = StringPool::Report();
+
+    footprint.sharedBytes += strings.bytes;
+    footprint.internedStrings = strings.strings;
+    footprint.attributeSets = attributeSets.size();
+
+    return footprint;
+}
+
+const TestTable &TestCollection::Table()
+{
+    std::call_once(mTableBuilt, [this]()
+        {
+            // stable ids are only final once the records have been found
+            auto &records = Records();
+
+            for (const auto &test : mRegistered)
+            {
+                const auto &details = test->TestDetails();
+                mTable.Add(details.GetId(), details.StableId, details.Suite, (int)Time::ToMilliseconds(details.TimeLimit).count(), details.Attributes.Skipped().first);
+            }
+
+            for (const auto &record : records)
+            {
+                mTable.Add(record.GetId(), record.GetStableId(), StringPool::Intern(record.Record().suite()), record.Record().milliseconds, record.IsSkipped());
+            }
+        });
+
+    return mTable;
+}
+
+std::shared_ptr<xUnitTest> TestCollection::Test(uint32_t row)
+{
+    return row < mRegistered.size() ? mRegistered[row] : Records()[row - mRegistered.size()].Test();
+}
+
+std::vector<std::shared_ptr<xUnitTest>> TestCollection::Select(const RunOptions &options)
+{
+    // only the rows chosen are looked at again, so unselected records are never built
+    auto rows = Table().Select(options);
+
+    std::vector<std::shared_ptr<xUnitTest>> tests;
+    tests.reserve(rows.size());
+
+    for (auto row : rows)
+    {
+        tests.push_back(Test(row));
+    }
+
+    return tests;
+}
+
+std::deque<std::string> TestCollection::SplitParams(std::string &&params)
 {
     // hopefully simple rules:
     //
@@ -1,13 +1,18 @@
 #include "TestDetails.h"
+#include <atomic>
 #include <utility>
+#include "StringPool.h"
+#include "TestManifest.h"
+#include "xUnitTheory.h"
 #include "xUnitTime.h"
 
 namespace
 {
-    inline int NextId()
+    inline int NextId(int count = 1)
     {
-        static int id = 0;
-        return id++;
+        // theory rows are created while tests are running
+        static std::atomic<int> id(0);
+        return id.fetch_add(count);
     }
 
     std::string GetFullName(const std::string &name, int testInstance, const std::string &params)
@@ -24,23 +29,100 @@ namespace
 namespace xUnitpp
 {
 
+TestDetails::Definition::Definition()
+    : Suite(StringPool::Intern(std::string()))
+    , TimeLimit(Time::Duration::zero())
+{
+}
+
+TestDetails::Definition::Definition(std::string &&name, const std::string &suite, AttributeCollection &&attributes, Time::Duration timeLimit,
+                                    std::string &&filename, int line)
+    : Name(std::move(name))
+    , Suite(StringPool::Intern(suite))
+    , Attributes(AttributeCollection::Shared(std::move(attributes)))
+    , TimeLimit(timeLimit)
+    , LineInfo(std::move(filename), line)
+{
+}
+
 TestDetails::TestDetails()
-    : LineInfo()
+    : definition(std::make_shared<Definition>())
+    , text(std::make_shared<Text>())
+    , StableId(0)
+    , Name(definition->Name)
+    , Suite(definition->Suite)
+    , Attributes(definition->Attributes)
+    , TimeLimit(definition->TimeLimit)
+    , LineInfo(definition->LineInfo)
 {
 }
 
 TestDetails::TestDetails(std::string &&name, int testInstance, std::string &&params, const std::string &suite, AttributeCollection &&attributes,
                          Time::Duration timeLimit, std::string &&filename, int line)
-    : Id(NextId())
+    : definition(std::make_shared<Definition>(std::move(name), suite, std::move(attributes), timeLimit, std::move(filename), line))
+    , text(std::make_shared<Text>())
+    , Id(NextId())
+    , StableId(Manifest::StableHash(definition->Suite.c_str(), definition->Name.c_str()))
     , TestInstance(testInstance)
-    , Name(std::move(name))
-    , Params(std::move(params))
-    , FullName(::GetFullName(Name, testInstance, Params))
-    , Suite(suite)
-    , Attributes(std::move(attributes))
-    , TimeLimit(timeLimit)
-    , LineInfo(std::move(filename), line)
+    , Name(definition->Name)
+    , Suite(definition->Suite)
+    , Attributes(definition->Attributes)
+    , TimeLimit(definition->TimeLimit)
+    , LineInfo(definition->LineInfo)
+{
+    text->Params = std::move(params);
+    text->FullName = ::GetFullName(Name, testInstance, text->Params);
+}
+
+TestDetails::TestDetails(int id, unsigned long long stableId, std::string &&name, const std::string &suite, AttributeCollection &&attributes,
+                         Time::Duration timeLimit, std::string &&filename, int line)
+    : definition(std::make_shared<Definition>(std::move(name), suite, std::move(attributes), timeLimit, std::move(filename), line))
+    , text(std::make_shared<Text>())
+    , Id(id)
+    , StableId(stableId)
+    , TestInstance(0)
+    , Name(definition->Name)
+    , Suite(definition->Suite)
+    , Attributes(definition->Attributes)
+    , TimeLimit(definition->TimeLimit)
+    , LineInfo(definition->LineInfo)
+{
+    text->FullName = Name;
+}
+
+TestDetails::TestDetails(const TestDetails &theory, int testInstance, std::function<std::string()> &&params)
+    : definition(theory.definition)
+    , text(std::make_shared<Text>())
+    , Id(NextId())
+    , StableId(theory.StableId)
+    , TestInstance(testInstance)
+    , Name(definition->Name)
+    , Suite(definition->Suite)
+    , Attributes(definition->Attributes)
+    , TimeLimit(definition->TimeLimit)
+    , LineInfo(definition->LineInfo)
 {
+    text->format = std::move(params);
+}
+
+void TestDetails::Format() const
+{
+    auto &text = *this->text;
+    auto testInstance = TestInstance;
+    auto &name = Name;
+    auto stableId = StableId;
+
+    std::call_once(text.formatted, [&]()
+        {
+            if (text.format)
+            {
+                text.Params = text.format();
+                text.FullName = ::GetFullName(name, testInstance, text.Params);
+                text.format = nullptr;
+            }
+
+            text.StableId = text.Params.empty() && testInstance == 0 ? stableId : Manifest::StableHash(stableId, testInstance, text.Params.c_str());
+        });
 }
 
 int __stdcall TestDetails::GetId() const
@@ -55,7 +137,8 @@ const char * __stdcall TestDetails::GetName() const
 
 const char * __stdcall TestDetails::GetFullName() const 
 {
-    return FullName.c_str();
+    Format();
+    return text->FullName.c_str();
 }
 
 const char * __stdcall TestDetails::GetSuite() const 
@@ -65,7 +148,8 @@ const char * __stdcall TestDetails::GetSuite() const
 
 const char * __stdcall TestDetails::GetParams() const
 {
-    return Params.c_str();
+    Format();
+    return text->Params.c_str();
 }
 
 int __stdcall TestDetails::GetTestInstance() const
@@ -73,6 +157,12 @@ int __stdcall TestDetails::GetTestInstance() const
     return TestInstance;
 }
 
+int __stdcall TestDetails::GetInstanceCount() const
+{
+    // reporters ask for this with every report, so it never calls a provider which could build the data
+    return Theory ? Theory->KnownCount() : 1;
+}
+
 size_t __stdcall TestDetails::GetAttributeCount() const 
 {
     return Attributes.size();
@@ -93,7 +183,7 @@ void __stdcall TestDetails::FindAttributeKey(const char *key, size_t &begin, siz
     auto range = Attributes.find(AttributeCollection::Attribute(key, ""));
 
     begin = std::distance(Attributes.begin(), range.first);
-    end = std::distance(Attributes.end(), range.second);
+    end = std::distance(Attributes.begin(), range.second);
 }
 
 const char * __stdcall TestDetails::GetFile() const 
@@ -106,5 +196,16 @@ int __stdcall TestDetails::GetLine() const
     return LineInfo.line;
 }
 
+unsigned long long __stdcall TestDetails::GetStableId() const
+{
+    Format();
+    return text->StableId;
+}
+
+int TestDetails::ReserveIds(int count)
+{
+    return NextId(count);
+}
+
 
 }
@@ -0,0 +1,145 @@
+#include "TestRecord.h"
+#include <iterator>
+#include <tuple>
+#include "xUnitTest.h"
+
+#if defined(_MSC_VER)
+# pragma section("xUnit$a", read)
+# pragma section("xUnit$z", read)
+
+namespace
+{
+    __declspec(allocate("xUnit$a")) const xUnitpp::TestRecord *const firstRecord = nullptr;
+    __declspec(allocate("xUnit$z")) const xUnitpp::TestRecord *const lastRecord = nullptr;
+}
+#else
+// defined by the linker, as long as at least one record has been placed in the section
+extern "C" const xUnitpp::TestRecord *const __start_xunitpp_tests[] __attribute__((weak, visibility("hidden")));
+extern "C" const xUnitpp::TestRecord *const __stop_xunitpp_tests[] __attribute__((weak, visibility("hidden")));
+#endif
+
+namespace xUnitpp
+{
+
+std::pair<const TestRecord *const *, const TestRecord *const *> LinkedTestRecords()
+{
+#if defined(_MSC_VER)
+    return std::make_pair(&firstRecord + 1, &lastRecord);
+#else
+    return std::make_pair(__start_xunitpp_tests, __stop_xunitpp_tests);
+#endif
+}
+
+RecordDetails::RecordDetails(const TestRecord &record, int id, unsigned long long stableId)
+    : record(record)
+    , id(id)
+    , stableId(stableId)
+{
+}
+
+const AttributeCollection &RecordDetails::Attributes() const
+{
+    std::call_once(attributesFound, [this]() { attributes = AttributeCollection::Shared(record.attributes()); });
+    return attributes;
+}
+
+std::shared_ptr<xUnitTest> RecordDetails::Test() const
+{
+    std::call_once(built, [this]()
+        {
+            test = std::make_shared<xUnitTest>(id, stableId, record, AttributeCollection(Attributes()), Events::Recorders());
+        });
+
+    return test;
+}
+
+bool RecordDetails::IsTheory() const
+{
+    return record.theory != nullptr;
+}
+
+bool RecordDetails::IsSkipped() const
+{
+    return Attributes().Skipped().first;
+}
+
+const TestRecord &RecordDetails::Record() const
+{
+    return record;
+}
+
+int __stdcall RecordDetails::GetId() const
+{
+    return id;
+}
+
+const char * __stdcall RecordDetails::GetName() const
+{
+    return record.name;
+}
+
+const char * __stdcall RecordDetails::GetFullName() const
+{
+    // only theory rows have parameters in their name
+    return record.name;
+}
+
+const char * __stdcall RecordDetails::GetSuite() const
+{
+    return record.suite().c_str();
+}
+
+const char * __stdcall RecordDetails::GetParams() const
+{
+    return "";
+}
+
+int __stdcall RecordDetails::GetTestInstance() const
+{
+    return 0;
+}
+
+int __stdcall RecordDetails::GetInstanceCount() const
+{
+    return IsTheory() ? Test()->TestDetails().GetInstanceCount() : 1;
+}
+
+size_t __stdcall RecordDetails::GetAttributeCount() const
+{
+    return Attributes().size();
+}
+
+const char * __stdcall RecordDetails::GetAttributeKey(size_t index) const
+{
+    return std::get<0>(Attributes()[index]).c_str();
+}
+
+const char * __stdcall RecordDetails::GetAttributeValue(size_t index) const
+{
+    return std::get<1>(Attributes()[index]).c_str();
+}
+
+void __stdcall RecordDetails::FindAttributeKey(const char *key, size_t &begin, size_t &end) const
+{
+    auto range = Attributes().find(AttributeCollection::Attribute(key, ""));
+
+    begin = std::distance(Attributes().begin(), range.first);
+    end = std::distance(Attributes().begin(), range.second);
+}
+
+const char * __stdcall RecordDetails::GetFile() const
+{
+    return record.file;
+}
+
+int __stdcall RecordDetails::GetLine() const
+{
+    return record.line;
+}
+
+unsigned long long __stdcall RecordDetails::GetStableId() const
+{
+    return stableId;
+}
+
+}
@@ -0,0 +1,145 @@
+#include "TestTable.h"
+#include <algorithm>
+#include "RunOptions.h"
+
+namespace xUnitpp
+{
+
+TestTable::TestTable()
+    : idsAscending(true)
+{
+}
+
+uint32_t TestTable::Add(int id, unsigned long long stableId, const std::string &suite, int milliseconds, bool skipped)
+{
+    auto row = (uint32_t)ids.size();
+
+    if (!ids.empty() && id <= ids.back())
+    {
+        idsAscending = false;
+    }
+
+    auto it = suiteLookup.find(&suite);
+    if (it == suiteLookup.end())
+    {
+        it = suiteLookup.insert(std::make_pair(&suite, (uint32_t)suiteNames.size())).first;
+        suiteNames.push_back(&suite);
+    }
+
+    ids.push_back(id);
+    stableIds.push_back(stableId);
+    suites.push_back(it->second);
+    timeLimits.push_back(milliseconds);
+    this->skipped.push_back(skipped ? 1 : 0);
+
+    return row;
+}
+
+size_t TestTable::size() const
+{
+    return ids.size();
+}
+
+std::vector<uint32_t> TestTable::Select(const RunOptions &options) const
+{
+    // shards are chosen by stable id, so every process running a shard agrees on which tests are in it
+    auto inShard = [&](uint32_t row)
+        {
+            return options.shardCount == 0 || stableIds[row] % options.shardCount == options.shardIndex;
+        };
+
+    std::vector<uint32_t> rows;
+
+    if (options.selection == RunOptions::SelectIds && idsAscending)
+    {
+        // both lists are sorted, so each id is searched for only past the last one found
+        auto from = ids.begin();
+        for (auto id = options.ids; id != options.ids + options.idCount; ++id)
+        {
+            from = std::lower_bound(from, ids.end(), *id);
+            if (from != ids.end() && *from == *id && inShard((uint32_t)(from - ids.begin())))
+            {
+                rows.push_back((uint32_t)(from - ids.begin()));
+            }
+        }
+
+        return rows;
+    }
+
+    auto selected = [&](int id)
+        {
+            switch (options.selection)
+            {
+            case RunOptions::SelectIds:
+                return std::binary_search(options.ids, options.ids + options.idCount, id);
+
+            case RunOptions::SelectBitmap:
+                {
+                    auto bit = (size_t)((long long)id - options.firstId);
+                    return id >= options.firstId && bit < options.bitCount && (options.bitmap[bit / 64] & (1ULL << (bit % 64))) != 0;
+                }
+
+            default:
+                return true;
+            }
+        };
+
+    for (uint32_t row = 0; row != (uint32_t)ids.size(); ++row)
+    {
+        if (selected(ids[row]) && inShard(row))
+        {
+            rows.push_back(row);
+        }
+    }
+
+    return rows;
+}
+
+void TestTable::SortBySuite(std::vector<uint32_t> &rows) const
+{
+    // suites are ranked by name once, so sorting compares numbers rather than strings
+    std::vector<uint32_t> byName(suiteNames.size());
+    for (uint32_t suite = 0; suite != (uint32_t)byName.size(); ++suite)
+    {
+        byName[suite] = suite;
+    }
+
+    std::sort(byName.begin(), byName.end(), [&](uint32_t lhs, uint32_t rhs) { return *suiteNames[lhs] < *suiteNames[rhs]; });
+
+    std::vector<uint32_t> rank(suiteNames.size());
+    for (uint32_t i = 0; i != (uint32_t)byName.size(); ++i)
+    {
+        rank[byName[i]] = i;
+    }
+
+    // the keys are gathered next to their rows, so the sort itself only ever looks at one array
+    struct Key
+    {
+        uint32_t suite;
+        uint32_t row;
+        unsigned long long stableId;
+
+        bool operator <(const Key &other) const
+        {
+            return suite != other.suite ? suite < other.suite : stableId < other.stableId;
+        }
+    };
+
+    std::vector<Key> keys;
+    keys.reserve(rows.size());
+
+    for (auto row : rows)
+    {
+        Key key = { rank[suites[row]], row, stableIds[row] };
+        keys.push_back(key);
+    }
+
+    std::sort(keys.begin(), keys.end());
+
+    for (size_t i = 0; i != keys.size(); ++i)
+    {
+        rows[i] = keys[i].row;
+    }
+}
+
+}
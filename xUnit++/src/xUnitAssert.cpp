@@ -1,5 +1,381 @@
 #include "xUnitAssert.h"
+#include <algorithm>
 #include <cmath>
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <future>
+#include <limits>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "xUnitDiff.h"
+
+namespace
+{
+    // strings up to this length are always printed in full
+    const size_t StringWindowLength = 80;
+    const size_t StringWindowBefore = 24;
+
+    // characters of unchanged text printed around each change of a single line diff
+    const size_t InlineContextLength = 20;
+
+    size_t FirstMismatch(const std::string &expected, const std::string &actual)
+    {
+        auto length = std::min(expected.size(), actual.size());
+        return std::mismatch(expected.begin(), expected.begin() + length, actual.begin()).first - expected.begin();
+    }
+
+    std::string Clip(const std::string &value, size_t offset, size_t length)
+    {
+        return xUnitpp::Diff::Truncate(value.substr(offset, std::min(length, xUnitpp::Diff::MaxElementLength + 1)));
+    }
+
+    std::string StringWindow(const std::string &value, size_t focus)
+    {
+        if (value.size() <= StringWindowLength)
+        {
+            return value;
+        }
+
+        size_t first = std::min(focus > StringWindowBefore ? focus - StringWindowBefore : 0, value.size() - StringWindowLength);
+
+        return (first != 0 ? "..." : "") + value.substr(first, StringWindowLength) + (first + StringWindowLength != value.size() ? "..." : "");
+    }
+
+    std::vector<std::pair<size_t, size_t>> SplitLines(const std::string &value)
+    {
+        std::vector<std::pair<size_t, size_t>> lines;
+
+        size_t begin = 0;
+        for (size_t end = value.find('\n'); end != std::string::npos; end = value.find('\n', begin))
+        {
+            lines.push_back(std::make_pair(begin, end - begin));
+            begin = end + 1;
+        }
+
+        lines.push_back(std::make_pair(begin, value.size() - begin));
+
+        return lines;
+    }
+
+    std::string LineDiff(const std::string &expected, const std::string &actual)
+    {
+        auto expectedLines = SplitLines(expected);
+        auto actualLines = SplitLines(actual);
+
+        auto edits = xUnitpp::Diff::Compute(expectedLines.size(), actualLines.size(),
+            [&](size_t e, size_t a)
+            {
+                return expectedLines[e].second == actualLines[a].second &&
+                    expected.compare(expectedLines[e].first, expectedLines[e].second, actual, actualLines[a].first, actualLines[a].second) == 0;
+            });
+
+        return xUnitpp::Diff::Render(edits,
+            [&](size_t e) { return Clip(expected, expectedLines[e].first, expectedLines[e].second); },
+            [&](size_t a) { return Clip(actual, actualLines[a].first, actualLines[a].second); });
+    }
+
+    // single line strings are diffed by character, and changes are marked inline: unchanged[-expected-]{+actual+}unchanged
+    std::string InlineDiff(const std::string &expected, const std::string &actual)
+    {
+        using xUnitpp::Diff::Edit;
+
+        auto edits = xUnitpp::Diff::Compute(expected.size(), actual.size(), [&](size_t e, size_t a) { return expected[e] == actual[a]; });
+        auto hunks = xUnitpp::Diff::Hunks(edits, InlineContextLength);
+
+        std::string result;
+        size_t shown = 0;
+
+        for (const auto &hunk : hunks)
+        {
+            if (shown == xUnitpp::Diff::MaxHunks || result.size() > xUnitpp::Diff::MaxReportLength)
+            {
+                break;
+            }
+
+            const auto &first = edits[hunk.firstEdit];
+            result += "\n     @@ position " + std::to_string(first.expected) + " @@ ";
+
+            if (hunk.leading != 0)
+            {
+                result += (first.expected - hunk.leading != 0 ? "..." : "") + expected.substr(first.expected - hunk.leading, hunk.leading);
+            }
+
+            for (auto idx = hunk.firstEdit; idx <= hunk.lastEdit; ++idx)
+            {
+                const auto &edit = edits[idx];
+
+                switch (edit.kind)
+                {
+                case Edit::Equal:
+                    result += expected.substr(edit.expected, edit.length);
+                    break;
+                case Edit::Delete:
+                    result += "[-" + Clip(expected, edit.expected, edit.length) + "-]";
+                    break;
+                case Edit::Insert:
+                    result += "{+" + Clip(actual, edit.actual, edit.length) + "+}";
+                    break;
+                }
+            }
+
+            if (hunk.trailing != 0)
+            {
+                const auto &next = edits[hunk.lastEdit + 1];
+                result += expected.substr(next.expected, hunk.trailing) + (next.expected + hunk.trailing != expected.size() ? "..." : "");
+            }
+
+            ++shown;
+        }
+
+        if (shown != hunks.size())
+        {
+            result += "\n     (" + std::to_string(hunks.size() - shown) + " more differences not shown)";
+        }
+
+        return result;
+    }
+
+    std::string StringDiffMessage(const std::string &expected, const std::string &actual)
+    {
+        auto position = FirstMismatch(expected, actual);
+        auto multiline = expected.find('\n') != std::string::npos || actual.find('\n') != std::string::npos;
+
+        std::string message = "Strings differ at position " + std::to_string(position);
+
+        if (multiline)
+        {
+            auto lineStart = expected.rfind('\n', position == 0 ? 0 : position - 1);
+            auto line = std::count(expected.begin(), expected.begin() + position, '\n') + 1;
+            auto column = (lineStart == std::string::npos || position == 0) ? position + 1 : position - lineStart;
+
+            message += " (line " + std::to_string(line) + ", column " + std::to_string(column) + ")";
+        }
+
+        message += ".";
+
+        if (expected.size() != actual.size())
+        {
+            message += " Expected length " + std::to_string(expected.size()) + ", actual length " + std::to_string(actual.size()) + ".";
+        }
+
+        if (multiline)
+        {
+            message += LineDiff(expected, actual);
+        }
+        else if (expected.size() > StringWindowLength || actual.size() > StringWindowLength)
+        {
+            message += InlineDiff(expected, actual);
+        }
+
+        return message;
+    }
+
+    // haystacks shorter than this are left to std::string::find
+    const size_t LargeHaystackLength = 4096;
+
+    // Boyer-Moore-Horspool: the skip table lets the search step over most of the haystack
+    // instead of restarting at every occurrence of the needle's first character.
+    size_t FindSubstring(const std::string &haystack, const std::string &needle)
+    {
+        if (haystack.size() < LargeHaystackLength || needle.size() < 4 || needle.size() > haystack.size())
+        {
+            return haystack.find(needle);
+        }
+
+        size_t skip[256];
+        std::fill(skip, skip + 256, needle.size());
+
+        const size_t last = needle.size() - 1;
+        for (size_t i = 0; i != last; ++i)
+        {
+            skip[(unsigned char)needle[i]] = last - i;
+        }
+
+        for (size_t position = 0; position + needle.size() <= haystack.size(); position += skip[(unsigned char)haystack[position + last]])
+        {
+            if (haystack[position + last] == needle[last] && haystack.compare(position, last, needle, 0, last) == 0)
+            {
+                return position;
+            }
+        }
+
+        return std::string::npos;
+    }
+
+    // ranges shorter than this are not worth a thread of their own
+    const size_t MinParallelChunk = 4096;
+
+    std::string FormatNumber(double value, int precision)
+    {
+        char buffer[64];
+        std::snprintf(buffer, sizeof(buffer), "%.*g", precision, value);
+        return buffer;
+    }
+
+    // Counting failures is kept apart from finding the worst one, so the counting loop has no
+    // branches and vectorises. Only blocks which contain a failure are scanned a second time.
+    const size_t NearBlockLength = 1024;
+
+    template<typename T>
+    struct NearKernel
+    {
+        NearKernel(double absolute, double relative)
+            : absolute(static_cast<T>(absolute))
+            , relative(static_cast<T>(relative))
+        {
+        }
+
+        size_t Count(const T *expected, const T *actual, size_t count) const
+        {
+            size_t failures = 0;
+
+            for (size_t i = 0; i != count; ++i)
+            {
+                failures += !Passes(expected[i], actual[i]);
+            }
+
+            return failures;
+        }
+
+        double Error(T expected, T actual) const
+        {
+            if (expected == actual)
+            {
+                return 0.0;
+            }
+
+            const T error = std::abs(expected - actual);
+            return error == error ? error : std::numeric_limits<double>::infinity();
+        }
+
+        bool Fails(T expected, T actual) const
+        {
+            return !Passes(expected, actual);
+        }
+
+        // Tolerance only applies between finite values: an infinity passes only against the same
+        // infinity, and NaN never passes. Otherwise a relative tolerance around an infinite
+        // expected value would be infinite too, and accept anything.
+        bool Passes(T expected, T actual) const
+        {
+            const T largest = std::numeric_limits<T>::max();
+            const bool finite = (std::abs(expected) <= largest) & (std::abs(actual) <= largest);
+            const bool within = std::abs(expected - actual) <= std::max(absolute, relative * std::abs(expected));
+
+            // & and | rather than && and ||, to keep Count's loop free of branches
+            return (expected == actual) | (finite & within);
+        }
+
+        T absolute;
+        T relative;
+    };
+
+    template<typename T>
+    struct FloatBits;
+
+    template<>
+    struct FloatBits<float>
+    {
+        typedef std::uint32_t type;
+    };
+
+    template<>
+    struct FloatBits<double>
+    {
+        typedef std::uint64_t type;
+    };
+
+    template<typename T>
+    struct UlpKernel
+    {
+        typedef typename FloatBits<T>::type bits;
+
+        UlpKernel(size_t ulps)
+            : ulps(static_cast<bits>(std::min<std::uint64_t>(ulps, std::numeric_limits<bits>::max())))
+        {
+        }
+
+        // Maps the representation onto an unsigned scale on which neighbouring values are neighbouring
+        // integers. -0 and +0 map to the same point.
+        static bits Biased(T value)
+        {
+            static const bits sign = bits(1) << (sizeof(bits) * 8 - 1);
+
+            bits raw;
+            std::memcpy(&raw, &value, sizeof(raw));
+
+            const bits negative = bits(0) - (raw >> (sizeof(bits) * 8 - 1));
+            return ((~raw + 1) & negative) | ((raw | sign) & ~negative);
+        }
+
+        static bits Distance(T expected, T actual)
+        {
+            const bits e = Biased(expected);
+            const bits a = Biased(actual);
+            return e > a ? e - a : a - e;
+        }
+
+        size_t Count(const T *expected, const T *actual, size_t count) const
+        {
+            size_t failures = 0;
+
+            for (size_t i = 0; i != count; ++i)
+            {
+                failures += (Distance(expected[i], actual[i]) > ulps) | (expected[i] != expected[i]) | (actual[i] != actual[i]);
+            }
+
+            return failures;
+        }
+
+        double Error(T expected, T actual) const
+        {
+            if (expected != expected || actual != actual)
+            {
+                return std::numeric_limits<double>::infinity();
+            }
+
+            return static_cast<double>(Distance(expected, actual));
+        }
+
+        bool Fails(T expected, T actual) const
+        {
+            return Distance(expected, actual) > ulps || expected != expected || actual != actual;
+        }
+
+        bits ulps;
+    };
+
+    template<typename T, typename TKernel>
+    void Scan(const T *expected, const T *actual, size_t count, const TKernel &kernel, size_t offset, size_t &failures, size_t &worst, double &worstError)
+    {
+        for (size_t block = 0; block < count; block += NearBlockLength)
+        {
+            const size_t length = std::min(NearBlockLength, count - block);
+
+            if (kernel.Count(expected + block, actual + block, length) == 0)
+            {
+                continue;
+            }
+
+            for (size_t i = block; i != block + length; ++i)
+            {
+                if (kernel.Fails(expected[i], actual[i]))
+                {
+                    const double error = kernel.Error(expected[i], actual[i]);
+
+                    if (failures++ == 0 || error > worstError)
+                    {
+                        worst = offset + i;
+                        worstError = error;
+                    }
+                }
+            }
+        }
+    }
+}
 
 namespace xUnitpp
 {
@@ -131,9 +507,12 @@ xUnitFailure Assert::Equal(const std::string &expected, const std::string &actua
 {
     if (expected != actual)
     {
+        auto position = FirstMismatch(expected, actual);
+
         return OnFailure(std::move(xUnitAssert(callPrefix + "Equal", std::move(lineInfo))
-            .Expected(std::string(expected))    // can't assume expected or actual are allowed to be moved
-            .Actual(std::string(actual))));
+            .CustomMessage(StringDiffMessage(expected, actual))
+            .Expected(StringWindow(expected, position))
+            .Actual(StringWindow(actual, position))));
     }
 
     return OnSuccess();
@@ -152,6 +531,236 @@ xUnitFailure Assert::Equal(double expected, double actual, int precision, LineIn
     return Equal(er, ar, [](double er, double ar) { return er == ar; }, std::move(lineInfo));
 }
 
+Assert::NearResult::NearResult()
+    : failures(0)
+    , worst(0)
+    , worstError(0.0)
+{
+}
+
+std::string Assert::NearToString(float value)
+{
+    return FormatNumber(value, std::numeric_limits<float>::max_digits10);
+}
+
+std::string Assert::NearToString(double value)
+{
+    return FormatNumber(value, std::numeric_limits<double>::max_digits10);
+}
+
+std::string Assert::NearTolerance::ToString() const
+{
+    return "absolute " + FormatNumber(absolute, 6) + ", relative " + FormatNumber(relative, 6);
+}
+
+std::string Assert::UlpTolerance::ToString() const
+{
+    return xUnitpp::ToString(ulps) + " ulps";
+}
+
+Assert::NearTolerance Assert::CheckTolerance(double absolute, double relative)
+{
+    if (!(absolute >= 0) || !(relative >= 0))
+    {
+        throw std::invalid_argument("Assert.Near argument error: tolerances (" + FormatNumber(absolute, 6) + ", " + FormatNumber(relative, 6) + ") must not be negative.");
+    }
+
+    NearTolerance tolerance = { absolute, relative };
+    return tolerance;
+}
+
+void Assert::NearScan(const float *expected, const float *actual, size_t count, const NearTolerance &tolerance, size_t offset, NearResult &result)
+{
+    Scan(expected, actual, count, NearKernel<float>(tolerance.absolute, tolerance.relative), offset, result.failures, result.worst, result.worstError);
+}
+
+void Assert::NearScan(const double *expected, const double *actual, size_t count, const NearTolerance &tolerance, size_t offset, NearResult &result)
+{
+    Scan(expected, actual, count, NearKernel<double>(tolerance.absolute, tolerance.relative), offset, result.failures, result.worst, result.worstError);
+}
+
+void Assert::NearScan(const float *expected, const float *actual, size_t count, const UlpTolerance &tolerance, size_t offset, NearResult &result)
+{
+    Scan(expected, actual, count, UlpKernel<float>(tolerance.ulps), offset, result.failures, result.worst, result.worstError);
+}
+
+void Assert::NearScan(const double *expected, const double *actual, size_t count, const UlpTolerance &tolerance, size_t offset, NearResult &result)
+{
+    Scan(expected, actual, count, UlpKernel<double>(tolerance.ulps), offset, result.failures, result.worst, result.worstError);
+}
+
+xUnitFailure Assert::NearFailure(const std::string &call, size_t count, const NearResult &result, std::string &&tolerance, std::string &&expected, std::string &&actual, LineInfo &&lineInfo) const
+{
+    std::string message = count == 1 ?
+        "Value out of tolerance" :
+        ToString(result.failures) + " of " + ToString(count) + " elements out of tolerance. Largest error at index " + ToString(result.worst);
+
+    return OnFailure(std::move(xUnitAssert(callPrefix + call, std::move(lineInfo))
+        .CustomMessage(message + ": " + FormatNumber(result.worstError, 10) + " (tolerance: " + tolerance + ").")
+        .Expected(std::move(expected))
+        .Actual(std::move(actual))));
+}
+
+Assert::EquivalenceResult::EquivalenceResult()
+    : missing(0)
+    , unexpected(0)
+{
+}
+
+xUnitFailure Assert::EquivalentFailure(const EquivalenceResult &result, LineInfo &&lineInfo) const
+{
+    auto list = [](const std::vector<std::string> &values, size_t count)
+        {
+            std::string result = "[ ";
+
+            for (const auto &value : values)
+            {
+                result += value + ", ";
+            }
+
+            if (count > values.size())
+            {
+                result += "... ";
+            }
+            else
+            {
+                result.resize(result.size() - 2);
+                result += " ";
+            }
+
+            return result + "]";
+        };
+
+    std::string message = "Sequences are not equivalent.";
+
+    if (result.missing != 0)
+    {
+        message += " " + ToString(result.missing) + " missing: " + list(result.missingValues, result.missing) + ".";
+    }
+
+    if (result.unexpected != 0)
+    {
+        message += " " + ToString(result.unexpected) + " unexpected: " + list(result.unexpectedValues, result.unexpected) + ".";
+    }
+
+    return OnFailure(std::move(xUnitAssert(callPrefix + "Equivalent", std::move(lineInfo))
+        .CustomMessage(std::move(message))));
+}
+
+Assert::AllResult::AllResult()
+    : failures(0)
+{
+}
+
+void Assert::ParallelScan(size_t count, size_t threads, const std::function<void (size_t, size_t, AllResult &)> &scan, AllResult &result)
+{
+    if (threads == 0)
+    {
+        threads = std::max(1U, std::thread::hardware_concurrency());
+    }
+
+    const size_t chunks = std::max<size_t>(1, std::min(threads, count / MinParallelChunk));
+
+    if (chunks == 1)
+    {
+        scan(0, count, result);
+        return;
+    }
+
+    std::vector<AllResult> chunkResults(chunks);
+    std::vector<std::future<void>> futures;
+
+    for (size_t chunk = 0; chunk != chunks; ++chunk)
+    {
+        const size_t from = count * chunk / chunks;
+        const size_t to = count * (chunk + 1) / chunks;
+
+        futures.push_back(std::async(std::launch::async, [&, from, to, chunk]() { scan(from, to, chunkResults[chunk]); }));
+    }
+
+    for (auto &future : futures)
+    {
+        future.get();
+    }
+
+    // chunks cover increasing indices, so the first failures overall are the first ones found by the earliest chunks
+    for (const auto &chunkResult : chunkResults)
+    {
+        result.failures += chunkResult.failures;
+
+        for (const auto &failure : chunkResult.first)
+        {
+            if (result.first.size() < MaxAllValues)
+            {
+                result.first.push_back(failure);
+            }
+        }
+    }
+}
+
+xUnitFailure Assert::AllFailure(size_t count, const AllResult &result, LineInfo &&lineInfo) const
+{
+    std::string message = ToString(result.failures) + " of " + ToString(count) + " elements do not match.";
+
+    for (size_t i = 0; i != result.first.size(); ++i)
+    {
+        message += (i == 0 ? " First at: [" : ", [") + ToString(result.first[i].first) + "] " + result.first[i].second;
+    }
+
+    if (result.failures > result.first.size())
+    {
+        message += ", ...";
+    }
+
+    return OnFailure(std::move(xUnitAssert(callPrefix + "All", std::move(lineInfo))
+        .CustomMessage(std::move(message))));
+}
+
+xUnitFailure Assert::Near(double expected, double actual, double absoluteTolerance, double relativeTolerance, LineInfo &&lineInfo) const
+{
+    auto tolerance = CheckTolerance(absoluteTolerance, relativeTolerance);
+
+    NearResult result;
+    NearScan(&expected, &actual, 1, tolerance, 0, result);
+
+    if (result.failures != 0)
+    {
+        return NearFailure("Near", 1, result, tolerance.ToString(), NearToString(expected), NearToString(actual), std::move(lineInfo));
+    }
+
+    return OnSuccess();
+}
+
+xUnitFailure Assert::NearUlps(float expected, float actual, size_t maxUlps, LineInfo &&lineInfo) const
+{
+    UlpTolerance tolerance = { maxUlps };
+
+    NearResult result;
+    NearScan(&expected, &actual, 1, tolerance, 0, result);
+
+    if (result.failures != 0)
+    {
+        return NearFailure("NearUlps", 1, result, tolerance.ToString(), NearToString(expected), NearToString(actual), std::move(lineInfo));
+    }
+
+    return OnSuccess();
+}
+
+xUnitFailure Assert::NearUlps(double expected, double actual, size_t maxUlps, LineInfo &&lineInfo) const
+{
+    UlpTolerance tolerance = { maxUlps };
+
+    NearResult result;
+    NearScan(&expected, &actual, 1, tolerance, 0, result);
+
+    if (result.failures != 0)
+    {
+        return NearFailure("NearUlps", 1, result, tolerance.ToString(), NearToString(expected), NearToString(actual), std::move(lineInfo));
+    }
+
+    return OnSuccess();
+}
+
 xUnitFailure Assert::NotEqual(const std::string &expected, const std::string &actual, LineInfo &&lineInfo) const
 {
     if (expected == actual)
@@ -191,7 +800,7 @@ xUnitFailure Assert::True(bool b, LineInfo &&lineInfo) const
 
 xUnitFailure Assert::DoesNotContain(const std::string &actualString, const std::string &value, LineInfo &&lineInfo) const
 {
-    auto found = actualString.find(value);
+    auto found = FindSubstring(actualString, value);
     if (found != std::string::npos)
     {
         return OnFailure(std::move(xUnitAssert(callPrefix + "DoesNotContain", std::move(lineInfo))
@@ -203,7 +812,7 @@ xUnitFailure Assert::DoesNotContain(const std::string &actualString, const std::
 
 xUnitFailure Assert::Contains(const std::string &actualString, const std::string &value, LineInfo &&lineInfo) const
 {
-    if (actualString.find(value) == std::string::npos)
+    if (FindSubstring(actualString, value) == std::string::npos)
     {
         return OnFailure(std::move(xUnitAssert(callPrefix + "Contains", std::move(lineInfo))
             .Expected(std::string(value))    // can't assume actualString or value can be moved
@@ -1,7 +1,9 @@
 #include "xUnitTest.h"
 #include "EventLevel.h"
 #include "TestEventRecorder.h"
+#include "TestRecord.h"
 #include "xUnitAssert.h"
+#include "xUnitTheory.h"
 
 namespace xUnitpp
 {
@@ -11,11 +13,51 @@ xUnitTest::xUnitTest(std::function<void()> &&test, std::string &&name, int testI
                      std::string &&filename, int line, const std::vector<std::shared_ptr<TestEventRecorder>> &testEventRecorders)
     : test(std::move(test))
     , testDetails(std::move(name), testInstance, std::move(params), suite, std::move(attributes), timeLimit, std::move(filename), line)
-    , testEventRecorders(testEventRecorders)
+    , testEventRecorders(std::make_shared<const std::vector<std::shared_ptr<TestEventRecorder>>>(testEventRecorders))
     , failureEventLogged(false)
 {
 }
 
+xUnitTest::xUnitTest(std::shared_ptr<const TheorySource> &&theory, std::string &&name, const std::string &suite,
+                     AttributeCollection &&attributes, Time::Duration timeLimit,
+                     std::string &&filename, int line, const std::vector<std::shared_ptr<TestEventRecorder>> &testEventRecorders)
+    : testDetails(std::move(name), 0, "", suite, std::move(attributes), timeLimit, std::move(filename), line)
+    , testEventRecorders(std::make_shared<const std::vector<std::shared_ptr<TestEventRecorder>>>(testEventRecorders))
+    , failureEventLogged(false)
+{
+    testDetails.Theory = std::move(theory);
+}
+
+xUnitTest::xUnitTest(int id, unsigned long long stableId, const TestRecord &record, AttributeCollection &&attributes,
+                     const std::vector<std::shared_ptr<TestEventRecorder>> &testEventRecorders)
+    : testDetails(id, stableId, std::string(record.name), record.suite(), std::move(attributes),
+        Time::ToDuration(Time::ToMilliseconds(record.milliseconds)), std::string(record.file), record.line)
+    , testEventRecorders(std::make_shared<const std::vector<std::shared_ptr<TestEventRecorder>>>(testEventRecorders))
+    , failureEventLogged(false)
+{
+    if (record.theory != nullptr)
+    {
+        testDetails.Theory = record.theory(record);
+    }
+    else
+    {
+        test = record.fact;
+    }
+}
+
+xUnitTest::xUnitTest(const xUnitTest &theory, std::shared_ptr<const TheoryRow> &&row)
+    : test([=]() { row->Run(); })
+    , testDetails(theory.testDetails, row->Instance(), [=]() { return row->Params(); })
+    , testEventRecorders(theory.testEventRecorders)
+    , failureEventLogged(false)
+{
+}
+
+std::shared_ptr<xUnitTest> xUnitTest::Instance(std::shared_ptr<const TheoryRow> &&row) const
+{
+    return std::make_shared<xUnitTest>(*this, std::move(row));
+}
+
 const TestDetails &xUnitTest::TestDetails() const
 {
     return testDetails;
@@ -23,7 +65,7 @@ const TestDetails &xUnitTest::TestDetails() const
 
 TestResult xUnitTest::Run()
 {
-    for (auto &recorder : testEventRecorders)
+    for (auto &recorder : *testEventRecorders)
     {
         recorder->Tie([&](TestEvent &&evt) { AddEvent(std::move(evt)); });
     }
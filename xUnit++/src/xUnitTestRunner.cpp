@@ -1,18 +1,24 @@
 #include "xUnitTestRunner.h"
+#include <algorithm>
 #include <atomic>
 #include <chrono>
 #include <future>
 #include <limits>
+#include <memory>
 #include <mutex>
 #include <random>
 #include <stdexcept>
+#include <string>
+#include <thread>
 #include <vector>
 #include "EventLevel.h"
 #include "ExportApi.h"
 #include "IOutput.h"
+#include "RunOptions.h"
 #include "TestCollection.h"
 #include "TestDetails.h"
 #include "xUnitAssert.h"
+#include "xUnitTheory.h"
 #include "xUnitTime.h"
 
 namespace
@@ -50,6 +56,15 @@ public:
         mOutput.get().ReportFinish(details, time.count());
     }
 
+    // a test that failed without running, reported in one go so no other test's reports come between
+    void ReportFailure(const xUnitpp::TestDetails &details, const xUnitpp::TestEvent &evt)
+    {
+        std::lock_guard<std::mutex> guard(mLock);
+        mOutput.get().ReportStart(details);
+        mOutput.get().ReportEvent(details, evt);
+        mOutput.get().ReportFinish(details, 0);
+    }
+
     void ReportAllTestsComplete(size_t total, size_t skipped, size_t failed, xUnitpp::Time::Duration totalTime)
     {
         mOutput.get().ReportAllTestsComplete(total, skipped, failed, totalTime.count());
@@ -140,6 +155,21 @@ namespace xUnitpp
 {
 
 int RunTests(IOutput &output, TestFilterCallback filter, const std::vector<std::shared_ptr<xUnitTest>> &tests, Time::Duration maxTestRunTime, size_t maxConcurrent)
+{
+    std::vector<std::shared_ptr<xUnitTest>> activeTests;
+    std::copy_if(tests.begin(), tests.end(), std::back_inserter(activeTests), [&filter](const std::shared_ptr<xUnitTest> &test) { return filter(test->TestDetails()); });
+
+    return RunTests(output, activeTests, maxTestRunTime, maxConcurrent, 0, EventLevel::Debug);
+}
+
+int RunTests(IOutput &output, const std::vector<std::shared_ptr<xUnitTest>> &tests, const RunOptions &options)
+{
+    return RunTests(output, tests, Time::ToDuration(Time::ToMilliseconds(options.timeLimit)), options.threadLimit,
+        options.seed, (EventLevel)options.eventLevel);
+}
+
+int RunTests(IOutput &output, const std::vector<std::shared_ptr<xUnitTest>> &tests, Time::Duration maxTestRunTime, size_t maxConcurrent,
+             uint64_t seed, EventLevel minimumLevel)
 {
     auto timeStart = Time::Clock::now();
 
@@ -167,6 +197,7 @@ int RunTests(IOutput &output, TestFilterCallback filter, const std::vector<std::
 
         void operator--()
         {
+            std::lock_guard<std::mutex> lock(mtx);
             --activeThreads;
             condition.notify_one();
         }
@@ -183,118 +214,225 @@ int RunTests(IOutput &output, TestFilterCallback filter, const std::vector<std::
 
     SharedOutput sharedOutput(output);
 
-    std::vector<std::shared_ptr<xUnitTest>> activeTests;
-    std::copy_if(tests.begin(), tests.end(), std::back_inserter(activeTests), [&filter](const std::shared_ptr<xUnitTest> &test) { return filter(test->TestDetails()); });
+    std::vector<std::shared_ptr<xUnitTest>> activeTests(tests);
 
-    std::random_shuffle(activeTests.begin(), activeTests.end());
+    // a seed reproduces the order of an earlier run
+    std::mt19937_64 random(seed != 0 ? seed : std::random_device()());
+    std::shuffle(activeTests.begin(), activeTests.end(), random);
 
-    std::vector<std::future<void>> futures;
-    for (auto &test : activeTests)
+    struct CounterGuard
     {
-        if (test->TestDetails().Attributes.Skipped().first)
+        CounterGuard(ThreadCounter &tc)
+            : tc(tc)
         {
-            skippedTests++;
-            sharedOutput.ReportSkip(test->TestDetails(), test->TestDetails().Attributes.Skipped().second);
-            continue;
+            ++tc;
         }
 
-        futures.push_back(std::async([&]()
-            {
-                struct CounterGuard
+        ~CounterGuard()
+        {
+            --tc;
+        }
+
+    private:
+        CounterGuard &operator =(const CounterGuard &) { throw std::logic_error("not supported"); }
+        ThreadCounter &tc;
+    };
+
+    std::atomic<int> testsRun(0);
+
+    // runs a fact, or a single row of a theory, on the calling thread
+    auto runTest = [&](std::shared_ptr<xUnitTest> test)
+        {
+            CounterGuard counterGuard(threadCounter);
+            ++testsRun;
+
+            //
+            // We are deliberately not capturing any values by reference, since the thread running this lambda may be detached
+            // and abandoned by a timed test. If that were to happen, variables on the stack would get destroyed out from underneath us.
+            // Instead, we're going to make copies that are guaranteed to outlive our method, and return the test status.
+            // If the running thread is still valid, it can manage updating the count of failed threads if necessary.
+            auto actualTest = [](std::shared_ptr<xUnitTest> runningTest, std::shared_ptr<AttachedOutput> output, EventLevel minimumLevel) -> TestResult
                 {
-                    CounterGuard(ThreadCounter &tc)
-                        : tc(tc)
-                    {
-                        ++tc;
-                    }
+                    output->ReportStart(runningTest->TestDetails());
+
+                    auto result = runningTest->Run();
 
-                    ~CounterGuard()
+                    for (auto &event : runningTest->TestEvents())
                     {
-                        --tc;
+                        if (event.GetLevel() >= minimumLevel)
+                        {
+                            output->ReportEvent(runningTest->TestDetails(), event);
+                        }
                     }
 
-                private:
-                    CounterGuard &operator =(const CounterGuard &) { throw std::logic_error("not supported"); }
-                    ThreadCounter &tc;
-                } counterGuard(threadCounter);
+                    return result;
+                };
 
+            auto testTimeLimit = test->TestDetails().TimeLimit;
+            if (testTimeLimit < Time::Duration::zero())
+            {
+                testTimeLimit = maxTestRunTime;
+            }
+
+            if (testTimeLimit > Time::Duration::zero())
+            {
                 //
-                // We are deliberately not capturing any values by reference, since the thread running this lambda may be detached
-                // and abandoned by a timed test. If that were to happen, variables on the stack would get destroyed out from underneath us.
-                // Instead, we're going to make copies that are guaranteed to outlive our method, and return the test status.
-                // If the running thread is still valid, it can manage updating the count of failed threads if necessary.
-                auto actualTest = [](std::shared_ptr<xUnitTest> runningTest, std::shared_ptr<AttachedOutput> output) -> TestResult
-                    {
-                        output->ReportStart(runningTest->TestDetails());
+                // note that forcing a test to run in under a certain amount of time is inherently fragile
+                // there's no guarantee that a thread, once started, actually gets `maxTestRunTime` nanoseconds of CPU
 
-                        auto result = runningTest->Run();
+                auto m = std::make_shared<std::mutex>();
+                std::unique_lock<std::mutex> gate(*m);
 
-                        for (auto &event : runningTest->TestEvents())
-                        {
-                            output->ReportEvent(runningTest->TestDetails(), event);
-                        }
+                auto attachedOutput = std::make_shared<AttachedOutput>(sharedOutput);
+                auto threadStarted = std::make_shared<std::condition_variable>();
+                auto testResult = std::make_shared<TestResult>();
+                std::thread timedRunner([=]()
+                    {
+                        m->lock();
+                        m->unlock();
+
+                        *testResult = actualTest(test, attachedOutput, minimumLevel);
 
-                        return result;
-                    };
+                        threadStarted->notify_all();
+                    });
+                timedRunner.detach();
 
-                auto testTimeLimit = test->TestDetails().TimeLimit;
-                if (testTimeLimit < Time::Duration::zero())
+                if (threadStarted->wait_for(gate, std::chrono::duration_cast<std::chrono::nanoseconds>(testTimeLimit)) == std::cv_status::timeout)
                 {
-                    testTimeLimit = maxTestRunTime;
+                    attachedOutput->Detach();
+                    sharedOutput.ReportEvent(test->TestDetails(), TestEvent(EventLevel::Fatal, "Test failed to complete within " + ToString(Time::ToMilliseconds(testTimeLimit).count()) + " milliseconds."));
+                    sharedOutput.ReportFinish(test->TestDetails(), testTimeLimit);
+                    ++failedTests;
+                }
+                else
+                {
+                    sharedOutput.ReportFinish(test->TestDetails(), test->Duration());
+
+                    if (*testResult == TestResult::Failure)
+                    {
+                        ++failedTests;
+                    }
                 }
+            }
+            else
+            {
+                auto result = actualTest(test, std::make_shared<AttachedOutput>(sharedOutput), minimumLevel);
 
-                if (testTimeLimit > Time::Duration::zero())
+                sharedOutput.ReportFinish(test->TestDetails(), test->Duration());
+
+                if (result == TestResult::Failure)
                 {
-                    //
-                    // note that forcing a test to run in under a certain amount of time is inherently fragile
-                    // there's no guarantee that a thread, once started, actually gets `maxTestRunTime` nanoseconds of CPU
+                    ++failedTests;
+                }
+            }
+        };
 
-                    auto m = std::make_shared<std::mutex>();
-                    std::unique_lock<std::mutex> gate(*m);
+    // Chunks of theory rows being handed to workers. Keeping the number waiting small bounds
+    // how much of a theory's data exists at once, while still giving every worker something to do.
+    ThreadCounter chunkCounter(std::max(2U, std::thread::hardware_concurrency()) * 2);
 
-                    auto attachedOutput = std::make_shared<AttachedOutput>(sharedOutput);
-                    auto threadStarted = std::make_shared<std::condition_variable>();
-                    auto testResult = std::make_shared<TestResult>();
-                    std::thread timedRunner([=]()
-                        {
-                            m->lock();
-                            m->unlock();
+    // A theory being run: its chunks, and why its data couldn't be generated, if it couldn't.
+    // Any number of its chunks can fail at once, but the theory is only reported failed once,
+    // by the thread driving the run, after every chunk is done.
+    struct TheoryRun
+    {
+        TheoryRun(const std::shared_ptr<xUnitTest> &theory)
+            : theory(theory)
+        {
+        }
 
-                            *testResult = actualTest(test, attachedOutput);
+        void Failed(const std::string &reason)
+        {
+            std::lock_guard<std::mutex> guard(lock);
 
-                            threadStarted->notify_all();
-                        });
-                    timedRunner.detach();
+            if (failure.empty())
+            {
+                failure = reason;
+            }
+        }
+
+        std::shared_ptr<xUnitTest> theory;
+        std::vector<std::future<void>> chunks;
+        std::mutex lock;
+        std::string failure;
+    };
+
+    // generates the rows of a theory, a chunk at a time, as workers become free to run them
+    auto runTheory = [&](TheoryRun &run)
+        {
+            auto theory = run.theory;
+            auto &futures = run.chunks;
 
-                    if (threadStarted->wait_for(gate, std::chrono::duration_cast<std::chrono::nanoseconds>(testTimeLimit)) == std::cv_status::timeout)
+            // the chunks outlive this call, but not the run
+            auto state = &run;
+
+            try
+            {
+                auto rows = theory->TestDetails().Theory->Open();
+
+                for (;;)
+                {
+                    auto slot = std::make_shared<CounterGuard>(chunkCounter);
+
+                    TheoryChunk chunk;
+                    if (!rows->NextChunk(chunk))
                     {
-                        attachedOutput->Detach();
-                        sharedOutput.ReportEvent(test->TestDetails(), TestEvent(EventLevel::Fatal, "Test failed to complete within " + ToString(Time::ToMilliseconds(testTimeLimit).count()) + " milliseconds."));
-                        sharedOutput.ReportFinish(test->TestDetails(), testTimeLimit);
-                        ++failedTests;
+                        break;
                     }
-                    else
-                    {
-                        sharedOutput.ReportFinish(test->TestDetails(), test->Duration());
 
-                        if (*testResult == TestResult::Failure)
+                    futures.push_back(std::async(std::launch::async, [&, theory, state, slot, chunk]() mutable
                         {
-                            ++failedTests;
-                        }
-                    }
+                            try
+                            {
+                                chunk([&](std::shared_ptr<const TheoryRow> &&row)
+                                    {
+                                        runTest(theory->Instance(std::move(row)));
+                                    });
+                            }
+                            catch (const std::exception &e)
+                            {
+                                state->Failed(e.what());
+                            }
+                            catch (...)
+                            {
+                                state->Failed("unknown exception.");
+                            }
+
+                            // the future keeps this lambda alive until the run is over, so give the slot back now
+                            slot.reset();
+                        }));
                 }
-                else
-                {
-                    auto result = actualTest(test, std::make_shared<AttachedOutput>(sharedOutput));
+            }
+            catch (const std::exception &e)
+            {
+                run.Failed(e.what());
+            }
+            catch (...)
+            {
+                run.Failed("unknown exception.");
+            }
+        };
 
-                    sharedOutput.ReportFinish(test->TestDetails(), test->Duration());
+    std::vector<std::future<void>> futures;
+    std::vector<std::unique_ptr<TheoryRun>> theories;
+    for (auto &test : activeTests)
+    {
+        if (test->TestDetails().Attributes.Skipped().first)
+        {
+            skippedTests++;
+            sharedOutput.ReportSkip(test->TestDetails(), test->TestDetails().Attributes.Skipped().second);
+            continue;
+        }
 
-                    if (result == TestResult::Failure)
-                    {
-                        ++failedTests;
-                    }
-                }
-            }));
+        if (test->TestDetails().Theory)
+        {
+            theories.emplace_back(new TheoryRun(test));
+            runTheory(*theories.back());
+        }
+        else
+        {
+            futures.push_back(std::async([&, test]() { runTest(test); }));
+        }
     }
 
     for (auto &test : futures)
@@ -302,7 +440,23 @@ int RunTests(IOutput &output, TestFilterCallback filter, const std::vector<std::
         test.get();
     }
 
-    sharedOutput.ReportAllTestsComplete((int)futures.size(), skippedTests, failedTests, Time::ToDuration(Time::Clock::now() - timeStart));
+    // a theory whose data could not be generated is reported as a single failed test
+    for (auto &run : theories)
+    {
+        for (auto &chunk : run->chunks)
+        {
+            chunk.get();
+        }
+
+        if (!run->failure.empty())
+        {
+            ++testsRun;
+            ++failedTests;
+            sharedOutput.ReportFailure(run->theory->TestDetails(), TestEvent(EventLevel::Fatal, "Unable to generate theory data: " + run->failure));
+        }
+    }
+
+    sharedOutput.ReportAllTestsComplete(testsRun, skippedTests, failedTests, Time::ToDuration(Time::Clock::now() - timeStart));
 
     return failedTests;
 }
@@ -0,0 +1,230 @@
+#include "xUnitTheoryFile.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace
+{
+    const char *SkipCarriageReturn(const char *begin, const char *recordEnd)
+    {
+        return (recordEnd != begin && recordEnd[-1] == '\r') ? recordEnd - 1 : recordEnd;
+    }
+
+    // the end of the CSV field starting at `begin`, respecting quotes
+    const char *FieldEnd(const char *begin, const char *end, char separator)
+    {
+        bool quoted = false;
+
+        for (auto it = begin; it != end; ++it)
+        {
+            if (*it == '"')
+            {
+                quoted = !quoted;
+            }
+            else if (*it == separator && !quoted)
+            {
+                return it;
+            }
+        }
+
+        return end;
+    }
+}
+
+namespace xUnitpp
+{
+
+TextView::TextView()
+    : first(nullptr)
+    , length(0)
+{
+}
+
+TextView::TextView(const char *data, size_t size)
+    : first(data)
+    , length(size)
+{
+}
+
+const char *TextView::data() const
+{
+    return first;
+}
+
+size_t TextView::size() const
+{
+    return length;
+}
+
+bool TextView::empty() const
+{
+    return length == 0;
+}
+
+const char *TextView::begin() const
+{
+    return first;
+}
+
+const char *TextView::end() const
+{
+    return first + length;
+}
+
+char TextView::operator [](size_t index) const
+{
+    return first[index];
+}
+
+std::string TextView::str() const
+{
+    return std::string(first, length);
+}
+
+std::string to_string(const TextView &view)
+{
+    return view.str();
+}
+
+bool operator ==(const TextView &lhs, const TextView &rhs)
+{
+    return lhs.length == rhs.length && std::equal(lhs.begin(), lhs.end(), rhs.begin());
+}
+
+bool operator ==(const TextView &lhs, const std::string &rhs)
+{
+    return lhs.length == rhs.size() && std::equal(lhs.begin(), lhs.end(), rhs.begin());
+}
+
+bool operator ==(const std::string &lhs, const TextView &rhs)
+{
+    return rhs == lhs;
+}
+
+bool operator !=(const TextView &lhs, const TextView &rhs)
+{
+    return !(lhs == rhs);
+}
+
+bool operator !=(const TextView &lhs, const std::string &rhs)
+{
+    return !(lhs == rhs);
+}
+
+bool operator !=(const std::string &lhs, const TextView &rhs)
+{
+    return !(lhs == rhs);
+}
+
+CsvRecord::CsvRecord(TextView line, char separator)
+    : line(line)
+    , separator(separator)
+{
+}
+
+size_t CsvRecord::Count() const
+{
+    size_t count = 1;
+
+    for (auto it = FieldEnd(line.begin(), line.end(), separator); it != line.end(); it = FieldEnd(it + 1, line.end(), separator))
+    {
+        ++count;
+    }
+
+    return count;
+}
+
+TextView CsvRecord::Field(size_t index) const
+{
+    auto begin = line.begin();
+    auto end = FieldEnd(begin, line.end(), separator);
+
+    for (size_t field = 0; field != index; ++field)
+    {
+        if (end == line.end())
+        {
+            throw std::out_of_range("CSV record has no field " + std::to_string(index) + ": " + line.str());
+        }
+
+        begin = end + 1;
+        end = FieldEnd(begin, line.end(), separator);
+    }
+
+    if (end - begin >= 2 && *begin == '"' && end[-1] == '"')
+    {
+        ++begin;
+        --end;
+    }
+
+    return TextView(begin, end - begin);
+}
+
+std::string CsvRecord::Text(size_t index) const
+{
+    auto field = Field(index);
+
+    std::string result;
+    result.reserve(field.size());
+
+    for (auto it = field.begin(); it != field.end(); ++it)
+    {
+        result += *it;
+
+        if (*it == '"' && it + 1 != field.end() && it[1] == '"')
+        {
+            ++it;
+        }
+    }
+
+    return result;
+}
+
+TextView CsvRecord::Line() const
+{
+    return line;
+}
+
+std::string to_string(const CsvRecord &record)
+{
+    return record.line.str();
+}
+
+namespace TheoryImpl
+{
+    const char *SplitLine(const char *begin, const char *end, const char *&recordEnd)
+    {
+        auto newline = (const char *)std::memchr(begin, '\n', end - begin);
+
+        if (newline == nullptr)
+        {
+            recordEnd = SkipCarriageReturn(begin, end);
+            return end;
+        }
+
+        recordEnd = SkipCarriageReturn(begin, newline);
+        return newline + 1;
+    }
+
+    const char *SplitCsv(const char *begin, const char *end, const char *&recordEnd)
+    {
+        bool quoted = false;
+
+        for (auto it = begin; it != end; ++it)
+        {
+            if (*it == '"')
+            {
+                quoted = !quoted;
+            }
+            else if (*it == '\n' && !quoted)
+            {
+                recordEnd = SkipCarriageReturn(begin, it);
+                return it + 1;
+            }
+        }
+
+        recordEnd = SkipCarriageReturn(begin, end);
+        return end;
+    }
+}
+
+}
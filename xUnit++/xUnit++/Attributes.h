@@ -1,6 +1,7 @@
 #ifndef ATTRIBUTES_H_
 #define ATTRIBUTES_H_
 
+#include <memory>
 #include <string>
 #include <utility>
 #include <vector>
@@ -15,6 +16,7 @@ namespace xUnitAttributes
 namespace xUnitpp
 {
 
+// Copies share their attributes, which are only copied again if one of them is changed.
 class AttributeCollection
 {
 public:
@@ -25,6 +27,9 @@ public:
     AttributeCollection();
     friend void swap(AttributeCollection &a, AttributeCollection &b);
 
+    // the one collection, of all those ever shared, with the same attributes: tests with the same attributes keep one set between them
+    static AttributeCollection Shared(AttributeCollection &&attributes);
+
     // !!!VS My kingdom for initialization lists!
     void insert(Attribute &&a);
 
@@ -41,11 +46,26 @@ public:
 
     const std::pair<bool, std::string> &Skipped() const;
 
+    // the attributes' own size, if none of them were shared
+    size_t Bytes() const;
+
+    // the same for every collection sharing these attributes
+    const void *Identity() const;
+
 private:
-    std::vector<Attribute> sortedAttributes;
+    struct Data
+    {
+        Data();
+
+        std::vector<Attribute> sortedAttributes;
+
+        // shortcut to searching
+        std::pair<bool, std::string> skipped;
+    };
+
+    Data &Mutable();
 
-    // shortcut to searching
-    std::pair<bool, std::string> skipped;
+    std::shared_ptr<Data> data;
 };
 
 }
@@ -13,12 +13,31 @@ namespace xUnitpp
 {
     struct IOutput;
     struct ITestDetails;
+    struct RunOptions;
 
     typedef std::function<void(const ITestDetails &)> EnumerateTestDetailsCallback;
     typedef void(*EnumerateTestDetails)(EnumerateTestDetailsCallback callback);
 
     typedef std::function<bool(const ITestDetails &)> TestFilterCallback;
     typedef int(*FilteredTestsRunner)(int, int, IOutput &, TestFilterCallback);
+
+    // what the tests' suite names, file names and attributes take, in bytes, as they are kept and as they would be if each test had its own
+    struct RegistryFootprint
+    {
+        size_t tests;
+        size_t unsharedBytes;
+        size_t sharedBytes;
+        size_t internedStrings;
+        size_t attributeSets;
+    };
+
+    typedef void(*GetRegistryFootprint)(RegistryFootprint &footprint);
+
+    // selects tests by id in bulk, rather than calling back for each one (see RunOptions.h)
+    typedef int(*SelectedTestsRunner)(const RunOptions &options, IOutput &);
+
+    // the library's test manifest (see TestManifest.h), which stays valid for as long as the library is loaded
+    typedef const void *(*GetTestManifest)(size_t &size);
 }
 
 #endif
@@ -32,6 +32,19 @@ public:
     virtual void __stdcall FindAttributeKey(const char *key, size_t &begin, size_t &end) const = 0;
     virtual const char * __stdcall GetFile() const = 0;
     virtual int __stdcall GetLine() const = 0;
+
+    // Methods added since the first release go below, never above, so the ones above keep their places
+    // in every library's vtable. Older libraries don't have them: runners only call GetInstanceCount on
+    // libraries exporting GetTestManifest, and GetStableId on those exporting SelectedTestsRunner.
+
+    // How many times the test will be reported: 1, or for a theory its number of rows,
+    // or -1 when it is not known until the test runs.
+    virtual int __stdcall GetInstanceCount() const = 0;
+
+    // Unlike GetId, the same from one build or run to the next, so it can key results across runs:
+    // it depends on suite and name and, for a theory row, instance and params.
+    // Tests sharing a suite and name are told apart by file and line.
+    virtual unsigned long long __stdcall GetStableId() const = 0;
 };
 
 }
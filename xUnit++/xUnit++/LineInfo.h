@@ -11,7 +11,8 @@ struct LineInfo
     LineInfo();
     LineInfo(std::string &&file, int line);
 
-    std::string file;
+    // interned: every test and event from one file shares a single copy of its name
+    const std::string &file;
     int line;
 
     friend std::string to_string(const LineInfo &lineInfo);
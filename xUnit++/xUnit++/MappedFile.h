@@ -0,0 +1,50 @@
+#ifndef MAPPEDFILE_H_
+#define MAPPEDFILE_H_
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+namespace xUnitpp
+{
+
+// A read-only view of a whole file, for as long as anything holds on to it. Files are read
+// front to back, and can still be written to by others while they are mapped.
+class MappedFile
+{
+public:
+    // throws std::runtime_error when the file can't be opened
+    static std::shared_ptr<const MappedFile> Open(const std::string &path);
+
+    // nullptr when the file can't be opened, for files which may well not be there
+    static std::shared_ptr<const MappedFile> TryOpen(const std::string &path);
+
+    // the size of a file, without opening or mapping it; false when there is no such file
+    static bool Size(const std::string &path, unsigned long long &size);
+
+    ~MappedFile();
+
+    const char *begin() const;
+    const char *end() const;
+    size_t size() const;
+
+private:
+    MappedFile(const std::string &path);
+    MappedFile(const MappedFile &) /* = delete */;
+    MappedFile &operator =(MappedFile) /* = delete */;
+
+    void Close();
+
+private:
+    const char *data;
+    size_t length;
+
+#if defined(_WIN32)
+    void *file;
+    void *mapping;
+#endif
+};
+
+}
+
+#endif
@@ -0,0 +1,69 @@
+#ifndef RUNOPTIONS_H_
+#define RUNOPTIONS_H_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace xUnitpp
+{
+
+// Which tests to run, and how, in a single struct that crosses the dll boundary.
+// New fields are only ever added to the end: a library reads no further than `size` bytes,
+// and gives any field past that its default, so older runners keep working.
+struct RunOptions
+{
+    enum Selection
+    {
+        SelectAll,          // every test
+        SelectIds,          // the ids in `ids`, which must be ascending
+        SelectBitmap        // the ids whose bit is set in `bitmap`; bit i is id `firstId` + i
+    };
+
+    enum Isolation
+    {
+        InProcess           // every test runs in the runner's process; the only mode so far
+    };
+
+    RunOptions()
+        : size(sizeof(RunOptions))
+        , timeLimit(0)
+        , threadLimit(0)
+        , selection(SelectAll)
+        , ids(nullptr)
+        , idCount(0)
+        , bitmap(nullptr)
+        , firstId(0)
+        , bitCount(0)
+        , seed(0)
+        , shardIndex(0)
+        , shardCount(0)
+        , isolation(InProcess)
+        , eventLevel(0)
+    {
+    }
+
+    uint32_t size;
+
+    int32_t timeLimit;          // milliseconds; 0 for no limit
+    int32_t threadLimit;        // 0 for no limit
+
+    int32_t selection;
+    const int32_t *ids;
+    size_t idCount;
+    const uint64_t *bitmap;
+    int32_t firstId;
+    size_t bitCount;
+
+    uint64_t seed;              // the order tests are shuffled into; 0 for a different order every run
+
+    // when shardCount isn't 0, only the tests whose stable hash % shardCount == shardIndex are run
+    uint32_t shardIndex;
+    uint32_t shardCount;
+
+    int32_t isolation;
+    int32_t eventLevel;         // events below this EventLevel aren't reported; failures are still counted
+};
+
+}
+
+#endif
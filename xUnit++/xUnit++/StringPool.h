@@ -0,0 +1,27 @@
+#ifndef STRINGPOOL_H_
+#define STRINGPOOL_H_
+
+#include <cstddef>
+#include <string>
+
+namespace xUnitpp
+{
+
+// Text that many tests have in common, like suite and file names, kept once each for as long as the program runs.
+namespace StringPool
+{
+    // the same string for equal text, from any thread; it is never moved or destroyed
+    const std::string &Intern(const std::string &text);
+
+    struct Usage
+    {
+        size_t strings;
+        size_t bytes;
+    };
+
+    Usage Report();
+}
+
+}
+
+#endif
@@ -6,27 +6,66 @@
 #include <map>
 #include <memory>
 #include <deque>
+#include <mutex>
 #include <vector>
+#include "TestRecord.h"
+#include "TestTable.h"
 #include "xUnitTest.h"
+#include "xUnitTheory.h"
 #include "xUnitToString.h"
 
 namespace xUnitpp
 {
 
 class TestEventRecorder;
+struct RegistryFootprint;
+struct RunOptions;
 
-// !!!VS convert this to an initializer list when VS implements them
+// Rows given inline to THEORY live in a static array for as long as the program does, so rows
+// point straight into it: registering a theory copies nothing, whatever its width or length.
 template<typename TTuple>
-static std::function<std::vector<TTuple>()> TheoryData(int count, TTuple tuples[])
+class TheoryArray
 {
-    std::vector<TTuple> data;
+public:
+    TheoryArray(const TTuple *first, const TTuple *last)
+        : first(first)
+        , last(last)
+    {
+    }
+
+    // an array is its own data provider
+    const TheoryArray &operator ()() const
+    {
+        return *this;
+    }
+
+    const TTuple *begin() const
+    {
+        return first;
+    }
 
-    for (int i = 0; i != count; ++i)
+    const TTuple *end() const
     {
-        data.push_back(tuples[i]);
+        return last;
     }
 
-    return [=]() { return data; };
+private:
+    const TTuple *first;
+    const TTuple *last;
+};
+
+template<typename TTuple, size_t N>
+TheoryArray<TTuple> TheoryData(const TTuple (&tuples)[N])
+{
+    return TheoryArray<TTuple>(tuples, tuples + N);
+}
+
+namespace TheoryImpl
+{
+    template<typename TTuple>
+    struct KnownSize<TheoryArray<TTuple>> : std::true_type
+    {
+    };
 }
 
 class Check;
@@ -35,132 +74,94 @@ class TestCollection
 {
     friend class Register;
 
+    static std::deque<std::string> SplitParams(std::string &&params);
+
 public:
     class Register
     {
-        // !!!VS someday, Visual Studio will understand variadic templates
-        // when it does, fix this collection
-
-        // !!! should use a macro system to automate this
-        template<typename TFn, typename TArg0>
-        static std::function<void()> TheoryHelper(TFn &&theory, std::tuple<TArg0> &&t)
-        {
-            return [=]() { theory(std::get<0>(t)); };
-        }
+    public:
+        Register(TestCollection &collection, std::function<void()> &&fn, std::string &&name, const std::string &suite,
+            AttributeCollection &&attributes, int milliseconds, std::string &&filename, int line, std::vector<std::shared_ptr<TestEventRecorder>> &&testEventRecorders);
 
-        template<typename TFn, typename TArg0, typename TArg1>
-        static std::function<void()> TheoryHelper(TFn &&theory, std::tuple<TArg0, TArg1> &&t)
+        template<typename TTheory, typename TTheoryData>
+        Register(TestCollection &collection, TTheory &&theory, TTheoryData &&theoryData, std::string &&name, const std::string &suite, std::string &&params,
+            const AttributeCollection &attributes, int milliseconds, std::string &&filename, int line, const std::vector<std::shared_ptr<TestEventRecorder>> &testEventRecorders)
         {
-            return [=]() { theory(std::get<0>(t),
-                                  std::get<1>(t)); };
+            // the data provider is not called here: rows are generated by the runner, in chunks, when the theory is run
+            collection.mRegistered.push_back(
+                std::make_shared<xUnitTest>(
+                    TheoryImpl::MakeSource(std::forward<TTheory>(theory), std::forward<TTheoryData>(theoryData), SplitParams(std::move(params))),
+                    std::move(name),
+                    suite,
+                    AttributeCollection(attributes),
+                    Time::ToDuration(Time::ToMilliseconds(milliseconds)),
+                    std::move(filename),
+                    line,
+                    testEventRecorders)
+                );
         }
+    };
 
-        template<typename TFn, typename TArg0, typename TArg1, typename TArg2>
-        static std::function<void()> TheoryHelper(TFn &&theory, std::tuple<TArg0, TArg1, TArg2> &&t)
-        {
-            return [=]() { theory(std::get<0>(t),
-                                  std::get<1>(t),
-                                  std::get<2>(t)); };
-        }
+    // the rows of a recorded theory, for THEORY and DATA_THEORY
+    template<typename TTheory, typename TTheoryData>
+    static std::shared_ptr<const TheorySource> RecordedTheory(const TestRecord &record, TTheory &&theory, TTheoryData &&theoryData)
+    {
+        return TheoryImpl::MakeSource(std::forward<TTheory>(theory), std::forward<TTheoryData>(theoryData), SplitParams(record.params));
+    }
 
-        template<typename TFn, typename TArg0, typename TArg1, typename TArg2, typename TArg3>
-        static std::function<void()> TheoryHelper(TFn &&theory, std::tuple<TArg0, TArg1, TArg2, TArg3> &&t)
-        {
-            return [=]() { theory(std::get<0>(t),
-                                  std::get<1>(t),
-                                  std::get<2>(t),
-                                  std::get<3>(t)); };
-        }
+    // a collection of registered tests only
+    TestCollection();
 
-        template<typename TFn, typename TArg0, typename TArg1, typename TArg2, typename TArg3, typename TArg4>
-        static std::function<void()> TheoryHelper(TFn &&theory, std::tuple<TArg0, TArg1, TArg2, TArg3, TArg4> &&t)
-        {
-            return [=]() { theory(std::get<0>(t),
-                                  std::get<1>(t),
-                                  std::get<2>(t),
-                                  std::get<3>(t),
-                                  std::get<4>(t)); };
-        }
+    // a collection of tests recorded in [first, last), as well as any registered
+    TestCollection(const TestRecord *const *first, const TestRecord *const *last);
 
-        static std::deque<std::string> SplitParams(std::string &&params);
+    // the tests linked into this module
+    static TestCollection &Instance();
 
-        // !!!VS something else that can be simplified once VS understands variadic macros...
-        template<typename TArg0>
-        std::string GetTheoryParams(const std::deque<std::string> &params, std::tuple<TArg0> &&t) const
-        {
-            return "(" + params[0] + ": " + ToString(std::get<0>(std::forward<std::tuple<TArg0>>(t))) + ")";
-        }
+    // every test, building any recorded tests which haven't been yet
+    const std::vector<std::shared_ptr<xUnitTest>> &Tests();
 
-        template<typename TArg0, typename TArg1>
-        std::string GetTheoryParams(const std::deque<std::string> &params, std::tuple<TArg0, TArg1> &&t) const
-        {
-            return "(" + params[0] + ": " + ToString(std::get<0>(std::forward<std::tuple<TArg0, TArg1>>(t))) + ", " +
-                params[1] + ": " + ToString(std::get<1>(std::forward<std::tuple<TArg0, TArg1>>(t))) + ")";
-        }
+    // recorded tests, which can be listed and filtered without being built
+    const std::deque<RecordDetails> &Records();
 
-        template<typename TArg0, typename TArg1, typename TArg2>
-        std::string GetTheoryParams(const std::deque<std::string> &params, std::tuple<TArg0, TArg1, TArg2> &&t) const
-        {
-            return "(" + params[0] + ": " + ToString(std::get<0>(std::forward<std::tuple<TArg0, TArg1, TArg2>>(t))) + ", " +
-                params[1] + ": " + ToString(std::get<1>(std::forward<std::tuple<TArg0, TArg1, TArg2>>(t))) + ", " +
-                params[2] + ": " + ToString(std::get<2>(std::forward<std::tuple<TArg0, TArg1, TArg2>>(t))) + ")";
-        }
+    const std::vector<std::shared_ptr<xUnitTest>> &Registered() const;
 
-        template<typename TArg0, typename TArg1, typename TArg2, typename TArg3>
-        std::string GetTheoryParams(const std::deque<std::string> &params, std::tuple<TArg0, TArg1, TArg2, TArg3> &&t) const
-        {
-            return "(" + params[0] + ": " + ToString(std::get<0>(std::forward<std::tuple<TArg0, TArg1, TArg2, TArg3>>(t))) + ", " +
-                params[1] + ": " + ToString(std::get<1>(std::forward<std::tuple<TArg0, TArg1, TArg2, TArg3>>(t))) + ", " +
-                params[2] + ": " + ToString(std::get<2>(std::forward<std::tuple<TArg0, TArg1, TArg2, TArg3>>(t))) + ", " +
-                params[3] + ": " + ToString(std::get<3>(std::forward<std::tuple<TArg0, TArg1, TArg2, TArg3>>(t))) + ")";
-        }
+    // every test's details in one block, laid out as described in TestManifest.h; built once
+    const std::vector<char> &Manifest();
 
-        template<typename TArg0, typename TArg1, typename TArg2, typename TArg3, typename TArg4>
-        std::string GetTheoryParams(const std::deque<std::string> &params, std::tuple<TArg0, TArg1, TArg2, TArg3, TArg4> &&t) const
-        {
-            return "(" + params[0] + ": " + ToString(std::get<0>(std::forward<std::tuple<TArg0, TArg1, TArg2, TArg3, TArg4>>(t))) + ", " +
-                params[1] + ": " + ToString(std::get<1>(std::forward<std::tuple<TArg0, TArg1, TArg2, TArg3, TArg4>>(t))) + ", " +
-                params[2] + ": " + ToString(std::get<2>(std::forward<std::tuple<TArg0, TArg1, TArg2, TArg3, TArg4>>(t))) + ", " +
-                params[3] + ": " + ToString(std::get<3>(std::forward<std::tuple<TArg0, TArg1, TArg2, TArg3, TArg4>>(t))) + ", " +
-                params[4] + ": " + ToString(std::get<4>(std::forward<std::tuple<TArg0, TArg1, TArg2, TArg3, TArg4>>(t))) + ")";
-        }
+    // builds every test, to measure them
+    RegistryFootprint Footprint();
 
-    public:
-        Register(TestCollection &collection, std::function<void()> &&fn, std::string &&name, const std::string &suite,
-            AttributeCollection &&attributes, int milliseconds, std::string &&filename, int line, std::vector<std::shared_ptr<TestEventRecorder>> &&testEventRecorders);
+    // what selecting and ordering needs of every test, in rows: registered tests first, then records, as in Tests()
+    const TestTable &Table();
 
-        template<typename TTheory, typename TTheoryData>
-        Register(TestCollection &collection, TTheory &&theory, TTheoryData &&theoryData, std::string &&name, const std::string &suite, std::string &&params,
-            const AttributeCollection &attributes, int milliseconds, std::string &&filename, int line, const std::vector<std::shared_ptr<TestEventRecorder>> &testEventRecorders)
-        {
-            int id = 0;
-            for (auto t : theoryData())
-            {
-                auto fullParams = GetTheoryParams(SplitParams(std::string(params)), std::forward<decltype(t)>(t));
-
-                collection.mTests.push_back(
-                    std::make_shared<xUnitTest>(
-                        TheoryHelper(std::forward<TTheory>(theory), std::move(t)),
-                        std::string(name),
-                        id++,
-                        std::move(fullParams),
-                        suite,
-                        AttributeCollection(attributes),
-                        Time::ToDuration(Time::ToMilliseconds(milliseconds)),
-                        std::string(filename),
-                        line,
-                        testEventRecorders)
-                    );
-            }
-        }
-    };
+    // the test in a row of Table(), built if it is a record
+    std::shared_ptr<xUnitTest> Test(uint32_t row);
 
-    static TestCollection &Instance();
+    // the tests chosen by the selection and shard in `options`, built if they are records
+    std::vector<std::shared_ptr<xUnitTest>> Select(const RunOptions &options);
 
-    const std::vector<std::shared_ptr<xUnitTest>> &Tests();
+private:
+    TestCollection(const TestCollection &) /* = delete */;
+    TestCollection &operator =(TestCollection) /* = delete */;
 
 private:
+    const TestRecord *const *mFirst;
+    const TestRecord *const *mLast;
+
+    std::once_flag mRecordsFound;
+    std::deque<RecordDetails> mRecords;
+
+    std::once_flag mTestsBuilt;
     std::vector<std::shared_ptr<xUnitTest>> mTests;
+
+    std::vector<std::shared_ptr<xUnitTest>> mRegistered;
+
+    std::once_flag mTableBuilt;
+    TestTable mTable;
+
+    std::once_flag mManifestBuilt;
+    std::vector<char> mManifest;
 };
 
 }
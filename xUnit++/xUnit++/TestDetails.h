@@ -4,6 +4,8 @@
 #include <chrono>
 #include <functional>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <tuple>
 #include <vector>
@@ -15,13 +17,53 @@
 namespace xUnitpp
 {
 
+class TheorySource;
+
 struct TestDetails : public ITestDetails
 {
+private:
+    // what every instance of a test has in common: theory rows share their theory's rather than copying it
+    struct Definition
+    {
+        Definition();
+        Definition(std::string &&name, const std::string &suite, AttributeCollection &&attributes, Time::Duration timeLimit,
+            std::string &&filename, int line);
+
+        std::string Name;
+        const std::string &Suite;           // interned, like LineInfo's file
+        AttributeCollection Attributes;     // shared with every test that has the same attributes
+        Time::Duration TimeLimit;
+        xUnitpp::LineInfo LineInfo;
+    };
+
+    // a theory row's params are only formatted when a reporter asks for them
+    struct Text
+    {
+        std::once_flag formatted;
+        std::function<std::string()> format;
+        std::string Params;
+        std::string FullName;   // name + params
+        unsigned long long StableId;
+    };
+
+    void Format() const;
+
+    std::shared_ptr<const Definition> definition;
+    std::shared_ptr<Text> text;
+
+public:
     TestDetails();
     TestDetails(std::string &&name, int testInstance, std::string &&params, const std::string &suite,
         AttributeCollection &&attributes, Time::Duration timeLimit,
         std::string &&filename, int line);
 
+    // a test found before it was built, which already has its ids
+    TestDetails(int id, unsigned long long stableId, std::string &&name, const std::string &suite, AttributeCollection &&attributes, Time::Duration timeLimit,
+        std::string &&filename, int line);
+
+    // one row of a theory
+    TestDetails(const TestDetails &theory, int testInstance, std::function<std::string()> &&params);
+
     // ITestDetails implementation
     virtual int __stdcall GetId() const override;
     virtual const char * __stdcall GetName() const override;
@@ -35,16 +77,21 @@ struct TestDetails : public ITestDetails
     virtual void __stdcall FindAttributeKey(const char *key, size_t &begin, size_t &end) const override;
     virtual const char * __stdcall GetFile() const override;
     virtual int __stdcall GetLine() const override;
+    virtual int __stdcall GetInstanceCount() const override;
+    virtual unsigned long long __stdcall GetStableId() const override;
+
+    // ids for tests which will be built later
+    static int ReserveIds(int count);
 
     int Id;
+    unsigned long long StableId;    // the test's; a theory row's GetStableId adds its instance and params
     int TestInstance;
-    std::string Name;
-    std::string Params;
-    std::string FullName;   // name + params
-    std::string Suite;
-    AttributeCollection Attributes;
-    Time::Duration TimeLimit;
-    xUnitpp::LineInfo LineInfo;
+    const std::string &Name;
+    const std::string &Suite;
+    const AttributeCollection &Attributes;
+    const Time::Duration &TimeLimit;
+    const xUnitpp::LineInfo &LineInfo;
+    std::shared_ptr<const TheorySource> Theory;  // the rows still to be generated, for a theory
 };
 
 }
@@ -0,0 +1,89 @@
+#ifndef TESTMANIFEST_H_
+#define TESTMANIFEST_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+//
+// Every test in a library, in one contiguous, read-only block: a Header, then an array of Tests,
+// then an array of Attributes, then the strings they all refer to. Runners can list and filter
+// tests by reading it in place, without a callback per test, and without building any test.
+// Like ITestDetails, nothing in it is a C++ class, so it can cross dll boundaries.
+//
+
+namespace xUnitpp { namespace Manifest
+{
+
+// bumped whenever the layout below changes
+static const uint32_t Version = 2;
+
+static const char Magic[8] = { 'x', 'U', 'n', 'i', 't', '+', '+', 'M' };
+
+struct Header
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t testCount;
+    uint32_t attributeCount;
+    uint32_t stringsSize;
+};
+
+enum Flags : uint32_t
+{
+    IsTheory = 1
+};
+
+struct Test
+{
+    uint64_t hash;          // the test's stable id (see ITestDetails::GetStableId)
+    int32_t id;             // what FilteredTestsRunner's filter will see from GetId
+    int32_t line;
+    int32_t instanceCount;  // see ITestDetails::GetInstanceCount; a theory's is only known for some data sources
+    uint32_t flags;
+    uint32_t suite;         // offsets into the strings
+    uint32_t name;
+    uint32_t file;
+    uint32_t firstAttribute;
+    uint32_t attributeCount;    // sorted by key
+};
+
+struct Attribute
+{
+    uint32_t key;           // offsets into the strings
+    uint32_t value;
+};
+
+// 64 bit FNV-1a of `text`, continuing from `hash`
+inline uint64_t StableHash(uint64_t hash, const char *text)
+{
+    for (; *text != '\0'; ++text)
+    {
+        hash = (hash ^ (unsigned char)*text) * 1099511628211ULL;
+    }
+
+    // keep "a" + "bc" apart from "ab" + "c"
+    return hash * 1099511628211ULL;
+}
+
+// a test's stable id
+inline uint64_t StableHash(const char *suite, const char *name)
+{
+    return StableHash(StableHash(14695981039346656037ULL, suite), name);
+}
+
+// a theory row's stable id, from its theory's
+inline uint64_t StableHash(uint64_t theory, int instance, const char *params)
+{
+    return StableHash(StableHash(theory, std::to_string(instance).c_str()), params);
+}
+
+// the stable id of a test whose suite and name are shared with another test: where it is written keeps them apart
+inline uint64_t StableHash(uint64_t test, const char *file, int line)
+{
+    return StableHash(StableHash(test, file), std::to_string(line).c_str());
+}
+
+}}
+
+#endif
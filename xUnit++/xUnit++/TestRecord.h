@@ -0,0 +1,112 @@
+#ifndef TESTRECORD_H_
+#define TESTRECORD_H_
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+#include "Attributes.h"
+#include "ITestDetails.h"
+
+namespace xUnitpp
+{
+
+class Check;
+class Log;
+class TestEventRecorder;
+class TheorySource;
+class Warn;
+class xUnitTest;
+
+// Everything a test macro knows about its test, as constant data. Nothing here needs a constructor,
+// so loading a library of tests runs no code per test: the records are found through the linker
+// section they are placed in, and a test is only built once it has been selected to run.
+struct TestRecord
+{
+    const char *name;
+    const char *params;         // a theory's parameter list, as written; empty for a fact
+    const char *file;
+    int line;
+    int milliseconds;           // 0 for no time limit, -1 for the runner's
+    const std::string &(*suite)();
+    AttributeCollection (*attributes)();
+    void (*fact)();
+    std::shared_ptr<const TheorySource> (*theory)(const TestRecord &record);
+};
+
+// The records linked into this module, in no particular order. Null entries are padding the linker may add.
+std::pair<const TestRecord *const *, const TestRecord *const *> LinkedTestRecords();
+
+// A record behind the same interface as a built test's details, for listing and filtering.
+class RecordDetails : public ITestDetails
+{
+public:
+    RecordDetails(const TestRecord &record, int id, unsigned long long stableId);
+
+    // the test itself, built the first time it is asked for
+    std::shared_ptr<xUnitTest> Test() const;
+
+    bool IsTheory() const;
+    bool IsSkipped() const;
+
+    const TestRecord &Record() const;
+
+    // ITestDetails implementation
+    virtual int __stdcall GetId() const override;
+    virtual const char * __stdcall GetName() const override;
+    virtual const char * __stdcall GetFullName() const override;
+    virtual const char * __stdcall GetSuite() const override;
+    virtual const char * __stdcall GetParams() const override;
+    virtual int __stdcall GetTestInstance() const override;
+    virtual size_t __stdcall GetAttributeCount() const override;
+    virtual const char * __stdcall GetAttributeKey(size_t index) const override;
+    virtual const char * __stdcall GetAttributeValue(size_t index) const override;
+    virtual void __stdcall FindAttributeKey(const char *key, size_t &begin, size_t &end) const override;
+    virtual const char * __stdcall GetFile() const override;
+    virtual int __stdcall GetLine() const override;
+    virtual int __stdcall GetInstanceCount() const override;
+    virtual unsigned long long __stdcall GetStableId() const override;
+
+private:
+    RecordDetails(const RecordDetails &) /* = delete */;
+    RecordDetails &operator =(RecordDetails) /* = delete */;
+
+    const AttributeCollection &Attributes() const;
+
+private:
+    const TestRecord &record;
+    int id;
+    unsigned long long stableId;
+
+    mutable std::once_flag attributesFound;
+    mutable AttributeCollection attributes;
+
+    mutable std::once_flag built;
+    mutable std::shared_ptr<xUnitTest> test;
+};
+
+// The Check, Warn and Log used by every test the macros define. Events are sent to whichever test
+// is running on the reporting thread, so one set serves all of them.
+namespace Events
+{
+    extern const xUnitpp::Check Check;
+    extern const xUnitpp::Warn Warn;
+    extern const xUnitpp::Log Log;
+
+    const std::vector<std::shared_ptr<TestEventRecorder>> &Recorders();
+}
+
+}
+
+// !!!VS the linker sorts sections named "xUnit$..." by what follows the '$', so
+// LinkedTestRecords finds the records between the entries it places in "xUnit$a" and "xUnit$z"
+#if defined(_MSC_VER)
+# pragma section("xUnit$m", read)
+# define XU_RECORD_SECTION __declspec(allocate("xUnit$m"))
+#else
+// an explicit alignment keeps the compiler from padding entries apart
+# define XU_RECORD_SECTION __attribute__((section("xunitpp_tests"), used, aligned(sizeof(void *))))
+#endif
+
+#endif
@@ -0,0 +1,52 @@
+#ifndef TESTTABLE_H_
+#define TESTTABLE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace xUnitpp
+{
+
+struct RunOptions;
+
+// The few fields looked at for every test in a library, whether or not it ends up running, kept in
+// parallel arrays: row r of every column is the same test. Selecting, sharding and ordering tests
+// walk one or two contiguous columns, and never touch a test's details or build the test itself.
+class TestTable
+{
+public:
+    TestTable();
+
+    // returns the new test's row
+    // `suite` must be interned, so that equal suites are the same string
+    uint32_t Add(int id, unsigned long long stableId, const std::string &suite, int milliseconds, bool skipped);
+
+    size_t size() const;
+
+    // the rows chosen by the selection and shard in `options`, ascending
+    std::vector<uint32_t> Select(const RunOptions &options) const;
+
+    // orders rows by suite name, then by stable id within a suite
+    void SortBySuite(std::vector<uint32_t> &rows) const;
+
+    std::vector<int> ids;
+    std::vector<unsigned long long> stableIds;
+    std::vector<uint32_t> suites;               // index into suiteNames
+    std::vector<int32_t> timeLimits;            // milliseconds; 0 for no limit, -1 for the runner's
+    std::vector<uint8_t> skipped;
+
+    std::vector<const std::string *> suiteNames;
+
+private:
+    std::unordered_map<const std::string *, uint32_t> suiteLookup;
+
+    // ids are nearly always added in ascending order, which lets a list of ids be found without a scan
+    bool idsAscending;
+};
+
+}
+
+#endif
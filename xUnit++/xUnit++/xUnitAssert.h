@@ -11,13 +11,16 @@
 #include <algorithm>
 #include <exception>
 #include <functional>
+#include <iterator>
 #include <memory>
 #include <sstream>
 #include <stdexcept>
 #include <string>
 #include <type_traits>
+#include <unordered_map>
 #include <vector>
 #include "LineInfo.h"
+#include "xUnitDiff.h"
 #include "xUnitToString.h"
 
 namespace xUnitpp
@@ -100,19 +103,109 @@ private:
     int &refCount;
 };
 
+// Marks a range as sorted by `less`, so Contains and DoesNotContain can binary search it:
+//      Assert.Contains(xUnitpp::Sorted(values), 42);
+template<typename TSequence, typename TLess>
+struct SortedRange
+{
+    SortedRange(const TSequence &sequence, TLess less)
+        : sequence(sequence)
+        , less(less)
+    {
+    }
+
+    const TSequence &sequence;
+    TLess less;
+
+private:
+    SortedRange &operator =(SortedRange) /* = delete */;
+};
+
+struct DefaultLess
+{
+    template<typename T, typename U>
+    bool operator()(const T &t, const U &u) const
+    {
+        return t < u;
+    }
+};
+
+template<typename TSequence>
+SortedRange<TSequence, DefaultLess> Sorted(const TSequence &sequence)
+{
+    return SortedRange<TSequence, DefaultLess>(sequence, DefaultLess());
+}
+
+template<typename TSequence, typename TLess>
+SortedRange<TSequence, TLess> Sorted(const TSequence &sequence, TLess less)
+{
+    return SortedRange<TSequence, TLess>(sequence, less);
+}
+
+// Lets All split a random access range into chunks evaluated on separate threads:
+//      Assert.All(xUnitpp::Parallel(values), [](int value) { return value >= 0; });
+// The predicate must be safe to call concurrently. 0 threads means one per hardware thread.
+template<typename TSequence>
+struct ParallelRange
+{
+    ParallelRange(const TSequence &sequence, size_t threads)
+        : sequence(sequence)
+        , threads(threads)
+    {
+    }
+
+    const TSequence &sequence;
+    size_t threads;
+
+private:
+    ParallelRange &operator =(ParallelRange) /* = delete */;
+};
+
+template<typename TSequence>
+ParallelRange<TSequence> Parallel(const TSequence &sequence, size_t threads = 0)
+{
+    return ParallelRange<TSequence>(sequence, threads);
+}
+
 class Assert
 {
 protected:
     static double round(double value, size_t precision);
 
+    // long ranges are only printed around `focus`, so a failure never renders megabytes of values
     template<typename T>
-    static std::string RangeToString(T begin, T end)
+    static std::string RangeToString(T begin, T end, size_t focus = 0)
     {
-        typedef decltype(*begin) val_type;
+        const size_t first = focus > Diff::WindowBefore ? focus - Diff::WindowBefore : 0;
 
         std::string result = "[ ";
 
-        std::for_each(std::forward<T>(begin), std::forward<T>(end), [&result](val_type val) { result += ToString(std::forward<val_type>(val)) + ", "; });
+        if (first != 0)
+        {
+            result += "..., ";
+        }
+
+        size_t index = 0;
+        for (auto it = begin; it != end; ++it, ++index)
+        {
+            if (index < first)
+            {
+                continue;
+            }
+
+            if (index == first + Diff::WindowLength)
+            {
+                result += "..., ";
+                break;
+            }
+
+            result += ToString(*it) + ", ";
+        }
+
+        if (result.size() == 2)
+        {
+            return "[ ]";
+        }
 
         result[result.size() - 2] = ' ';
         result[result.size() - 1] = ']';
@@ -120,6 +213,29 @@ protected:
         return result;
     }
 
+    template<typename TExpected, typename TActual, typename TComparer>
+    static std::string SequenceDiff(TExpected expectedBegin, TExpected expectedEnd, TActual actualBegin, TActual actualEnd, TComparer &&comparer)
+    {
+        std::vector<TExpected> expected;
+        for (auto it = expectedBegin; it != expectedEnd; ++it)
+        {
+            expected.push_back(it);
+        }
+
+        std::vector<TActual> actual;
+        for (auto it = actualBegin; it != actualEnd; ++it)
+        {
+            actual.push_back(it);
+        }
+
+        auto edits = Diff::Compute(expected.size(), actual.size(),
+            [&](size_t e, size_t a) { return comparer(*expected[e], *actual[a]); });
+
+        return Diff::Render(edits,
+            [&](size_t e) { return ToString(*expected[e]); },
+            [&](size_t a) { return ToString(*actual[a]); });
+    }
+
     template<typename T>
     struct has_empty
     {
@@ -137,6 +253,428 @@ protected:
         static const bool value = (sizeof(f<T>(nullptr)) == sizeof(char));
     };
 
+    template<typename T>
+    struct has_data
+    {
+    private:
+        template<typename C>
+        static char f(decltype(std::declval<const C &>().data()) *);
+
+        template<typename C>
+        static long f(...);
+
+    public:
+        static const bool value = (sizeof(f<T>(nullptr)) == sizeof(char));
+    };
+
+    template<typename T>
+    struct range_element
+    {
+        typedef typename std::decay<decltype(*std::begin(std::declval<const T &>()))>::type type;
+    };
+
+    // associative containers are searched with their own find (or count), which takes a key rather than an element
+    template<typename TSequence, typename T>
+    struct has_find
+    {
+    private:
+        template<typename C>
+        static char f(typename std::enable_if<
+            std::is_same<decltype(std::declval<const C &>().find(std::declval<T>())), decltype(std::declval<const C &>().end())>::value>::type *);
+
+        template<typename C>
+        static long f(...);
+
+    public:
+        static const bool value = (sizeof(f<TSequence>(nullptr)) == sizeof(char));
+    };
+
+    template<typename TSequence, typename T>
+    struct has_count
+    {
+    private:
+        template<typename C>
+        static char f(typename std::enable_if<
+            std::is_convertible<decltype(std::declval<const C &>().count(std::declval<T>())), size_t>::value>::type *);
+
+        template<typename C>
+        static long f(...);
+
+    public:
+        static const bool value = (sizeof(f<TSequence>(nullptr)) == sizeof(char));
+    };
+
+    template<typename TSequence, typename T>
+    static typename std::enable_if<has_find<TSequence, T>::value, bool>::type Includes(const TSequence &sequence, T &&value)
+    {
+        return sequence.find(std::forward<T>(value)) != sequence.end();
+    }
+
+    template<typename TSequence, typename T>
+    static typename std::enable_if<!has_find<TSequence, T>::value && has_count<TSequence, T>::value, bool>::type Includes(const TSequence &sequence, T &&value)
+    {
+        return sequence.count(std::forward<T>(value)) != 0;
+    }
+
+    template<typename TSequence, typename T>
+    static typename std::enable_if<!has_find<TSequence, T>::value && !has_count<TSequence, T>::value, bool>::type Includes(const TSequence &sequence, T &&value)
+    {
+        using std::begin;
+        using std::end;
+
+        return std::find(begin(sequence), end(sequence), std::forward<T>(value)) != end(sequence);
+    }
+
+    template<typename TSequence, typename TLess, typename T>
+    static bool Includes(const SortedRange<TSequence, TLess> &sorted, T &&value)
+    {
+        using std::begin;
+        using std::end;
+
+        auto found = std::lower_bound(begin(sorted.sequence), end(sorted.sequence), value, sorted.less);
+        return found != end(sorted.sequence) && !sorted.less(value, *found);
+    }
+
+    // float and double elements stored contiguously are handed to the kernels in place
+    template<typename TExpected, typename TActual>
+    struct near_contiguous
+    {
+        typedef typename range_element<TExpected>::type element;
+
+        static const bool value =
+            (has_data<TExpected>::value || std::is_array<TExpected>::value) &&
+            (has_data<TActual>::value || std::is_array<TActual>::value) &&
+            std::is_same<element, typename range_element<TActual>::type>::value &&
+            (std::is_same<element, float>::value || std::is_same<element, double>::value);
+    };
+
+    // the type near_contiguous ranges are compared in, and others are converted to
+    template<typename TExpected, typename TActual>
+    struct near_value
+    {
+        typedef typename std::conditional<
+            std::is_same<typename range_element<TExpected>::type, float>::value && std::is_same<typename range_element<TActual>::type, float>::value,
+            float, double>::type type;
+    };
+
+    // shortest text which reads back as the same value
+    static std::string NearToString(float value);
+    static std::string NearToString(double value);
+
+    struct NearResult
+    {
+        NearResult();
+
+        size_t failures;
+        size_t worst;       // index of the element with the largest error
+        double worstError;
+    };
+
+    struct NearTolerance
+    {
+        std::string ToString() const;
+
+        double absolute;
+        double relative;
+    };
+
+    struct UlpTolerance
+    {
+        std::string ToString() const;
+
+        size_t ulps;
+    };
+
+    static NearTolerance CheckTolerance(double absolute, double relative);
+
+    // Element-wise kernels. Indices recorded in `result` are relative to `offset`.
+    static void NearScan(const float *expected, const float *actual, size_t count, const NearTolerance &tolerance, size_t offset, NearResult &result);
+    static void NearScan(const double *expected, const double *actual, size_t count, const NearTolerance &tolerance, size_t offset, NearResult &result);
+    static void NearScan(const float *expected, const float *actual, size_t count, const UlpTolerance &tolerance, size_t offset, NearResult &result);
+    static void NearScan(const double *expected, const double *actual, size_t count, const UlpTolerance &tolerance, size_t offset, NearResult &result);
+
+    template<typename T, size_t N>
+    static const T *RangeData(const T (&range)[N])
+    {
+        return range;
+    }
+
+    template<typename T>
+    static auto RangeData(const T &range) -> decltype(range.data())
+    {
+        return range.data();
+    }
+
+    template<typename TExpected, typename TActual, typename TTolerance>
+    static void NearScan(const TExpected &expected, const TActual &actual, size_t count, const TTolerance &tolerance, NearResult &result, std::true_type)
+    {
+        NearScan(RangeData(expected), RangeData(actual), count, tolerance, 0, result);
+    }
+
+    // anything else is converted a block at a time, so the same kernels apply
+    template<typename TExpected, typename TActual, typename TTolerance>
+    static void NearScan(const TExpected &expected, const TActual &actual, size_t, const TTolerance &tolerance, NearResult &result, std::false_type)
+    {
+        using std::begin;
+        using std::end;
+
+        typedef typename near_value<TExpected, TActual>::type value_type;
+
+        static const size_t BlockLength = 1024;
+        value_type expectedBlock[BlockLength];
+        value_type actualBlock[BlockLength];
+
+        size_t offset = 0;
+        size_t count = 0;
+
+        auto actualIt = begin(actual);
+        for (auto expectedIt = begin(expected); expectedIt != end(expected); ++expectedIt, ++actualIt)
+        {
+            expectedBlock[count] = static_cast<value_type>(*expectedIt);
+            actualBlock[count] = static_cast<value_type>(*actualIt);
+
+            if (++count == BlockLength)
+            {
+                NearScan(expectedBlock, actualBlock, count, tolerance, offset, result);
+                offset += count;
+                count = 0;
+            }
+        }
+
+        NearScan(expectedBlock, actualBlock, count, tolerance, offset, result);
+    }
+
+    template<typename TExpected, typename TActual, typename TTolerance>
+    xUnitFailure NearRange(const std::string &call, const TExpected &expected, const TActual &actual, const TTolerance &tolerance, LineInfo &&lineInfo) const
+    {
+        using std::begin;
+        using std::end;
+
+        const size_t expectedSize = std::distance(begin(expected), end(expected));
+        const size_t actualSize = std::distance(begin(actual), end(actual));
+
+        if (expectedSize != actualSize)
+        {
+            return OnFailure(std::move(xUnitAssert(callPrefix + call, std::move(lineInfo))
+                .CustomMessage("Sequence lengths differ.")
+                .Expected("length " + ToString(expectedSize))
+                .Actual("length " + ToString(actualSize))));
+        }
+
+        NearResult result;
+        NearScan(expected, actual, expectedSize, tolerance, result, std::integral_constant<bool, near_contiguous<TExpected, TActual>::value>());
+
+        if (result.failures != 0)
+        {
+            auto expectedIt = begin(expected);
+            auto actualIt = begin(actual);
+            std::advance(expectedIt, result.worst);
+            std::advance(actualIt, result.worst);
+
+            typedef typename near_value<TExpected, TActual>::type value_type;
+
+            return NearFailure(call, expectedSize, result, tolerance.ToString(),
+                NearToString(static_cast<value_type>(*expectedIt)), NearToString(static_cast<value_type>(*actualIt)), std::move(lineInfo));
+        }
+
+        return OnSuccess();
+    }
+
+    xUnitFailure NearFailure(const std::string &call, size_t count, const NearResult &result, std::string &&tolerance, std::string &&expected, std::string &&actual, LineInfo &&lineInfo) const;
+
+    template<typename T>
+    struct is_hashable
+    {
+    private:
+        template<typename C>
+        static char f(decltype(std::hash<C>()(std::declval<const C &>())) *);
+
+        template<typename C>
+        static long f(...);
+
+    public:
+        static const bool value = (sizeof(f<T>(nullptr)) == sizeof(char));
+    };
+
+    // elements left over after matching expected against actual; only the first few of each are rendered
+    struct EquivalenceResult
+    {
+        EquivalenceResult();
+
+        size_t missing;
+        size_t unexpected;
+        std::vector<std::string> missingValues;
+        std::vector<std::string> unexpectedValues;
+    };
+
+    static const size_t MaxEquivalenceValues = 8;
+
+    template<typename T>
+    static void Missing(EquivalenceResult &result, const T &value)
+    {
+        if (result.missing++ < MaxEquivalenceValues)
+        {
+            result.missingValues.push_back(ToString(value));
+        }
+    }
+
+    template<typename T>
+    static void Unexpected(EquivalenceResult &result, const T &value)
+    {
+        if (result.unexpected++ < MaxEquivalenceValues)
+        {
+            result.unexpectedValues.push_back(ToString(value));
+        }
+    }
+
+    template<typename T>
+    struct ElementHash
+    {
+        size_t operator()(const T *element) const
+        {
+            return std::hash<T>()(*element);
+        }
+    };
+
+    template<typename T>
+    struct ElementEqual
+    {
+        bool operator()(const T *a, const T *b) const
+        {
+            return *a == *b;
+        }
+    };
+
+    // Elements are counted in a hash table keyed on their address, so nothing is copied.
+    template<typename T, typename TExpected, typename TActual>
+    static EquivalenceResult Match(const TExpected &expected, const TActual &actual, std::true_type)
+    {
+        using std::begin;
+        using std::end;
+
+        std::unordered_map<const T *, long long, ElementHash<T>, ElementEqual<T>> counts;
+        counts.reserve(std::distance(begin(expected), end(expected)));
+
+        for (auto it = begin(expected); it != end(expected); ++it)
+        {
+            ++counts[&*it];
+        }
+
+        for (auto it = begin(actual); it != end(actual); ++it)
+        {
+            --counts[&*it];
+        }
+
+        // report in sequence order rather than hash order
+        EquivalenceResult result;
+
+        for (auto it = begin(expected); it != end(expected); ++it)
+        {
+            auto count = counts.find(&*it);
+            if (count->second > 0)
+            {
+                --count->second;
+                Missing(result, *it);
+            }
+        }
+
+        for (auto it = begin(actual); it != end(actual); ++it)
+        {
+            auto count = counts.find(&*it);
+            if (count->second < 0)
+            {
+                ++count->second;
+                Unexpected(result, *it);
+            }
+        }
+
+        return result;
+    }
+
+    // without a hash, both sides are sorted by address and walked in step
+    template<typename T, typename TExpected, typename TActual>
+    static EquivalenceResult Match(const TExpected &expected, const TActual &actual, std::false_type)
+    {
+        using std::begin;
+        using std::end;
+
+        auto less = [](const T *a, const T *b) { return *a < *b; };
+
+        std::vector<const T *> sortedExpected;
+        for (auto it = begin(expected); it != end(expected); ++it)
+        {
+            sortedExpected.push_back(&*it);
+        }
+
+        std::vector<const T *> sortedActual;
+        for (auto it = begin(actual); it != end(actual); ++it)
+        {
+            sortedActual.push_back(&*it);
+        }
+
+        std::sort(sortedExpected.begin(), sortedExpected.end(), less);
+        std::sort(sortedActual.begin(), sortedActual.end(), less);
+
+        EquivalenceResult result;
+
+        auto e = sortedExpected.begin();
+        auto a = sortedActual.begin();
+
+        while (e != sortedExpected.end() || a != sortedActual.end())
+        {
+            if (a == sortedActual.end() || (e != sortedExpected.end() && less(*e, *a)))
+            {
+                Missing(result, **e++);
+            }
+            else if (e == sortedExpected.end() || less(*a, *e))
+            {
+                Unexpected(result, **a++);
+            }
+            else
+            {
+                ++e;
+                ++a;
+            }
+        }
+
+        return result;
+    }
+
+    xUnitFailure EquivalentFailure(const EquivalenceResult &result, LineInfo &&lineInfo) const;
+
+    // elements rejected by an All predicate; only the first few are kept
+    struct AllResult
+    {
+        AllResult();
+
+        size_t failures;
+        std::vector<std::pair<size_t, std::string>> first;
+    };
+
+    static const size_t MaxAllValues = 8;
+
+    // returns the number of elements scanned
+    template<typename TIterator, typename TPredicate>
+    static size_t AllScan(TIterator begin, TIterator end, size_t offset, TPredicate &predicate, AllResult &result)
+    {
+        size_t index = offset;
+
+        for (auto it = begin; it != end; ++it, ++index)
+        {
+            if (!predicate(*it) && result.failures++ < MaxAllValues)
+            {
+                result.first.push_back(std::make_pair(index, ToString(*it)));
+            }
+        }
+
+        return index - offset;
+    }
+
+    // runs scan(begin, end, chunkResult) over [0, count) in chunks, one thread each, and merges the results in order
+    static void ParallelScan(size_t count, size_t threads, const std::function<void (size_t, size_t, AllResult &)> &scan, AllResult &result);
+
+    xUnitFailure AllFailure(size_t count, const AllResult &result, LineInfo &&lineInfo) const;
+
     xUnitFailure OnFailure(xUnitAssert &&assert) const;
     xUnitFailure OnSuccess() const;
 
@@ -178,6 +716,31 @@ public:
     xUnitFailure Equal(float expected, float actual, int precision, LineInfo &&lineInfo = LineInfo()) const;
     xUnitFailure Equal(double expected, double actual, int precision, LineInfo &&lineInfo = LineInfo()) const;
 
+    // Passes when |expected - actual| <= max(absoluteTolerance, relativeTolerance * |expected|) for every element.
+    // A failure is reported once, with the number of elements out of tolerance and the worst of them.
+    template<typename TExpected, typename TActual>
+    typename std::enable_if<
+        !std::is_arithmetic<TExpected>::value && !std::is_arithmetic<TActual>::value,
+        xUnitFailure>::type Near(const TExpected &expected, const TActual &actual, double absoluteTolerance, double relativeTolerance = 0.0, LineInfo &&lineInfo = LineInfo()) const
+    {
+        return NearRange("Near", expected, actual, CheckTolerance(absoluteTolerance, relativeTolerance), std::move(lineInfo));
+    }
+
+    xUnitFailure Near(double expected, double actual, double absoluteTolerance, double relativeTolerance = 0.0, LineInfo &&lineInfo = LineInfo()) const;
+
+    // Passes when every element is at most maxUlps representable values away from the expected one.
+    template<typename TExpected, typename TActual>
+    typename std::enable_if<
+        !std::is_arithmetic<TExpected>::value && !std::is_arithmetic<TActual>::value,
+        xUnitFailure>::type NearUlps(const TExpected &expected, const TActual &actual, size_t maxUlps, LineInfo &&lineInfo = LineInfo()) const
+    {
+        UlpTolerance tolerance = { maxUlps };
+        return NearRange("NearUlps", expected, actual, tolerance, std::move(lineInfo));
+    }
+
+    xUnitFailure NearUlps(float expected, float actual, size_t maxUlps, LineInfo &&lineInfo = LineInfo()) const;
+    xUnitFailure NearUlps(double expected, double actual, size_t maxUlps, LineInfo &&lineInfo = LineInfo()) const;
+
     template<typename TExpected, typename TActual, typename TComparer>
     xUnitFailure Equal(TExpected &&expectedBegin, TExpected &&expectedEnd, TActual &&actualBegin, TActual &&actualEnd, TComparer &&comparer, LineInfo &&lineInfo = LineInfo()) const
     {
@@ -199,10 +762,14 @@ public:
 
         if (expected != expectedEnd || actual != actualEnd)
         {
+            typedef typename std::decay<TExpected>::type expected_iterator;
+            typedef typename std::decay<TActual>::type actual_iterator;
+
             return OnFailure(std::move(xUnitAssert(callPrefix + "Equal", std::move(lineInfo))
-                .CustomMessage("Sequence unequal at location " + ToString(index) + ".")
-                .Expected(RangeToString(std::forward<TExpected>(expectedBegin), std::forward<TExpected>(expectedEnd)))
-                .Actual(RangeToString(std::forward<TActual>(actualBegin), std::forward<TActual>(actualEnd)))));
+                .CustomMessage("Sequence unequal at location " + ToString(index) + "." +
+                    SequenceDiff<expected_iterator, actual_iterator>(expectedBegin, expectedEnd, actualBegin, actualEnd, comparer))
+                .Expected(RangeToString<expected_iterator>(expectedBegin, expectedEnd, index))
+                .Actual(RangeToString<actual_iterator>(actualBegin, actualEnd, index))));
         }
 
         return OnSuccess();
@@ -380,10 +947,7 @@ public:
         xUnitFailure
     >::type DoesNotContain(const TSequence &sequence, T &&value, LineInfo &&lineInfo = LineInfo()) const
     {
-        using std::begin;
-        using std::end;
-
-        if (std::find(begin(sequence), end(sequence), std::forward<T>(value)) != end(sequence))
+        if (Includes(sequence, std::forward<T>(value)))
         {
             return OnFailure(std::move(xUnitAssert(callPrefix + "DoesNotContain", std::move(lineInfo))));
         }
@@ -422,10 +986,7 @@ public:
         xUnitFailure
     >::type Contains(const TSequence &sequence, T &&value, LineInfo &&lineInfo = LineInfo()) const
     {
-        using std::begin;
-        using std::end;
-
-        if (std::find(begin(sequence), end(sequence), std::forward<T>(value)) == end(sequence))
+        if (!Includes(sequence, std::forward<T>(value)))
         {
             return OnFailure(std::move(xUnitAssert(callPrefix + "Contains", std::move(lineInfo))));
         }
@@ -444,6 +1005,69 @@ public:
 
     xUnitFailure Contains(const std::string &actualString, const std::string &value, LineInfo &&lineInfo = LineInfo()) const;
 
+    // Passes when both ranges hold the same elements, the same number of times, in any order.
+    // Elements are matched by hashing when std::hash supports them, and by sorting otherwise.
+    template<typename TExpected, typename TActual>
+    xUnitFailure Equivalent(const TExpected &expected, const TActual &actual, LineInfo &&lineInfo = LineInfo()) const
+    {
+        typedef typename range_element<TExpected>::type element;
+
+        static_assert(std::is_same<element, typename range_element<TActual>::type>::value, "Assert.Equivalent requires both ranges to have the same element type.");
+
+        auto result = Match<element>(expected, actual, std::integral_constant<bool, is_hashable<element>::value>());
+
+        if (result.missing != 0 || result.unexpected != 0)
+        {
+            return EquivalentFailure(result, std::move(lineInfo));
+        }
+
+        return OnSuccess();
+    }
+
+    // Evaluates the predicate over the whole range, and reports every rejected element in a single failure.
+    template<typename TSequence, typename TPredicate>
+    xUnitFailure All(const TSequence &sequence, TPredicate &&predicate, LineInfo &&lineInfo = LineInfo()) const
+    {
+        using std::begin;
+        using std::end;
+
+        AllResult result;
+        auto count = AllScan(begin(sequence), end(sequence), 0, predicate, result);
+
+        if (result.failures != 0)
+        {
+            return AllFailure(count, result, std::move(lineInfo));
+        }
+
+        return OnSuccess();
+    }
+
+    template<typename TSequence, typename TPredicate>
+    xUnitFailure All(const ParallelRange<TSequence> &parallel, TPredicate &&predicate, LineInfo &&lineInfo = LineInfo()) const
+    {
+        using std::begin;
+        using std::end;
+
+        auto first = begin(parallel.sequence);
+
+        static_assert(std::is_base_of<std::random_access_iterator_tag, typename std::iterator_traits<decltype(first)>::iterator_category>::value,
+            "xUnitpp::Parallel requires a random access range.");
+
+        const size_t count = std::distance(first, end(parallel.sequence));
+
+        AllResult result;
+        ParallelScan(count, parallel.threads,
+            [&](size_t from, size_t to, AllResult &chunk) { AllScan(first + from, first + to, from, predicate, chunk); },
+            result);
+
+        if (result.failures != 0)
+        {
+            return AllFailure(count, result, std::move(lineInfo));
+        }
+
+        return OnSuccess();
+    }
+
     template<typename TActual, typename TRange>
     xUnitFailure InRange(TActual &&actual, TRange &&min, TRange &&max, LineInfo &&lineInfo = LineInfo()) const
     {
@@ -0,0 +1,407 @@
+#ifndef XUNITDIFF_H_
+#define XUNITDIFF_H_
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+
+namespace xUnitpp { namespace Diff
+{
+
+// Reporting budgets: a rendered diff never grows past these, no matter how large the compared values are.
+static const size_t ContextLength = 3;          // unchanged elements shown around each change
+static const size_t MaxHunks = 8;
+static const size_t MaxReportLength = 4096;     // characters, all hunks together
+static const size_t MaxElementLength = 120;     // characters, any single rendered element
+static const long long MaxCost = 1LL << 24;     // element comparisons spent looking for a minimal diff
+
+// Long sequences are only printed around the first mismatch.
+static const size_t WindowBefore = 8;
+static const size_t WindowLength = 32;
+
+struct Edit
+{
+    enum Kind
+    {
+        Equal,
+        Delete,
+        Insert
+    };
+
+    Edit(Kind kind, size_t expected, size_t actual, size_t length)
+        : kind(kind)
+        , expected(expected)
+        , actual(actual)
+        , length(length)
+    {
+    }
+
+    Kind kind;
+    size_t expected;    // position in the expected sequence
+    size_t actual;      // position in the actual sequence
+    size_t length;
+};
+
+// a run of changes, plus the unchanged context printed around it
+struct Hunk
+{
+    size_t firstEdit;
+    size_t lastEdit;    // inclusive
+    size_t leading;
+    size_t trailing;
+};
+
+namespace detail
+{
+    //
+    // Myers' O(ND) difference algorithm, in its linear space (middle snake) form.
+    // See "An O(ND) Difference Algorithm and Its Variations", Eugene W. Myers, 1986.
+    //
+    // Every comparison is charged against a budget. Once it runs out, whatever is left is reported
+    // as a plain replacement: the edit script is still correct, just no longer minimal.
+    template<typename TEqual>
+    class Myers
+    {
+    public:
+        Myers(TEqual &equal, long long cost)
+            : equal(equal)
+            , cost(cost)
+        {
+        }
+
+        void Compare(size_t e0, size_t e1, size_t a0, size_t a1)
+        {
+            size_t prefix = 0;
+            while (e0 + prefix != e1 && a0 + prefix != a1 && equal(e0 + prefix, a0 + prefix))
+            {
+                ++prefix;
+            }
+
+            Append(Edit::Equal, e0, a0, prefix);
+            e0 += prefix;
+            a0 += prefix;
+
+            size_t suffix = 0;
+            while (e1 - suffix != e0 && a1 - suffix != a0 && equal(e1 - suffix - 1, a1 - suffix - 1))
+            {
+                ++suffix;
+            }
+
+            e1 -= suffix;
+            a1 -= suffix;
+
+            size_t splitExpected, splitActual;
+            if (e0 == e1)
+            {
+                Append(Edit::Insert, e0, a0, a1 - a0);
+            }
+            else if (a0 == a1)
+            {
+                Append(Edit::Delete, e0, a0, e1 - e0);
+            }
+            else if (cost > 0 && Bisect(e0, e1, a0, a1, splitExpected, splitActual))
+            {
+                Compare(e0, splitExpected, a0, splitActual);
+                Compare(splitExpected, e1, splitActual, a1);
+            }
+            else
+            {
+                Append(Edit::Delete, e0, a0, e1 - e0);
+                Append(Edit::Insert, e1, a0, a1 - a0);
+            }
+
+            Append(Edit::Equal, e1, a1, suffix);
+        }
+
+        std::vector<Edit> edits;
+
+    private:
+        Myers &operator =(Myers) /* = delete */;
+
+        void Append(Edit::Kind kind, size_t expected, size_t actual, size_t length)
+        {
+            if (length == 0)
+            {
+                return;
+            }
+
+            if (!edits.empty() && edits.back().kind == kind)
+            {
+                edits.back().length += length;
+            }
+            else
+            {
+                edits.push_back(Edit(kind, expected, actual, length));
+            }
+        }
+
+        // find the middle snake of the shortest edit script, searching from both ends at once
+        bool Bisect(size_t e0, size_t e1, size_t a0, size_t a1, size_t &splitExpected, size_t &splitActual)
+        {
+            typedef long long index;
+
+            const index n = (index)(e1 - e0);
+            const index m = (index)(a1 - a0);
+
+            // a search to depth d costs at least d^2 comparisons, so the budget bounds the memory as well
+            const index maxD = std::min<index>((n + m + 1) / 2, (index)std::sqrt((double)cost) + 1);
+            const index offset = maxD + 1;
+            const index length = 2 * offset + 1;
+            const index delta = n - m;
+            const bool front = (delta % 2 != 0);
+
+            std::vector<index> v1((size_t)length, -1);
+            std::vector<index> v2((size_t)length, -1);
+            v1[(size_t)offset + 1] = 0;
+            v2[(size_t)offset + 1] = 0;
+
+            index k1start = 0;
+            index k1end = 0;
+            index k2start = 0;
+            index k2end = 0;
+
+            for (index d = 0; d != maxD; ++d)
+            {
+                for (index k1 = -d + k1start; k1 <= d - k1end; k1 += 2)
+                {
+                    const index k1Offset = offset + k1;
+
+                    index x1 = (k1 == -d || (k1 != d && v1[k1Offset - 1] < v1[k1Offset + 1])) ? v1[k1Offset + 1] : v1[k1Offset - 1] + 1;
+                    index y1 = x1 - k1;
+
+                    while (x1 < n && y1 < m && equal(e0 + (size_t)x1, a0 + (size_t)y1))
+                    {
+                        ++x1;
+                        ++y1;
+                        --cost;
+                    }
+
+                    --cost;
+                    v1[k1Offset] = x1;
+
+                    if (x1 > n)
+                    {
+                        k1end += 2;
+                    }
+                    else if (y1 > m)
+                    {
+                        k1start += 2;
+                    }
+                    else if (front)
+                    {
+                        const index k2Offset = offset + delta - k1;
+                        if (k2Offset >= 0 && k2Offset < length && v2[k2Offset] != -1 && x1 >= n - v2[k2Offset])
+                        {
+                            splitExpected = e0 + (size_t)x1;
+                            splitActual = a0 + (size_t)y1;
+                            return true;
+                        }
+                    }
+                }
+
+                for (index k2 = -d + k2start; k2 <= d - k2end; k2 += 2)
+                {
+                    const index k2Offset = offset + k2;
+
+                    index x2 = (k2 == -d || (k2 != d && v2[k2Offset - 1] < v2[k2Offset + 1])) ? v2[k2Offset + 1] : v2[k2Offset - 1] + 1;
+                    index y2 = x2 - k2;
+
+                    while (x2 < n && y2 < m && equal(e1 - (size_t)x2 - 1, a1 - (size_t)y2 - 1))
+                    {
+                        ++x2;
+                        ++y2;
+                        --cost;
+                    }
+
+                    --cost;
+                    v2[k2Offset] = x2;
+
+                    if (x2 > n)
+                    {
+                        k2end += 2;
+                    }
+                    else if (y2 > m)
+                    {
+                        k2start += 2;
+                    }
+                    else if (!front)
+                    {
+                        const index k1Offset = offset + delta - k2;
+                        if (k1Offset >= 0 && k1Offset < length && v1[k1Offset] != -1)
+                        {
+                            const index x1 = v1[k1Offset];
+                            const index y1 = x1 - (k1Offset - offset);
+
+                            if (x1 >= n - x2)
+                            {
+                                splitExpected = e0 + (size_t)x1;
+                                splitActual = a0 + (size_t)y1;
+                                return true;
+                            }
+                        }
+                    }
+                }
+
+                if (cost <= 0)
+                {
+                    break;
+                }
+            }
+
+            return false;
+        }
+
+    private:
+        TEqual &equal;
+        long long cost;
+    };
+}
+
+// TEqual is called as equal(expectedIndex, actualIndex)
+template<typename TEqual>
+std::vector<Edit> Compute(size_t expectedSize, size_t actualSize, TEqual equal, long long maxCost = MaxCost)
+{
+    detail::Myers<TEqual> myers(equal, maxCost);
+    myers.Compare(0, expectedSize, 0, actualSize);
+    return std::move(myers.edits);
+}
+
+inline std::vector<Hunk> Hunks(const std::vector<Edit> &edits, size_t context = ContextLength)
+{
+    std::vector<Hunk> hunks;
+
+    for (size_t i = 0; i != edits.size(); ++i)
+    {
+        if (edits[i].kind == Edit::Equal)
+        {
+            continue;
+        }
+
+        Hunk hunk;
+        hunk.firstEdit = i;
+        hunk.lastEdit = i;
+
+        // unchanged runs short enough to be printed anyway join the changes on either side
+        for (size_t next = i + 1; next != edits.size(); ++next)
+        {
+            if (edits[next].kind != Edit::Equal)
+            {
+                hunk.lastEdit = next;
+            }
+            else if (edits[next].length > 2 * context || next + 1 == edits.size())
+            {
+                break;
+            }
+        }
+
+        hunk.leading = (i != 0) ? std::min(context, edits[i - 1].length) : 0;
+        hunk.trailing = (hunk.lastEdit + 1 != edits.size()) ? std::min(context, edits[hunk.lastEdit + 1].length) : 0;
+
+        hunks.push_back(hunk);
+        i = hunk.lastEdit;
+    }
+
+    return hunks;
+}
+
+inline std::string Truncate(std::string &&value, size_t length = MaxElementLength)
+{
+    if (value.size() > length)
+    {
+        value.resize(length);
+        value += "...";
+    }
+
+    return std::move(value);
+}
+
+// Renders one element per line, unified diff style:
+//      @@ expected[3..7) actual[3..8) @@
+//        unchanged
+//      - only in expected
+//      + only in actual
+template<typename TRenderExpected, typename TRenderActual>
+std::string Render(const std::vector<Edit> &edits, TRenderExpected &&renderExpected, TRenderActual &&renderActual, const std::string &indent = "     ")
+{
+    std::string result;
+
+    auto hunks = Hunks(edits);
+    size_t shown = 0;
+
+    for (const auto &hunk : hunks)
+    {
+        if (shown == MaxHunks || result.size() > MaxReportLength)
+        {
+            break;
+        }
+
+        const auto &first = edits[hunk.firstEdit];
+        const auto &last = edits[hunk.lastEdit];
+
+        auto expectedBegin = first.expected - hunk.leading;
+        auto actualBegin = first.actual - hunk.leading;
+        auto expectedEnd = last.expected + (last.kind == Edit::Insert ? 0 : last.length) + hunk.trailing;
+        auto actualEnd = last.actual + (last.kind == Edit::Delete ? 0 : last.length) + hunk.trailing;
+
+        result += "\n" + indent + "@@ expected[" + std::to_string(expectedBegin) + ".." + std::to_string(expectedEnd) +
+            ") actual[" + std::to_string(actualBegin) + ".." + std::to_string(actualEnd) + ") @@";
+
+        auto line = [&](const char *marker, std::string &&element) -> bool
+            {
+                result += "\n" + indent + marker + Truncate(std::move(element));
+                return result.size() <= MaxReportLength;
+            };
+
+        bool full = false;
+
+        for (size_t i = 0; !full && i != hunk.leading; ++i)
+        {
+            full = !line("  ", renderExpected(expectedBegin + i));
+        }
+
+        for (auto idx = hunk.firstEdit; !full && idx <= hunk.lastEdit; ++idx)
+        {
+            const auto &edit = edits[idx];
+
+            for (size_t i = 0; !full && i != edit.length; ++i)
+            {
+                switch (edit.kind)
+                {
+                case Edit::Equal:
+                    full = !line("  ", renderExpected(edit.expected + i));
+                    break;
+                case Edit::Delete:
+                    full = !line("- ", renderExpected(edit.expected + i));
+                    break;
+                case Edit::Insert:
+                    full = !line("+ ", renderActual(edit.actual + i));
+                    break;
+                }
+            }
+        }
+
+        for (size_t i = 0; !full && i != hunk.trailing; ++i)
+        {
+            full = !line("  ", renderExpected(expectedEnd - hunk.trailing + i));
+        }
+
+        ++shown;
+
+        if (full)
+        {
+            result += "\n" + indent + "...";
+        }
+    }
+
+    if (shown != hunks.size())
+    {
+        result += "\n" + indent + "(" + std::to_string(hunks.size() - shown) + " more differences not shown)";
+    }
+
+    return result;
+}
+
+}}
+
+#endif
@@ -10,20 +10,23 @@
 #define XU_UNIQUE_TEST XU_CAT(TestFn_, __LINE__)
 #define XU_UNIQUE_RUNNER XU_CAT(TestRunner_, __LINE__)
 
-// !!!VS fix when initializer lists are supported
-#define XU_TEST_EVENTS \
-namespace detail \
-{ \
-    std::shared_ptr<xUnitpp::TestEventRecorder> eventRecorders[] = { \
-        /* check */ std::make_shared<xUnitpp::TestEventRecorder>(), \
-        /* warn  */ std::make_shared<xUnitpp::TestEventRecorder>(), \
-        /* log   */ std::make_shared<xUnitpp::TestEventRecorder>(), \
+#define XU_UNIQUE_RECORD XU_CAT(TestRecord_, __LINE__)
+#define XU_UNIQUE_RECORD_ENTRY XU_CAT(TestRecordEntry_, __LINE__)
+#define XU_UNIQUE_SOURCE XU_CAT(TestSource_, __LINE__)
+
+// Constant data only: the record and the entry pointing to it are laid down by the compiler, and
+// no code runs for them when the library is loaded.
+#define XU_TEST_RECORD(Details, params, timeout, fact, theory) \
+    const xUnitpp::TestRecord XU_UNIQUE_RECORD = { \
+        Details, params, __FILE__, __LINE__, timeout, &xUnitSuite::Name, &xUnitAttributes::Attributes, fact, theory \
     }; \
-    auto pCheck = std::make_shared<xUnitpp::Check>(*eventRecorders[0]); \
-    auto pWarn = std::make_shared<xUnitpp::Warn>(*eventRecorders[1]); \
-    auto pLog = std::make_shared<xUnitpp::Log>(*eventRecorders[2]); \
-} \
-std::vector<std::shared_ptr<xUnitpp::TestEventRecorder>> eventRecorders(std::begin(detail::eventRecorders), std::end(detail::eventRecorders)); \
+    XU_RECORD_SECTION const xUnitpp::TestRecord *const XU_UNIQUE_RECORD_ENTRY = &XU_UNIQUE_RECORD;
+
+// bound to objects the library already has, so these are constant-initialised too
+#define XU_TEST_EVENTS \
+    const xUnitpp::Check &Check = xUnitpp::Events::Check; \
+    const xUnitpp::Warn &Warn = xUnitpp::Events::Warn; \
+    const xUnitpp::Log &Log = xUnitpp::Events::Log;
 
 // with thanks for various sources, but I got it from
 // http://stackoverflow.com/questions/2308243/macro-returning-the-number-of-arguments-it-is-given-in-c
@@ -57,10 +60,25 @@ std::vector<std::shared_ptr<xUnitpp::TestEventRecorder>> eventRecorders(std::beg
 
 #define EXPAND(x) x
 
+// 63 arguments, as above; THEORY counts its rows without it, so this only limits attributes
 #define PP_NARGS(...) \
-    EXPAND(_xPP_NARGS_IMPL(__VA_ARGS__,15,14,13,12,11,10,9,8,7,6,5,4,3,2,1,0))
+    EXPAND(_xPP_NARGS_IMPL(__VA_ARGS__,                          \
+        63,62,61,60,                                            \
+        59,58,57,56,55,54,53,52,51,50,                          \
+        49,48,47,46,45,44,43,42,41,40,                          \
+        39,38,37,36,35,34,33,32,31,30,                          \
+        29,28,27,26,25,24,23,22,21,20,                          \
+        19,18,17,16,15,14,13,12,11,10,                          \
+         9, 8, 7, 6, 5, 4, 3, 2, 1, 0))
 
-#define _xPP_NARGS_IMPL(x1,x2,x3,x4,x5,x6,x7,x8,x9,x10,x11,x12,x13,x14,x15,N,...) N
+#define _xPP_NARGS_IMPL(                                        \
+     x1, x2, x3, x4, x5, x6, x7, x8, x9,x10,                    \
+    x11,x12,x13,x14,x15,x16,x17,x18,x19,x20,                    \
+    x21,x22,x23,x24,x25,x26,x27,x28,x29,x30,                    \
+    x31,x32,x33,x34,x35,x36,x37,x38,x39,x40,                    \
+    x41,x42,x43,x44,x45,x46,x47,x48,x49,x50,                    \
+    x51,x52,x53,x54,x55,x56,x57,x58,x59,x60,                    \
+    x61,x62,x63,  N, ...) N
 
 #define CAR(x, ...) x
 #define CDR(x, ...) __VA_ARGS__
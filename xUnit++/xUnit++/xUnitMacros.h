@@ -8,6 +8,7 @@
 #include "LineInfo.h"
 #include "TestCollection.h"
 #include "TestEventRecorder.h"
+#include "TestRecord.h"
 #include "Suite.h"
 #include "xUnitCheck.h"
 #include "xUnitLog.h"
@@ -60,16 +61,15 @@ namespace xUnitpp { struct NoFixture {}; }
 #define TIMED_FACT_FIXTURE(FactDetails, FixtureType, timeout) \
     namespace XU_UNIQUE_NS { \
         using xUnitpp::Assert; \
-        XU_TEST_EVENTS \
         class XU_UNIQUE_FIXTURE : public FixtureType \
         { \
             /* !!!VS fix when '= delete' is supported */ \
             XU_UNIQUE_FIXTURE &operator =(XU_UNIQUE_FIXTURE) /* = delete */; \
         public: \
             XU_UNIQUE_FIXTURE() \
-                : Check(*detail::pCheck) \
-                , Warn(*detail::pWarn) \
-                , Log(*detail::pLog) \
+                : Check(xUnitpp::Events::Check) \
+                , Warn(xUnitpp::Events::Warn) \
+                , Log(xUnitpp::Events::Log) \
                 { } \
             void XU_UNIQUE_TEST(); \
             const xUnitpp::Check &Check; \
@@ -77,9 +77,7 @@ namespace xUnitpp { struct NoFixture {}; }
             const xUnitpp::Log &Log; \
         }; \
         void XU_UNIQUE_RUNNER() { XU_UNIQUE_FIXTURE().XU_UNIQUE_TEST(); } \
-        xUnitpp::TestCollection::Register reg(xUnitpp::TestCollection::Instance(), \
-            &XU_UNIQUE_RUNNER, std::string(FactDetails), xUnitSuite::Name(), \
-            xUnitAttributes::Attributes(), timeout, std::string(__FILE__), __LINE__, std::move(eventRecorders)); \
+        XU_TEST_RECORD(FactDetails, "", timeout, &XU_UNIQUE_RUNNER, nullptr) \
     } \
     void XU_UNIQUE_NS :: XU_UNIQUE_FIXTURE :: XU_UNIQUE_TEST()
 
@@ -97,13 +95,12 @@ namespace xUnitpp { struct NoFixture {}; }
     namespace XU_UNIQUE_NS { \
         using xUnitpp::Assert; \
         XU_TEST_EVENTS \
-        const xUnitpp::Check &Check = *detail::pCheck; \
-        const xUnitpp::Warn &Warn = *detail::pWarn; \
-        const xUnitpp::Log &Log = *detail::pLog; \
         void XU_UNIQUE_TEST params; \
-        xUnitpp::TestCollection::Register reg(xUnitpp::TestCollection::Instance(), \
-            &XU_UNIQUE_TEST, DataProvider, std::string(TheoryDetails), xUnitSuite::Name(), std::string(#params), \
-            xUnitAttributes::Attributes(), timeout, std::string(__FILE__), __LINE__, eventRecorders); \
+        std::shared_ptr<const xUnitpp::TheorySource> XU_UNIQUE_SOURCE(const xUnitpp::TestRecord &record) \
+        { \
+            return xUnitpp::TestCollection::RecordedTheory(record, &XU_UNIQUE_TEST, DataProvider); \
+        } \
+        XU_TEST_RECORD(TheoryDetails, #params, timeout, nullptr, &XU_UNIQUE_SOURCE) \
     } \
     void XU_UNIQUE_NS :: XU_UNIQUE_TEST params
 
@@ -115,14 +112,14 @@ namespace xUnitpp { struct NoFixture {}; }
     namespace XU_UNIQUE_NS { \
         using xUnitpp::Assert; \
         XU_TEST_EVENTS \
-        const xUnitpp::Check &Check = *detail::pCheck; \
-        const xUnitpp::Warn &Warn = *detail::pWarn; \
-        const xUnitpp::Log &Log = *detail::pLog; \
         void XU_UNIQUE_TEST params; \
-        decltype(CAR(__VA_ARGS__)) args[] = { __VA_ARGS__ }; \
-        xUnitpp::TestCollection::Register reg(xUnitpp::TestCollection::Instance(), \
-            &XU_UNIQUE_TEST, xUnitpp::TheoryData(PP_NARGS(__VA_ARGS__), args), std::string(TheoryDetails), \
-            xUnitSuite::Name(), std::string(#params), xUnitAttributes::Attributes(), timeout, std::string(__FILE__), __LINE__, eventRecorders); \
+        std::shared_ptr<const xUnitpp::TheorySource> XU_UNIQUE_SOURCE(const xUnitpp::TestRecord &record) \
+        { \
+            /* built the first time the theory is, and never destroyed before its rows */ \
+            static const decltype(CAR(__VA_ARGS__)) args[] = { __VA_ARGS__ }; \
+            return xUnitpp::TestCollection::RecordedTheory(record, &XU_UNIQUE_TEST, xUnitpp::TheoryData(args)); \
+        } \
+        XU_TEST_RECORD(TheoryDetails, #params, timeout, nullptr, &XU_UNIQUE_SOURCE) \
     } \
     void XU_UNIQUE_NS :: XU_UNIQUE_TEST params
 
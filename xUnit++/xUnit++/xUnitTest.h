@@ -16,6 +16,9 @@ namespace xUnitpp
 class AttributeCollection;
 class TestEvent;
 class TestEventRecorder;
+struct TestRecord;
+class TheoryRow;
+class TheorySource;
 
 enum class TestResult
 {
@@ -25,11 +28,29 @@ enum class TestResult
 
 class xUnitTest
 {
+    // tells apart registered tests whose stable ids collide
+    friend class TestCollection;
+
 public:
     xUnitTest(std::function<void()> &&test, std::string &&name, int testInstance, std::string &&params,
         const std::string &suite, AttributeCollection &&attributes, Time::Duration timeLimit,
         std::string &&filename, int line, const std::vector<std::shared_ptr<TestEventRecorder>> &testEventRecorders);
 
+    // a theory, whose rows are only generated when it is run
+    xUnitTest(std::shared_ptr<const TheorySource> &&theory, std::string &&name, const std::string &suite,
+        AttributeCollection &&attributes, Time::Duration timeLimit,
+        std::string &&filename, int line, const std::vector<std::shared_ptr<TestEventRecorder>> &testEventRecorders);
+
+    // the test a macro recorded, as `id` and `stableId`
+    xUnitTest(int id, unsigned long long stableId, const TestRecord &record, AttributeCollection &&attributes,
+        const std::vector<std::shared_ptr<TestEventRecorder>> &testEventRecorders);
+
+    // one row of a theory, sharing everything else with it
+    xUnitTest(const xUnitTest &theory, std::shared_ptr<const TheoryRow> &&row);
+
+    // create the test for one row of this theory
+    std::shared_ptr<xUnitTest> Instance(std::shared_ptr<const TheoryRow> &&row) const;
+
     const xUnitpp::TestDetails &TestDetails() const;
 
     TestResult Run();
@@ -50,7 +71,7 @@ private:
     Time::TimeStamp testStart;
     Time::TimeStamp testStop;
 
-    std::vector<std::shared_ptr<TestEventRecorder>> testEventRecorders;
+    std::shared_ptr<const std::vector<std::shared_ptr<TestEventRecorder>>> testEventRecorders;
 
     std::mutex eventLock;
     std::vector<TestEvent> testEvents;
@@ -2,6 +2,7 @@
 #define XUNITTESTRUNNER_H_
 
 #include <chrono>
+#include <cstdint>
 #include <functional>
 #include <memory>
 #include <string>
@@ -12,13 +13,20 @@
 namespace xUnitpp
 {
 
+enum class EventLevel;
 struct IOutput;
+struct RunOptions;
 struct TestDetails;
 class xUnitTest;
 
 int RunTests(IOutput &output, xUnitpp::TestFilterCallback filter, const std::vector<std::shared_ptr<xUnitTest>> &tests,
              Time::Duration maxTestRunTime, size_t maxConcurrent);
 
+// runs every one of `tests`: choosing which tests those are is up to the caller
+int RunTests(IOutput &output, const std::vector<std::shared_ptr<xUnitTest>> &tests, const RunOptions &options);
+int RunTests(IOutput &output, const std::vector<std::shared_ptr<xUnitTest>> &tests, Time::Duration maxTestRunTime, size_t maxConcurrent,
+             uint64_t seed, EventLevel minimumLevel);
+
 }
 
 #endif
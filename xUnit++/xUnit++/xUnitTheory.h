@@ -0,0 +1,600 @@
+#ifndef XUNITTHEORY_H_
+#define XUNITTHEORY_H_
+
+#include <algorithm>
+#include <deque>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+#include "xUnitToString.h"
+
+namespace xUnitpp
+{
+
+// One instance of a theory, ready to run. A row is only its index, plus pointers to the theory
+// and to its arguments where they already live: nothing is copied or formatted until it is needed.
+class TheoryRow
+{
+public:
+    TheoryRow(int instance)
+        : instance(instance)
+    {
+    }
+
+    virtual ~TheoryRow() {}
+
+    virtual void Run() const = 0;
+
+    // the arguments, for display
+    virtual std::string Params() const = 0;
+
+    int Instance() const
+    {
+        return instance;
+    }
+
+private:
+    int instance;
+};
+
+// A slice of a theory's rows. The rows are only produced when the worker running the chunk
+// enumerates it, so no more than a few chunks' worth of rows exist at any time.
+typedef std::function<void (const std::function<void (std::shared_ptr<const TheoryRow> &&)> &)> TheoryChunk;
+
+// a single pass over the rows of a theory
+class TheoryRows
+{
+public:
+    virtual ~TheoryRows() {}
+
+    // returns false once all rows have been handed out
+    virtual bool NextChunk(TheoryChunk &chunk) = 0;
+};
+
+class TheorySource
+{
+public:
+    static const int UnknownCount = -1;
+
+    virtual ~TheorySource() {}
+
+    // the number of rows when it is known without calling a provider that could build them: inline
+    // arrays, sized generators and fixed-size records know theirs, containers returned by a function don't
+    virtual int KnownCount() const = 0;
+
+    // called when the theory is run, never during static initialisation
+    virtual std::unique_ptr<TheoryRows> Open() const = 0;
+};
+
+// Rows computed from their index, on whichever worker runs them:
+//      DATA_THEORY("Squares", (int x, int square),
+//          xUnitpp::TheoryGenerator(1000000, [](size_t i) { return std::make_tuple((int)i, (int)(i * i)); }))
+template<typename TFn>
+class IndexedTheoryGenerator
+{
+public:
+    typedef typename std::decay<decltype(std::declval<const TFn &>()(size_t()))>::type tuple_type;
+
+    IndexedTheoryGenerator(size_t count, TFn fn)
+        : count(count)
+        , fn(fn)
+    {
+    }
+
+    // a generator is its own data provider
+    const IndexedTheoryGenerator &operator ()() const
+    {
+        return *this;
+    }
+
+    size_t Count() const
+    {
+        return count;
+    }
+
+    tuple_type operator [](size_t index) const
+    {
+        return fn(index);
+    }
+
+private:
+    size_t count;
+    TFn fn;
+};
+
+template<typename TFn>
+IndexedTheoryGenerator<TFn> TheoryGenerator(size_t count, TFn fn)
+{
+    return IndexedTheoryGenerator<TFn>(count, fn);
+}
+
+// Rows read one after another, for data which can only be produced in order. `next` fills in
+// the next row and returns false when there are none left. Since a stream can only be read once,
+// provide it from a function which starts a new one each time it is called:
+//      DATA_THEORY("Lines", (const std::string &line),
+//          ([]() { auto file = std::make_shared<std::ifstream>("data.txt");
+//                  return xUnitpp::TheoryStream<std::tuple<std::string>>(
+//                      [=](std::tuple<std::string> &row) { return !!std::getline(*file, std::get<0>(row)); }); }))
+template<typename TTuple>
+class TheoryStream
+{
+public:
+    typedef TTuple tuple_type;
+
+    TheoryStream(std::function<bool (TTuple &)> next)
+        : next(next)
+    {
+    }
+
+    bool Next(TTuple &row) const
+    {
+        return next(row);
+    }
+
+private:
+    std::function<bool (TTuple &)> next;
+};
+
+namespace TheoryImpl
+{
+    // begin/end as a range-based for would find them
+    namespace Adl
+    {
+        using std::begin;
+        using std::end;
+
+        template<typename T>
+        auto Begin(T &t) -> decltype(begin(t))
+        {
+            return begin(t);
+        }
+
+        template<typename T>
+        auto End(T &t) -> decltype(end(t))
+        {
+            return end(t);
+        }
+    }
+
+    // data which is counted in place, without a provider building it; see TheoryArray
+    template<typename TData>
+    struct KnownSize : std::false_type
+    {
+    };
+
+    // rows handed to a single worker at once
+    static const size_t MaxChunkLength = 256;
+    static const size_t StreamChunkLength = 64;
+
+    // enough chunks to keep every hardware thread busy, but no more rows than that in flight
+    inline size_t ChunkLength(size_t count)
+    {
+        const size_t workers = std::max(1U, std::thread::hardware_concurrency());
+        return std::max<size_t>(1, std::min(MaxChunkLength, count / (4 * workers)));
+    }
+
+    // !!!VS std::index_sequence, until every compiler we build with has it
+    template<size_t... I>
+    struct Indices
+    {
+    };
+
+    template<size_t N, size_t... I>
+    struct MakeIndices : MakeIndices<N - 1, N - 1, I...>
+    {
+    };
+
+    template<size_t... I>
+    struct MakeIndices<0, I...>
+    {
+        typedef Indices<I...> type;
+    };
+
+    template<bool...>
+    struct Bools
+    {
+    };
+
+    template<bool... B>
+    struct AnyOf : std::integral_constant<bool, !std::is_same<Bools<false, B...>, Bools<B..., false>>::value>
+    {
+    };
+
+    // Arguments which can be copied are passed to the theory as they are stored, so the row can
+    // still display them afterwards. Move-only arguments are moved in: a row only runs once.
+    template<typename TArg, bool Copyable = std::is_reference<TArg>::value || std::is_copy_constructible<TArg>::value>
+    struct Argument
+    {
+        static const bool Moved = false;
+
+        template<typename T>
+        static T &Forward(T &arg)
+        {
+            return arg;
+        }
+    };
+
+    template<typename TArg>
+    struct Argument<TArg, false>
+    {
+        static const bool Moved = true;
+
+        template<typename T>
+        static T &&Forward(T &arg)
+        {
+            return std::move(arg);
+        }
+    };
+
+    template<typename TTuple, typename = typename MakeIndices<std::tuple_size<TTuple>::value>::type>
+    struct MovesArguments;
+
+    template<typename TTuple, size_t... I>
+    struct MovesArguments<TTuple, Indices<I...>> : AnyOf<Argument<typename std::tuple_element<I, TTuple>::type>::Moved...>
+    {
+    };
+
+    template<typename TFn, typename TTuple, size_t... I>
+    void Invoke(const TFn &theory, TTuple &t, Indices<I...>)
+    {
+        typedef typename std::remove_const<TTuple>::type tuple_type;
+
+        theory(Argument<typename std::tuple_element<I, tuple_type>::type>::Forward(std::get<I>(t))...);
+    }
+
+    template<typename TFn, typename TTuple>
+    void Invoke(const TFn &theory, TTuple &t)
+    {
+        Invoke(theory, t, typename MakeIndices<std::tuple_size<typename std::remove_const<TTuple>::type>::value>::type());
+    }
+
+    inline const std::string &ParamName(const std::deque<std::string> &params, size_t index)
+    {
+        static const std::string unnamed = "?";
+        return index < params.size() ? params[index] : unnamed;
+    }
+
+    template<typename TTuple, size_t... I>
+    std::string Params(const std::deque<std::string> &params, const TTuple &t, Indices<I...>)
+    {
+        std::string result = "(";
+
+        int expand[] = { 0, ((result += (I == 0 ? "" : ", ") + ParamName(params, I) + ": " + ToString(std::get<I>(t))), 0)... };
+        (void)expand;
+
+        return result + ")";
+    }
+
+    template<typename TTuple>
+    std::string Params(const std::deque<std::string> &params, const TTuple &t)
+    {
+        return Params(params, t, typename MakeIndices<std::tuple_size<TTuple>::value>::type());
+    }
+
+    // What a row needs from its theory. Shared by every row and every chunk, and alive for as long as any of them.
+    template<typename TTheory>
+    struct Theory
+    {
+        Theory(TTheory theory, std::deque<std::string> &&params)
+            : theory(theory)
+            , params(std::move(params))
+        {
+        }
+
+        TTheory theory;
+        std::deque<std::string> params;
+    };
+
+    // TArgs is const when the provider only hands out const rows
+    template<typename TTheory, typename TArgs>
+    class Row : public TheoryRow
+    {
+        typedef typename std::remove_const<TArgs>::type tuple_type;
+
+    public:
+        // `args` usually points into a chunk's data, and keeps it alive until the row has run
+        Row(const std::shared_ptr<const Theory<TTheory>> &theory, int instance, std::shared_ptr<TArgs> &&args)
+            : TheoryRow(instance)
+            , theory(theory)
+            , args(std::move(args))
+        {
+        }
+
+        virtual void Run() const override
+        {
+            if (MovesArguments<tuple_type>::value)
+            {
+                // the arguments won't be worth displaying once they've been moved from
+                Params();
+            }
+
+            Invoke(theory->theory, *args);
+        }
+
+        virtual std::string Params() const override
+        {
+            if (MovesArguments<tuple_type>::value)
+            {
+                std::call_once(formatted, [this]() { params = TheoryImpl::Params(theory->params, *args); });
+                return params;
+            }
+
+            return TheoryImpl::Params(theory->params, *args);
+        }
+
+    private:
+        std::shared_ptr<const Theory<TTheory>> theory;
+        std::shared_ptr<TArgs> args;
+
+        mutable std::once_flag formatted;
+        mutable std::string params;
+    };
+
+    template<typename TTheory, typename TArgs>
+    std::shared_ptr<const TheoryRow> MakeRow(const std::shared_ptr<const Theory<TTheory>> &theory, int instance, std::shared_ptr<TArgs> &&args)
+    {
+        return std::make_shared<Row<TTheory, TArgs>>(theory, instance, std::move(args));
+    }
+
+    // providers returning a container (or anything else with begin/end) are called once per run,
+    // and the rows are handed out in place
+    template<typename TTheory, typename TProvider, typename TData>
+    class Source : public TheorySource
+    {
+        typedef typename std::remove_reference<decltype(*Adl::Begin(std::declval<TData &>()))>::type tuple_type;
+
+        class Rows : public TheoryRows
+        {
+        public:
+            Rows(std::shared_ptr<const Theory<TTheory>> theory, std::shared_ptr<TData> data)
+                : theory(theory)
+                , data(data)
+                , instance(0)
+            {
+                position = Adl::Begin(*data);
+                chunkLength = ChunkLength(std::distance(position, Adl::End(*data)));
+            }
+
+            virtual bool NextChunk(TheoryChunk &chunk) override
+            {
+                if (position == Adl::End(*data))
+                {
+                    return false;
+                }
+
+                auto first = position;
+                int firstInstance = instance;
+
+                for (size_t i = 0; i != chunkLength && position != Adl::End(*data); ++i, ++instance)
+                {
+                    ++position;
+                }
+
+                auto last = position;
+                auto theory = this->theory;
+                auto data = this->data;
+
+                chunk = [=](const std::function<void (std::shared_ptr<const TheoryRow> &&)> &run)
+                    {
+                        int instance = firstInstance;
+                        for (auto it = first; it != last; ++it)
+                        {
+                            // an aliasing pointer: the row keeps the whole data set alive, but nothing is copied
+                            run(MakeRow(theory, instance++, std::shared_ptr<tuple_type>(data, &*it)));
+                        }
+                    };
+
+                return true;
+            }
+
+        private:
+            std::shared_ptr<const Theory<TTheory>> theory;
+            std::shared_ptr<TData> data;
+            decltype(Adl::Begin(std::declval<TData &>())) position;
+            int instance;
+            size_t chunkLength;
+        };
+
+    public:
+        Source(std::shared_ptr<const Theory<TTheory>> theory, TProvider provider)
+            : theory(theory)
+            , provider(provider)
+        {
+        }
+
+        virtual int KnownCount() const override
+        {
+            if (!KnownSize<TData>::value)
+            {
+                return UnknownCount;
+            }
+
+            const auto &data = provider();
+            return (int)std::distance(Adl::Begin(data), Adl::End(data));
+        }
+
+        virtual std::unique_ptr<TheoryRows> Open() const override
+        {
+            return std::unique_ptr<TheoryRows>(new Rows(theory, std::make_shared<TData>(provider())));
+        }
+
+    private:
+        std::shared_ptr<const Theory<TTheory>> theory;
+        mutable TProvider provider;
+    };
+
+    // generated rows are created by the workers themselves, a range of indices at a time
+    template<typename TTheory, typename TProvider, typename TFn>
+    class Source<TTheory, TProvider, IndexedTheoryGenerator<TFn>> : public TheorySource
+    {
+        typedef IndexedTheoryGenerator<TFn> generator_type;
+        typedef typename generator_type::tuple_type tuple_type;
+
+        class Rows : public TheoryRows
+        {
+        public:
+            Rows(std::shared_ptr<const Theory<TTheory>> theory, std::shared_ptr<const generator_type> generator)
+                : theory(theory)
+                , generator(generator)
+                , next(0)
+                , chunkLength(ChunkLength(generator->Count()))
+            {
+            }
+
+            virtual bool NextChunk(TheoryChunk &chunk) override
+            {
+                if (next == generator->Count())
+                {
+                    return false;
+                }
+
+                const size_t first = next;
+                const size_t last = std::min(first + chunkLength, generator->Count());
+                next = last;
+
+                auto theory = this->theory;
+                auto generator = this->generator;
+
+                chunk = [=](const std::function<void (std::shared_ptr<const TheoryRow> &&)> &run)
+                    {
+                        for (size_t i = first; i != last; ++i)
+                        {
+                            run(MakeRow(theory, (int)i, std::make_shared<tuple_type>((*generator)[i])));
+                        }
+                    };
+
+                return true;
+            }
+
+        private:
+            std::shared_ptr<const Theory<TTheory>> theory;
+            std::shared_ptr<const generator_type> generator;
+            size_t next;
+            size_t chunkLength;
+        };
+
+    public:
+        Source(std::shared_ptr<const Theory<TTheory>> theory, TProvider provider)
+            : theory(theory)
+            , provider(provider)
+        {
+        }
+
+        virtual int KnownCount() const override
+        {
+            return (int)provider().Count();
+        }
+
+        virtual std::unique_ptr<TheoryRows> Open() const override
+        {
+            return std::unique_ptr<TheoryRows>(new Rows(theory, std::make_shared<const generator_type>(provider())));
+        }
+
+    private:
+        std::shared_ptr<const Theory<TTheory>> theory;
+        mutable TProvider provider;
+    };
+
+    // streamed rows have to be read in order, so they are read as each chunk is handed out
+    template<typename TTheory, typename TProvider, typename TTuple>
+    class Source<TTheory, TProvider, TheoryStream<TTuple>> : public TheorySource
+    {
+        class Rows : public TheoryRows
+        {
+        public:
+            Rows(std::shared_ptr<const Theory<TTheory>> theory, TheoryStream<TTuple> &&stream)
+                : theory(theory)
+                , stream(std::move(stream))
+                , instance(0)
+                , done(false)
+            {
+            }
+
+            virtual bool NextChunk(TheoryChunk &chunk) override
+            {
+                auto rows = std::make_shared<std::vector<TTuple>>();
+
+                while (!done && rows->size() != StreamChunkLength)
+                {
+                    TTuple row;
+                    if (stream.Next(row))
+                    {
+                        rows->push_back(std::move(row));
+                    }
+                    else
+                    {
+                        done = true;
+                    }
+                }
+
+                if (rows->empty())
+                {
+                    return false;
+                }
+
+                int firstInstance = instance;
+                instance += (int)rows->size();
+
+                auto theory = this->theory;
+
+                chunk = [=](const std::function<void (std::shared_ptr<const TheoryRow> &&)> &run)
+                    {
+                        for (size_t i = 0; i != rows->size(); ++i)
+                        {
+                            run(MakeRow(theory, firstInstance + (int)i, std::shared_ptr<TTuple>(rows, &(*rows)[i])));
+                        }
+                    };
+
+                return true;
+            }
+
+        private:
+            std::shared_ptr<const Theory<TTheory>> theory;
+            TheoryStream<TTuple> stream;
+            int instance;
+            bool done;
+        };
+
+    public:
+        Source(std::shared_ptr<const Theory<TTheory>> theory, TProvider provider)
+            : theory(theory)
+            , provider(provider)
+        {
+        }
+
+        virtual int KnownCount() const override
+        {
+            return UnknownCount;
+        }
+
+        virtual std::unique_ptr<TheoryRows> Open() const override
+        {
+            return std::unique_ptr<TheoryRows>(new Rows(theory, provider()));
+        }
+
+    private:
+        std::shared_ptr<const Theory<TTheory>> theory;
+        mutable TProvider provider;
+    };
+
+    template<typename TTheory, typename TProvider>
+    std::shared_ptr<TheorySource> MakeSource(TTheory &&theory, TProvider &&provider, std::deque<std::string> &&params)
+    {
+        typedef typename std::decay<TTheory>::type theory_type;
+        typedef typename std::decay<TProvider>::type provider_type;
+        typedef typename std::decay<decltype(std::declval<provider_type &>()())>::type data_type;
+
+        auto shared = std::make_shared<const Theory<theory_type>>(std::forward<TTheory>(theory), std::move(params));
+        return std::make_shared<Source<theory_type, provider_type, data_type>>(shared, std::forward<TProvider>(provider));
+    }
+}
+
+}
+
+#endif
@@ -0,0 +1,291 @@
+#ifndef XUNITTHEORYFILE_H_
+#define XUNITTHEORYFILE_H_
+
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "MappedFile.h"
+#include "xUnitTheory.h"
+
+//
+// Theory data read straight from files on disk. The file is memory-mapped when the theory runs,
+// and rows are handed to the theory as views into the mapping, so a corpus of any size can drive
+// a theory without being read into memory first:
+//
+//      DATA_THEORY("Samples", (const xUnitpp::CsvRecord &sample), xUnitpp::CsvFile("samples.csv"))
+//      DATA_THEORY("Requests", (const xUnitpp::TextView &json), xUnitpp::JsonLinesFile("requests.jsonl"))
+//      DATA_THEORY("Packets", (const Packet &packet), xUnitpp::BinaryRecordFile<Packet>("packets.bin"))
+//
+
+namespace xUnitpp
+{
+
+// a run of characters which lives somewhere else, usually in a MappedFile
+class TextView
+{
+public:
+    TextView();
+    TextView(const char *data, size_t size);
+
+    const char *data() const;
+    size_t size() const;
+    bool empty() const;
+
+    const char *begin() const;
+    const char *end() const;
+
+    char operator [](size_t index) const;
+
+    std::string str() const;
+
+    friend std::string to_string(const TextView &view);
+
+    friend bool operator ==(const TextView &lhs, const TextView &rhs);
+    friend bool operator ==(const TextView &lhs, const std::string &rhs);
+    friend bool operator ==(const std::string &lhs, const TextView &rhs);
+    friend bool operator !=(const TextView &lhs, const TextView &rhs);
+    friend bool operator !=(const TextView &lhs, const std::string &rhs);
+    friend bool operator !=(const std::string &lhs, const TextView &rhs);
+
+private:
+    const char *first;
+    size_t length;
+};
+
+// One line of a CSV file. Fields are only found when they are asked for.
+class CsvRecord
+{
+public:
+    CsvRecord(TextView line, char separator);
+
+    size_t Count() const;
+
+    // the field as it appears in the file, without its surrounding quotes
+    TextView Field(size_t index) const;
+
+    // the field with any doubled quotes inside it collapsed
+    std::string Text(size_t index) const;
+
+    TextView Line() const;
+
+    friend std::string to_string(const CsvRecord &record);
+
+private:
+    TextView line;
+    char separator;
+};
+
+namespace TheoryImpl
+{
+    // finds the record starting at `begin`: returns where the next one starts, and sets `recordEnd`
+    typedef std::function<const char *(const char *begin, const char *end, const char *&recordEnd)> RecordSplitter;
+
+    const char *SplitLine(const char *begin, const char *end, const char *&recordEnd);
+    const char *SplitCsv(const char *begin, const char *end, const char *&recordEnd);
+}
+
+// Rows read from a mapped file, one row per record. Records are found by the runner as it hands
+// out chunks, which only touches the pages it needs; each worker turns its records into rows.
+template<typename TTuple>
+class MappedRecords
+{
+public:
+    typedef TTuple tuple_type;
+    typedef std::function<TTuple (const char *begin, const char *end)> Parser;
+
+    // recordSize is 0 for records of varying length, whose count isn't known without reading the whole file
+    MappedRecords(std::string path, TheoryImpl::RecordSplitter split, Parser parse, size_t recordSize, size_t skip, bool skipEmpty)
+        : path(std::move(path))
+        , split(std::move(split))
+        , parse(std::move(parse))
+        , recordSize(recordSize)
+        , skip(skip)
+        , skipEmpty(skipEmpty)
+    {
+    }
+
+    // a file is its own data provider
+    const MappedRecords &operator ()() const
+    {
+        return *this;
+    }
+
+    std::string path;
+    TheoryImpl::RecordSplitter split;
+    Parser parse;
+    size_t recordSize;
+    size_t skip;
+    bool skipEmpty;
+};
+
+// one row per line, ignoring blank lines
+inline MappedRecords<std::tuple<TextView>> JsonLinesFile(const std::string &path)
+{
+    return MappedRecords<std::tuple<TextView>>(path, &TheoryImpl::SplitLine,
+        [](const char *begin, const char *end) { return std::make_tuple(TextView(begin, end - begin)); },
+        0, 0, true);
+}
+
+// one row per record, skipping the first line when it is a header
+inline MappedRecords<std::tuple<CsvRecord>> CsvFile(const std::string &path, bool hasHeader = true, char separator = ',')
+{
+    return MappedRecords<std::tuple<CsvRecord>>(path, &TheoryImpl::SplitCsv,
+        [=](const char *begin, const char *end) { return std::make_tuple(CsvRecord(TextView(begin, end - begin), separator)); },
+        0, hasHeader ? 1 : 0, true);
+}
+
+// A file of fixed-size records, each passed to the theory in place as a TRecord.
+// The file is expected to be written by the same platform that reads it.
+template<typename TRecord>
+MappedRecords<std::tuple<const TRecord &>> BinaryRecordFile(const std::string &path)
+{
+    static_assert(std::is_pod<TRecord>::value, "BinaryRecordFile needs plain data records.");
+
+    return MappedRecords<std::tuple<const TRecord &>>(path,
+        [](const char *begin, const char *, const char *&recordEnd) { return recordEnd = begin + sizeof(TRecord); },
+        [](const char *begin, const char *) { return std::tuple<const TRecord &>(*reinterpret_cast<const TRecord *>(begin)); },
+        sizeof(TRecord), 0, false);
+}
+
+namespace TheoryImpl
+{
+    template<typename TTheory, typename TProvider, typename TTuple>
+    class Source<TTheory, TProvider, MappedRecords<TTuple>> : public TheorySource
+    {
+        typedef MappedRecords<TTuple> records_type;
+        typedef std::vector<std::pair<const char *, const char *>> chunk_type;
+
+        // the arguments of a row, and the mapping they point into
+        struct Args
+        {
+            Args(const std::shared_ptr<const MappedFile> &file, TTuple &&args)
+                : file(file)
+                , args(std::move(args))
+            {
+            }
+
+            std::shared_ptr<const MappedFile> file;
+            TTuple args;
+        };
+
+        static std::shared_ptr<const MappedFile> MapFile(const records_type &records)
+        {
+            auto file = MappedFile::Open(records.path);
+
+            if (records.recordSize != 0 && file->size() % records.recordSize != 0)
+            {
+                throw std::runtime_error(records.path + " is not a whole number of " + std::to_string(records.recordSize) + " byte records.");
+            }
+
+            return file;
+        }
+
+        class Rows : public TheoryRows
+        {
+        public:
+            Rows(std::shared_ptr<const Theory<TTheory>> theory, const records_type &records)
+                : theory(theory)
+                , records(records)
+                , file(MapFile(records))
+                , position(file->begin())
+                , instance(0)
+                , chunkLength(records.recordSize != 0 ? ChunkLength(file->size() / records.recordSize) : StreamChunkLength)
+            {
+                for (size_t i = 0; i != records.skip && position != file->end(); ++i)
+                {
+                    const char *recordEnd;
+                    position = records.split(position, file->end(), recordEnd);
+                }
+            }
+
+            virtual bool NextChunk(TheoryChunk &chunk) override
+            {
+                auto found = std::make_shared<chunk_type>();
+                found->reserve(chunkLength);
+
+                while (found->size() != chunkLength && position != file->end())
+                {
+                    const char *recordEnd;
+                    auto recordBegin = position;
+                    position = records.split(position, file->end(), recordEnd);
+
+                    if (!records.skipEmpty || recordEnd != recordBegin)
+                    {
+                        found->push_back(std::make_pair(recordBegin, recordEnd));
+                    }
+                }
+
+                if (found->empty())
+                {
+                    return false;
+                }
+
+                int firstInstance = instance;
+                instance += (int)found->size();
+
+                auto theory = this->theory;
+                auto file = this->file;
+                auto parse = records.parse;
+
+                chunk = [=](const std::function<void (std::shared_ptr<const TheoryRow> &&)> &run)
+                    {
+                        for (size_t i = 0; i != found->size(); ++i)
+                        {
+                            // records are parsed by the worker running them, one at a time
+                            auto args = std::make_shared<Args>(file, parse((*found)[i].first, (*found)[i].second));
+                            run(MakeRow(theory, firstInstance + (int)i, std::shared_ptr<TTuple>(args, &args->args)));
+                        }
+                    };
+
+                return true;
+            }
+
+        private:
+            std::shared_ptr<const Theory<TTheory>> theory;
+            records_type records;
+            std::shared_ptr<const MappedFile> file;
+            const char *position;
+            int instance;
+            size_t chunkLength;
+        };
+
+    public:
+        Source(std::shared_ptr<const Theory<TTheory>> theory, TProvider provider)
+            : theory(theory)
+            , provider(provider)
+        {
+        }
+
+        // the file is only looked at, not opened: it need not be there until the theory runs
+        virtual int KnownCount() const override
+        {
+            const records_type &records = provider();
+            unsigned long long size = 0;
+
+            if (records.recordSize == 0 || !MappedFile::Size(records.path, size) || size % records.recordSize != 0)
+            {
+                return UnknownCount;
+            }
+
+            return (int)(size / records.recordSize - records.skip);
+        }
+
+        virtual std::unique_ptr<TheoryRows> Open() const override
+        {
+            return std::unique_ptr<TheoryRows>(new Rows(theory, provider()));
+        }
+
+    private:
+        std::shared_ptr<const Theory<TTheory>> theory;
+        mutable TProvider provider;
+    };
+}
+
+}
+
+#endif
@@ -5,6 +5,7 @@
 // http://stackoverflow.com/questions/1386183/how-to-call-a-templated-function-if-it-exists-and-something-else-otherwise
 // modified to fix Visual Studio warning C4913
 
+#include <sstream>
 #include <string>
 
 namespace xUnitpp